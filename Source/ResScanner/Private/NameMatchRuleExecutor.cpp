@@ -20,6 +20,12 @@ FORCEINLINE EScanRuleType UNameMatchRuleExecutor::GetRuleType() const
 	return EScanRuleType::NameMatch;
 }
 
+bool UNameMatchRuleExecutor::CanMatchOffGameThread() const
+{
+	// 如果是蓝图子类，Match 可能被蓝图覆盖，蓝图只能在 GameThread 中执行
+	return GetClass()->HasAnyClassFlags(CLASS_Native);
+}
+
 /**
  * 根据规则评估资产评是否匹配
  * @param InAssetName 资产名
@@ -75,3 +75,19 @@ FString UPropertyMatchRuleExecutor::GetErrorReason_Implementation() const
 {
 	return FString::Printf(TEXT("属性不匹配值"));
 }
+
+void UPropertyMatchRuleExecutor::GetScopeClasses(TArray<FTopLevelAssetPath>& OutClassPaths) const
+{
+	Super::GetScopeClasses(OutClassPaths);
+	// 用户手动指定了作用类型就以用户的为准
+	// 开启了反向检测时，不是 TargetClass 的资源也会被报告，不能按 TargetClass 过滤
+	if (OutClassPaths.Num() > 0 || bReverseCheck)
+	{
+		return;
+	}
+	// EvaluatePropertyMatch 中资源必须是每一条属性规则的 TargetClass，取第一条即可
+	if (RuleData.PropertyRules.Num() > 0 && !RuleData.PropertyRules[0].TargetClass.IsNull())
+	{
+		OutClassPaths.Add(RuleData.PropertyRules[0].TargetClass.ToSoftObjectPath().GetAssetPath());
+	}
+}
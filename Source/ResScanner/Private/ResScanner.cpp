@@ -10,6 +10,13 @@
 #include "Widgets/Docking/SDockTab.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/SExpanderArrow.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Input/SEditableTextBox.h"
+#include "Widgets/Images/SImage.h"
+#include "Widgets/Layout/SScrollBox.h"
+#include "Styling/AppStyle.h"
+#include "ContentBrowserModule.h"
 #include "ToolMenus.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "IDetailsView.h"
@@ -17,18 +24,40 @@
 #include "PropertyEditorModule.h"
 #include "PropertyMatchEditor.h"
 #include "PropertyMatchRuleExecutor.h"
+#include "TagMatchRuleExecutor.h"
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonSerializer.h"
+#include "Editor.h"
+#include "FileHelpers.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+#include "UObject/ObjectSaveContext.h"
+#include "ResScannerSettings.h"
+#include "ResScannerCheckpoint.h"
+#include "ResScannerPlanner.h"
+#include "ResScannerRulePreview.h"
+#include "ResScannerCookValidator.h"
+#include "ResScannerSaveGate.h"
+#include "ResScannerHistory.h"
+#include "ResScannerRuleQuery.h"
+#include "Misc/MessageDialog.h"
 
 
 // 定义插件的标签名称
 static const FName ResScannerTabName("ResScanner");
 
+// 扫描的根目录，用 "/Game" 就能获取到项目中的资源而排除引擎资源了
+static const FName ScanRootPath(TEXT("/Game"));
+
+// 分帧扫描时每帧最多占用的时间（秒），保证扫描过程中编辑器仍然可以操作
+static constexpr double ScanTickBudgetSeconds = 0.03;
+// 扫描过程中按最新统计数据重新生成执行计划的间隔（秒）
+static constexpr double ReplanIntervalSeconds = 2.0;
+
 // 本地化命名空间定义，后续使用 LOCTEXT 宏时可用
 #define LOCTEXT_NAMESPACE "FResScannerModule"
 
-DEFINE_LOG_CATEGORY(LogResScanner)
-
 void FResScannerModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
@@ -36,6 +65,22 @@ void FResScannerModule::StartupModule()
 	// 手动初始化共享指针系统
 	//SharedThis = TSharedPtr<FResScannerModule>(this);
 
+	// 初始化规则集
+	// 模块不是 UObject，不能用 UPROPERTY 引用规则集，需要 AddToRoot 防止被 GC 回收
+	RuleSet = NewObject<UResScannerRuleSet>();
+	RuleSet->AddToRoot();
+
+	// 读取规则的历史统计数据，用于生成执行计划
+	ScanEngine.RuleScheduler.LoadStats();
+
+	// 命令行（如 CI 中运行 UResScannerCommandlet）没有界面，不需要注册样式、命令、菜单和窗口
+	if (IsRunningCommandlet())
+	{
+		// Cook 时评估已经加载的资源包
+		CookValidator = FResScannerCookValidator::CreateFromCommandLine();
+		return;
+	}
+
 	// 初始化插件样式（例如按钮图标，Slate 样式等）
 	FResScannerStyle::Initialize();
 	FResScannerStyle::ReloadTextures();
@@ -61,8 +106,24 @@ void FResScannerModule::StartupModule()
 		.SetDisplayName(LOCTEXT("FResScannerTabTitle", "ResScanner"))		// Tab 显示标题
 		.SetMenuType(ETabSpawnerMenuType::Hidden);		// 不在菜单中显示，手动调用打开
 
-	// 初始化规则集
-	RuleSet = NewObject<UResScannerRuleSet>();
+	// 记录本次会话中保存过的资源，扫描时优先评估
+	PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddRaw(this, &FResScannerModule::OnPackageSaved);
+
+	// 在内容浏览器的资源格子上显示违规标记，提示中列出违反的规则
+	FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+	AssetViewExtraStateHandle = ContentBrowserModule.AddAssetViewExtraStateGenerator(FAssetViewExtraStateGenerator(
+		FOnGenerateAssetViewExtraStateIndicators::CreateRaw(this, &FResScannerModule::OnGenerateAssetViolationBadge),
+		FOnGenerateAssetViewExtraStateIndicators::CreateRaw(this, &FResScannerModule::OnGenerateAssetViolationToolTip)));
+
+	// 保存资源时用当前的规则集检查，需要在设置中开启
+	if (GetDefault<UResScannerSettings>()->bValidateOnSave)
+	{
+		SaveGate = MakeUnique<FResScannerSaveGate>([this](TArray<UResScannerRuleSet*>& OutRuleSets)
+		{
+			OutRuleSets.Add(RuleSet);
+			OutRuleSets.Append(AdditionalRuleSets);
+		});
+	}
 }
 
 // 插件模块关闭函数
@@ -71,22 +132,53 @@ void FResScannerModule::ShutdownModule()
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
 
-	// 取消菜单注册回调（防止插件卸载后仍被调用）
-	UToolMenus::UnRegisterStartupCallback(this);
+	// 停止还没有结束的扫描
+	StopAssetScan();
+	UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+	CookValidator.Reset();
+	SaveGate.Reset();
+	ScanHistory.Reset();
+
+	// 命令行中没有注册界面相关的内容
+	if (!IsRunningCommandlet())
+	{
+		// 取消菜单注册回调（防止插件卸载后仍被调用）
+		UToolMenus::UnRegisterStartupCallback(this);
+
+		// 取消该插件作为菜单项所有者（清理菜单）
+		UToolMenus::UnregisterOwner(this);
 
-	// 取消该插件作为菜单项所有者（清理菜单）
-	UToolMenus::UnregisterOwner(this);
+		// 清理样式资源
+		FResScannerStyle::Shutdown();
 
-	// 清理样式资源
-	FResScannerStyle::Shutdown();
+		// 取消命令注册
+		FResScannerCommands::Unregister();
 
-	// 取消命令注册
-	FResScannerCommands::Unregister();
+		// 取消插件窗口的 Tab 注册
+		FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(ResScannerTabName);
 
-	// 取消插件窗口的 Tab 注册
-	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(ResScannerTabName);
+		if (FContentBrowserModule* ContentBrowserModule = FModuleManager::GetModulePtr<FContentBrowserModule>("ContentBrowser"))
+		{
+			ContentBrowserModule->RemoveAssetViewExtraStateGenerator(AssetViewExtraStateHandle);
+		}
+	}
 
 	RuleItems.Empty();
+	RuleSetItems.Empty();
+	ScanEngine.CompiledRules = FResScannerCompiledRules();
+	// 引擎退出时 UObject 系统可能已经销毁
+	if (UObjectInitialized())
+	{
+		for (UResScannerRuleSet* AdditionalRuleSet : AdditionalRuleSets)
+		{
+			AdditionalRuleSet->RemoveFromRoot();
+		}
+		if (RuleSet)
+		{
+			RuleSet->RemoveFromRoot();
+		}
+	}
+	AdditionalRuleSets.Empty();
 	RuleSet = nullptr;
 }
 
@@ -94,7 +186,13 @@ void FResScannerModule::ShutdownModule()
 TSharedRef<SDockTab> FResScannerModule::OnSpawnPluginTab(const FSpawnTabArgs& SpawnTabArgs)
 {
 	// 插件窗口内显示的文字内容
-	ScanResults.Empty();
+	ScanEngine.ResetResults();
+	ResultSearch.Reset();
+	ResultTree.SetAssetFilter([this](int32 AssetId)
+	{
+		return ResultSearch.Matches(AssetId) && (RuleQueryExpression.IsEmpty() || RuleQueryAssets.Contains(AssetId));
+	});
+	ResultTree.Reset();
 
 	// 创建插件窗口 Tab，并填充一个简单的文本控件
 	return SNew(SDockTab)
@@ -157,6 +255,35 @@ TSharedRef<SWidget> FResScannerModule::CreateRuleConfigPanel()
 					})
 				]
 			]
+			+ SHorizontalBox::Slot()		// 规则集的组合逻辑
+			.AutoWidth()
+			.Padding(2)
+			[
+				SNew(SComboBox<TSharedPtr<FString>>)
+				.OptionsSource(&CompositeLogicOptions)
+				.OnGenerateWidget_Lambda([](TSharedPtr<FString> InItem)
+				{
+					return SNew(STextBlock).Text(FText::FromString(*InItem));
+				})
+				.OnSelectionChanged_Lambda([this](TSharedPtr<FString> NewSelection, ESelectInfo::Type)
+				{
+					if (NewSelection.IsValid() && RuleSet)
+					{
+						const int64 LogicValue = StaticEnum<ERuleSetLogic>()->GetValueByNameString(*NewSelection);
+						if (LogicValue != INDEX_NONE)
+						{
+							RuleSet->CompositeLogic = static_cast<ERuleSetLogic>(LogicValue);
+						}
+					}
+				})
+				[
+					SNew(STextBlock)
+					.Text_Lambda([this]()
+					{
+						return RuleSet ? StaticEnum<ERuleSetLogic>()->GetDisplayNameTextByValue(static_cast<int64>(RuleSet->CompositeLogic)) : FText::GetEmpty();
+					})
+				]
+			]
 			+ SHorizontalBox::Slot()
 			.FillWidth(1.0f)
 			[
@@ -173,6 +300,59 @@ TSharedRef<SWidget> FResScannerModule::CreateRuleConfigPanel()
 					.DefaultLabel(LOCTEXT("RuleName", "规则名称"))
 				)
 			]
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.MaxHeight(150.0f)
+		.Padding(5)
+		[
+			// 追加的规则集列表，和当前编辑的规则集一起参与扫描
+			SAssignNew(RuleSetListView, SListView<TWeakObjectPtr<UResScannerRuleSet>>)
+			.ListItemsSource(&RuleSetItems)
+			.OnGenerateRow_Lambda([this](TWeakObjectPtr<UResScannerRuleSet> InItem, const TSharedRef<STableViewBase>& OwnerTable)
+			{
+				return OnGenerateRuleSetRow(InItem.Get(), OwnerTable);
+			})
+			.HeaderRow
+			(
+				SNew(SHeaderRow)
+				+ SHeaderRow::Column("RuleSetName")
+				.DefaultLabel(LOCTEXT("AdditionalRuleSets", "追加的规则集"))
+			)
+		];
+}
+
+// 生成追加规则集的行
+TSharedRef<ITableRow> FResScannerModule::OnGenerateRuleSetRow(UResScannerRuleSet* InItem,
+	const TSharedRef<STableViewBase>& OwnerTable)
+{
+	if (!InItem) return SNew(STableRow<TWeakObjectPtr<UResScannerRuleSet>>, OwnerTable);
+	return SNew(STableRow<TWeakObjectPtr<UResScannerRuleSet>>, OwnerTable)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				SNew(STextBlock)
+				.Text(FText::Format(LOCTEXT("RuleSetRowFormat", "{0}（{1} 条规则）"),
+					FText::FromString(InItem->RuleSetName), FText::AsNumber(InItem->Rules.Num())))
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("RemoveRuleSet", "移除"))
+				.OnClicked_Lambda([this, InItem]()
+				{
+					// 正在进行的扫描还在使用编译好的规则，移除前先停止
+					StopAssetScan();
+					AdditionalRuleSets.Remove(InItem);
+					RuleSetItems.Remove(InItem);
+					InItem->RemoveFromRoot();
+					if (RuleSetListView.IsValid()) RuleSetListView->RequestListRefresh();
+					return FReply::Handled();
+				})
+			]
 		];
 }
 
@@ -191,6 +371,10 @@ void FResScannerModule::OnRuleSelectionChanged(TSharedPtr<FString> NewSelection)
 		{
 			NewRule = NewObject<UPropertyMatchRuleExecutor>(RuleSet);
 		}
+		else if (NewSelection->Equals(TEXT("TagMatch")))
+		{
+			NewRule = NewObject<UTagMatchRuleExecutor>(RuleSet);
+		}
 		
 		// TODO: PathMatch, PropertyMatch
 		if (NewRule)
@@ -242,6 +426,47 @@ TSharedRef<SWidget> FResScannerModule::CreateScanResultsPanel()
 			+ SHorizontalBox::Slot()
 			.AutoWidth()
 			.Padding(2)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("ExplainScanButton", "预估"))
+				.ToolTipText(LOCTEXT("ExplainScanButtonTip", "不评估任何规则，根据资源注册表和历史统计数据预估扫描的资源数量、加载量和耗时"))
+				.OnClicked_Lambda([this]()
+				{
+					return OnExplainScanClicked();
+				})
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(2)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("SampleScanButton", "抽样估计"))
+				.ToolTipText(LOCTEXT("SampleScanButtonTip", "每个目录的每种资源只随机评估一部分，快速估计每条规则的违规数量"))
+				.OnClicked_Lambda([this]()
+				{
+					RunAssetScan(EResScanMode::Sampled);
+					return FReply::Handled();
+				})
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(2)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("StopScanButton", "停止扫描"))
+				.IsEnabled_Lambda([this]()
+				{
+					return bScanInProgress;
+				})
+				.OnClicked_Lambda([this]()
+				{
+					StopAssetScan();
+					return FReply::Handled();
+				})
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(2)
 			[
 				SNew(SButton)
 				.Text(LOCTEXT("ImportConfig", "导入配置"))
@@ -261,66 +486,306 @@ TSharedRef<SWidget> FResScannerModule::CreateScanResultsPanel()
 					return OnExportConfigClicked();
 				})
 			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(2)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("AppendRuleSet", "追加规则集"))
+				.ToolTipText(LOCTEXT("AppendRuleSetTip", "加载其它团队导出的规则集，和当前规则集在一次扫描中一起评估"))
+				.OnClicked_Lambda([this]()
+				{
+					return OnAppendRuleSetClicked();
+				})
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(2)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("ExportResults", "导出结果"))
+				.ToolTipText(LOCTEXT("ExportResultsTip", "把扫描结果导出为 NDJSON、CSV、SARIF（代码评审注释）或者 JUnit XML"))
+				.IsEnabled_Lambda([this]() { return !bScanInProgress && ScanEngine.Results.Num() > 0; })
+				.OnClicked_Lambda([this]()
+				{
+					return OnExportResultsClicked();
+				})
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(2)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("RecordBaseline", "记录基线"))
+				.ToolTipText(LOCTEXT("RecordBaselineTip", "把当前的违规记录到项目设置中的基线文件，之后的扫描只显示新的违规\n需要一次完整的扫描（不是抽样、没有从检查点继续、没有中断）"))
+				.IsEnabled_Lambda([this]()
+				{
+					return !bScanInProgress && bScanResultsFinal && !bScanBudgetExhausted && !bResumedFromCheckpoint && ScanMode == EResScanMode::Full
+						&& !GetDefault<UResScannerSettings>()->BaselineFile.IsEmpty();
+				})
+				.OnClicked_Lambda([this]()
+				{
+					return OnRecordBaselineClicked();
+				})
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(2)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("ShowTrend", "历史趋势"))
+				.ToolTipText(LOCTEXT("ShowTrendTip", "不重新扫描，从扫描历史中查询最近几次完整扫描每条规则、每个目录的违规数量"))
+				.OnClicked_Lambda([this]()
+				{
+					return OnShowTrendClicked();
+				})
+			]
+			+ SHorizontalBox::Slot()		// 结果的分组方式
+			.AutoWidth()
+			.Padding(2)
+			[
+				SNew(SComboBox<TSharedPtr<FString>>)
+				.OptionsSource(&ResultGroupingOptions)
+				.OnGenerateWidget_Lambda([](TSharedPtr<FString> InItem)
+				{
+					return SNew(STextBlock).Text(FText::FromString(*InItem));
+				})
+				.OnSelectionChanged_Lambda([this](TSharedPtr<FString> NewSelection, ESelectInfo::Type)
+				{
+					const int32 GroupingIndex = ResultGroupingOptions.Find(NewSelection);
+					if (GroupingIndex != INDEX_NONE)
+					{
+						// 分组方式变化后所有节点重新生成
+						ResultTree.SetGrouping(static_cast<EResScannerResultGrouping>(GroupingIndex));
+						RefreshResultTree();
+					}
+				})
+				[
+					SNew(STextBlock)
+					.Text_Lambda([this]()
+					{
+						return FText::FromString(*ResultGroupingOptions[static_cast<int32>(ResultTree.GetGrouping())]);
+					})
+				]
+			]
 		]
 		+ SVerticalBox::Slot()
-		.FillHeight(1.0f)
+		.AutoHeight()
 		.Padding(5)
 		[
-			SAssignNew(ScanResultsListView, SListView<TSharedPtr<FScanResultItem>>)
-			.ListItemsSource(&ScanResults)			// 注意这里给进来的是一个指针
-			.OnGenerateRow_Lambda([this](TSharedPtr<FScanResultItem> InItem, const TSharedRef<STableViewBase>& OwnerTable)
+			// 显示调度器选择的执行计划
+			SNew(STextBlock)
+			.AutoWrapText(true)
+			.Text_Lambda([this]()
 			{
-				return OnGenerateResultRow(InItem, OwnerTable);				// 显示结果列表
+				return FText::FromString(ScanEngine.RuleScheduler.DescribePlan());
 			})
-			.HeaderRow(
-				SNew(SHeaderRow)
-				+ SHeaderRow::Column("AssetName")
-				.DefaultLabel(LOCTEXT("AssetName", "资源名称"))
-				.FillWidth(0.6f)
-				+ SHeaderRow::Column("AssetPath")
-				.DefaultLabel(LOCTEXT("AssetPath", "资源路径"))
-				.FillWidth(0.2f)
-				+ SHeaderRow::Column("ErrorReason")
-				.DefaultLabel(LOCTEXT("ErrorReason", "错误原因"))
-				.FillWidth(0.2f)
-			)
-		];
-}
-
-// 生成规则行
-TSharedRef<ITableRow> FResScannerModule::OnGenerateRuleRow(UResScannerRuleBase* InItem,
-	const TSharedRef<STableViewBase>& OwnerTable)
-{
-	if (!InItem) return SNew(STableRow<TSharedPtr<UResScannerRuleBase>>, OwnerTable);
-	return SNew(STableRow<TSharedPtr<UResScannerRuleBase>>, OwnerTable)
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			// 扫描状态，渐进式扫描时提示结果未完成
+			SNew(STextBlock)
+			.Text_Lambda([this]()
+			{
+				return GetScanStatusText();
+			})
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			// 扫描预估结果
+			SNew(STextBlock)
+			.AutoWrapText(true)
+			.Visibility_Lambda([this]()
+			{
+				return ScanExplainText.IsEmpty() ? EVisibility::Collapsed : EVisibility::Visible;
+			})
+			.Text_Lambda([this]()
+			{
+				return FText::FromString(ScanExplainText);
+			})
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			// 历史趋势
+			SNew(STextBlock)
+			.AutoWrapText(true)
+			.Visibility_Lambda([this]()
+			{
+				return HistoryTrendText.IsEmpty() ? EVisibility::Collapsed : EVisibility::Visible;
+			})
+			.Text_Lambda([this]()
+			{
+				return FText::FromString(HistoryTrendText);
+			})
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			// 抽样扫描的估计结果
+			SNew(STextBlock)
+			.AutoWrapText(true)
+			.Visibility_Lambda([this]()
+			{
+				return SampleEstimateText.IsEmpty() ? EVisibility::Collapsed : EVisibility::Visible;
+			})
+			.Text_Lambda([this]()
+			{
+				return FText::FromString(SampleEstimateText);
+			})
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot()
 			.FillWidth(1.0f)
 			[
-				SNew(STextBlock)
-				.Text(FText::FromString(InItem->GetClass()->GetName()))		// 显示规则类型
+				// 按资源路径、规则名和错误原因搜索，~ 开头的词为模糊匹配
+				SNew(SSearchBox)
+				.HintText(LOCTEXT("ResultSearchHint", "搜索资源路径、规则、错误原因（~ 开头模糊匹配）"))
+				.OnTextChanged_Raw(this, &FResScannerModule::OnResultSearchTextChanged)
 			]
-			
 			+ SHorizontalBox::Slot()
 			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(5, 0)
 			[
-				SNew(SButton)
-				.Text(LOCTEXT("EditRule", "编辑"))
-				.OnClicked_Lambda([this, InItem]()
+				SNew(STextBlock)
+				.Visibility_Lambda([this]()
 				{
-					return OnEditRuleClicked(InItem);
+					return ResultSearch.HasQuery() ? EVisibility::Visible : EVisibility::Collapsed;
+				})
+				.Text_Lambda([this]()
+				{
+					return FText::Format(LOCTEXT("ResultSearchMatched", "{0} 个资源匹配（{1} ms）"),
+						FText::AsNumber(ResultSearch.GetMatchedAssetNum()), FText::AsNumber(ResultSearch.GetLastQuerySeconds() * 1000.0));
 				})
 			]
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				// 跨规则的集合查询，回车后在每条规则的违规位图上求值
+				SNew(SEditableTextBox)
+				.HintText(LOCTEXT("RuleQueryHint", "规则集合查询，如 #0 - #2、Art#1 & !Art#3、\"尺寸\" | TechArt、rules>=3（回车执行）"))
+				.OnTextCommitted_Raw(this, &FResScannerModule::OnRuleQueryCommitted)
+			]
 			+ SHorizontalBox::Slot()
 			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(5, 0)
 			[
-				SNew(SButton)
-				.Text(LOCTEXT("RemoveRule", "删除"))
-				.OnClicked_Lambda([this, InItem]()
+				SNew(STextBlock)
+				.Visibility_Lambda([this]()
 				{
-					RuleSet->Rules.Remove(InItem);
-					RuleItems.Remove(InItem);
+					return RuleQueryStatusText.IsEmpty() ? EVisibility::Collapsed : EVisibility::Visible;
+				})
+				.Text_Lambda([this]()
+				{
+					return FText::FromString(RuleQueryStatusText);
+				})
+			]
+		]
+		+ SVerticalBox::Slot()
+		.FillHeight(1.0f)
+		.Padding(5)
+		[
+			// 几百万条结果时平铺的列表无法使用，按规则、目录或者类型分组，分组展开时才生成资源行
+			SAssignNew(ResultTreeView, STreeView<TSharedPtr<FResScannerResultTreeNode>>)
+			.TreeItemsSource(&ResultTree.GetRootNodes())			// 注意这里给进来的是一个指针
+			.OnGenerateRow_Lambda([this](TSharedPtr<FResScannerResultTreeNode> InItem, const TSharedRef<STableViewBase>& OwnerTable)
+			{
+				return OnGenerateResultRow(InItem, OwnerTable);				// 显示结果树
+			})
+			.OnGetChildren_Raw(this, &FResScannerModule::OnGetResultChildren)
+			.OnMouseButtonDoubleClick_Lambda([this](TSharedPtr<FResScannerResultTreeNode> InItem)
+			{
+				if (InItem->IsGroup())
+				{
+					ResultTreeView->SetItemExpansion(InItem, !ResultTreeView->IsItemExpanded(InItem));
+					return;
+				}
+				// 双击跳转到资源
+				FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+				FAssetData AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(ScanEngine.Results.GetAssetObjectPath(InItem->AssetId));
+				if (AssetData.IsValid())
+				{
+					GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(AssetData.GetAsset());
+				}
+			})
+			.HeaderRow(
+				SNew(SHeaderRow)
+				+ SHeaderRow::Column("Name")
+				.DefaultLabel(LOCTEXT("ResultName", "分组 / 资源路径"))
+				.FillWidth(0.5f)
+				.SortMode_Lambda([this]() { return GetResultSortMode("Name"); })
+				.OnSort_Raw(this, &FResScannerModule::OnResultSortModeChanged)
+				+ SHeaderRow::Column("ViolationNum")
+				.DefaultLabel(LOCTEXT("ViolationNum", "违规数"))
+				.FillWidth(0.1f)
+				.SortMode_Lambda([this]() { return GetResultSortMode("ViolationNum"); })
+				.OnSort_Raw(this, &FResScannerModule::OnResultSortModeChanged)
+				+ SHeaderRow::Column("AssetNum")
+				.DefaultLabel(LOCTEXT("AssetNum", "资源数"))
+				.FillWidth(0.1f)
+				.SortMode_Lambda([this]() { return GetResultSortMode("AssetNum"); })
+				.OnSort_Raw(this, &FResScannerModule::OnResultSortModeChanged)
+				+ SHeaderRow::Column("ErrorReason")
+				.DefaultLabel(LOCTEXT("ErrorReason", "错误原因"))
+				.FillWidth(0.3f)
+			)
+		];
+}
+
+// 生成规则行
+TSharedRef<ITableRow> FResScannerModule::OnGenerateRuleRow(UResScannerRuleBase* InItem,
+	const TSharedRef<STableViewBase>& OwnerTable)
+{
+	if (!InItem) return SNew(STableRow<TSharedPtr<UResScannerRuleBase>>, OwnerTable);
+	return SNew(STableRow<TSharedPtr<UResScannerRuleBase>>, OwnerTable)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(InItem->GetClass()->GetName()))		// 显示规则类型
+			]
+			
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("EditRule", "编辑"))
+				.OnClicked_Lambda([this, InItem]()
+				{
+					return OnEditRuleClicked(InItem);
+				})
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("RemoveRule", "删除"))
+				.OnClicked_Lambda([this, InItem]()
+				{
+					// 正在进行的扫描还在使用编译好的规则，删除前先停止
+					StopAssetScan();
+					RuleSet->Rules.Remove(InItem);
+					RuleItems.Remove(InItem);
 					if (RuleListView.IsValid()) RuleListView->RequestListRefresh();
 					return FReply::Handled();
 				})
@@ -361,53 +826,24 @@ FReply FResScannerModule::OnImportConfigClicked()
 		}
 		
 		FString JsonString;
-		// 将 Json 字符串反序列化为规则集
 		// 从文件中读取 json 字符串
 		if (!FFileHelper::LoadFileToString(JsonString, *OutFiles[0]))
 		{
 			UE_LOG(LogTemp, Error, TEXT("[OnImportConfigClicked] 文件读取失败"));
 			return FReply::Handled();
 		}
-		
-		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
-		// 将 json 字符串反序列化为 json 对象
-		if (!FJsonSerializer::Deserialize(Reader, JsonObject))
+
+		// 将 Json 字符串反序列化为规则集，正在进行的扫描还在使用旧的规则，先停止
+		StopAssetScan();
+		if (!DeserializeRuleSetFromJson(JsonString, RuleSet))
 		{
-			UE_LOG(LogTemp, Error, TEXT("[OnImportConfigClicked] 文件反序列化失败"));
 			return FReply::Handled();
 		}
-	
-		RuleSet->Rules.Empty();
+
 		RuleItems.Empty();
-		const TArray<TSharedPtr<FJsonValue>>* RulesArray;
-		// 根据 "Rules" 字段获取 json 对象中的规则数组
-		if (!JsonObject->TryGetArrayField(TEXT("Rules"), RulesArray))
-		{
-			UE_LOG(LogTemp, Error, TEXT("[OnImportConfigClicked] 规则数组获取失败"));
-			return FReply::Handled();
-		}
-		
-		for (const TSharedPtr<FJsonValue>& RuleValue : *RulesArray)
+		for (UResScannerRuleBase* Rule : RuleSet->Rules)
 		{
-			// TODO: 注意这里展示了 TSharedPtr 怎么转换为 TSharedRef!!!
-			const TSharedRef<FJsonObject>& RuleJsonObject = RuleValue->AsObject().ToSharedRef();
-			FString RuleType;
-			if (RuleJsonObject->TryGetStringField(TEXT("Type"), RuleType))
-			{
-				UE_LOG(LogTemp, Log, TEXT("[OnImportConfigClicked] RuleType: %s"), *RuleType)
-				// TODO: 这里只能写死字符串吗
-				if (RuleType.Equals(TEXT("NameMatch")))
-				{
-					// RuleSet 作为这个 Object 的拥有者
-					UNameMatchRuleExecutor* NewRule = NewObject<UNameMatchRuleExecutor>(
-						RuleSet, UNameMatchRuleExecutor::StaticClass(), TEXT("NewNameRule"));
-					// JsonObject, StructDefinition, OutStruct, Flag
-					FJsonObjectConverter::JsonObjectToUStruct(RuleJsonObject, FNameMatchRule::StaticStruct(), &NewRule->RuleData, 0, 0);
-					RuleSet->Rules.Add(NewRule);
-					RuleItems.Add(NewRule);
-				}
-			}
+			RuleItems.Add(Rule);
 		}
 		if (RuleListView.IsValid())
 		{
@@ -417,6 +853,60 @@ FReply FResScannerModule::OnImportConfigClicked()
 	return FReply::Handled();
 }
 
+// 追加规则集按钮点击事件处理函数
+// 每个团队维护自己的规则集 Json，可以一次选择多个文件，扫描时和当前规则集一起在一次遍历中评估
+FReply FResScannerModule::OnAppendRuleSetClicked()
+{
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	if (!DesktopPlatform)
+	{
+		return FReply::Handled();
+	}
+
+	TArray<FString> OutFiles;
+	bool Opened = DesktopPlatform->OpenFileDialog(
+		FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr),
+		TEXT("追加规则集"),
+		FPaths::ProjectDir(),
+		TEXT(""),
+		TEXT("JSON Files|*.json"),
+		EFileDialogFlags::Multiple,
+		OutFiles
+	);
+	if (!Opened || OutFiles.Num() <= 0)
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[OnAppendRuleSetClicked] 未选择文件"));
+		return FReply::Handled();
+	}
+
+	for (const FString& FilePath : OutFiles)
+	{
+		if (UResScannerRuleSet* NewRuleSet = LoadRuleSetFromFile(FilePath))
+		{
+			AdditionalRuleSets.Add(NewRuleSet);
+			RuleSetItems.Add(NewRuleSet);
+		}
+	}
+	if (RuleSetListView.IsValid())
+	{
+		RuleSetListView->RequestListRefresh();
+	}
+	return FReply::Handled();
+}
+
+FReply FResScannerModule::OnExplainScanClicked()
+{
+	TArray<UResScannerRuleSet*> ExplainRuleSets;
+	ExplainRuleSets.Add(RuleSet);
+	ExplainRuleSets.Append(AdditionalRuleSets);
+
+	FResScannerScanExplain ScanExplain;
+	ScanExplain.Explain(ExplainRuleSets, ScanEngine.RuleScheduler, ScanRootPath);
+	ScanExplainText = ScanExplain.Describe();
+	UE_LOG(LogResScanner, Log, TEXT("[OnExplainScanClicked] %s"), *ScanExplainText);
+	return FReply::Handled();
+}
+
 // 使用 IFileDialog 或 IDesktopPlatform 打开保存文件对话框
 FReply FResScannerModule::OnExportConfigClicked()
 {
@@ -448,6 +938,86 @@ FReply FResScannerModule::OnExportConfigClicked()
 	return FReply::Handled();
 }
 
+// 按选择的扩展名导出扫描结果
+FReply FResScannerModule::OnExportResultsClicked()
+{
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	if (DesktopPlatform)
+	{
+		TArray<FString> OutFiles;
+		bool Opened = DesktopPlatform->SaveFileDialog(
+			FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr),
+			TEXT("导出结果"),
+			FPaths::ProjectSavedDir(),
+			TEXT("Results.sarif"),
+			TEXT("SARIF|*.sarif|NDJSON|*.ndjson|CSV|*.csv|JUnit XML|*.xml"),
+			EFileDialogFlags::None,
+			OutFiles
+		);
+		if (Opened && OutFiles.Num() > 0)
+		{
+			if (TUniquePtr<FResScannerResultSink> ResultSink = FResScannerResultSink::Create(OutFiles[0]))
+			{
+				FScanResultItem Result;
+				for (int32 ViolationIndex = 0; ViolationIndex < ScanEngine.Results.Num(); ++ViolationIndex)
+				{
+					ScanEngine.Results.MakeItem(ViolationIndex, Result);
+					ResultSink->WriteResult(Result);
+				}
+				ResultSink->Close();
+			}
+		}
+	}
+
+	return FReply::Handled();
+}
+
+// 当前违规 + 基线中仍然存在的违规写成新的基线，已经修复的违规从基线中去掉
+FReply FResScannerModule::OnRecordBaselineClicked()
+{
+	const FString BaselineFilePath = GetDefault<UResScannerSettings>()->GetBaselineFilePath();
+	TArray<uint64> BaselineKeys;
+	ScanEngine.Baseline.GatherAcceptedKeys(ScanEngine.Results, BaselineKeys);
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(BaselineFilePath), true);
+	if (FResScannerBaseline::Save(BaselineFilePath, MoveTemp(BaselineKeys)))
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(LOCTEXT("BaselineRecorded", "已记录基线：{0}\n请把基线文件提交到版本库。"),
+			FText::FromString(BaselineFilePath)));
+	}
+	return FReply::Handled();
+}
+
+bool FResScannerModule::OpenScanHistory()
+{
+	if (!ScanHistory.IsValid())
+	{
+		ScanHistory = MakeShared<FResScannerHistory>();
+		if (!ScanHistory->Open(FResScannerHistory::GetDefaultFilePath()))
+		{
+			ScanHistory.Reset();
+		}
+	}
+	return ScanHistory.IsValid();
+}
+
+// 最近几次完整扫描的违规趋势
+FReply FResScannerModule::OnShowTrendClicked()
+{
+	// 趋势显示的扫描次数
+	static constexpr int32 TrendScanNum = 8;
+
+	if (!OpenScanHistory())
+	{
+		return FReply::Handled();
+	}
+	HistoryTrendText = ScanHistory->DescribeTrend(TrendScanNum);
+	if (HistoryTrendText.IsEmpty())
+	{
+		HistoryTrendText = LOCTEXT("NoHistory", "还没有完整扫描的历史记录").ToString();
+	}
+	return FReply::Handled();
+}
+
 // 添加新规则
 FReply FResScannerModule::OnAddNewRule()
 {
@@ -467,7 +1037,7 @@ FReply FResScannerModule::OnEditRuleClicked(UResScannerRuleBase* InItem)
 	
 	TSharedRef<SWindow> RuleEditorWindow = SNew(SWindow)
 		.Title(LOCTEXT("RuleEditor", "规则编辑器"))
-		.ClientSize(FVector2D(600, 400))
+		.ClientSize(FVector2D(600, 560))
 		.SupportsMaximize(false)
 		.SupportsMinimize(false);
 
@@ -476,6 +1046,20 @@ FReply FResScannerModule::OnEditRuleClicked(UResScannerRuleBase* InItem)
 	// 改成 TSharedPtr<SWidget>
 	TSharedPtr<SWidget> Content;
 	TSharedPtr<SPropertyMatchEditor> PropertyMatchEditor;		// 保存 SPropertyMatchEditor 实例
+
+	// 实时预览：规则修改后在资源注册表快照上重新评估，显示违规数量和前几个违规资源，窗口关闭时随控件一起释放
+	TSharedRef<FResScannerRulePreview> RulePreview = MakeShared<FResScannerRulePreview>(ScanRootPath);
+	TSharedRef<FText> RulePreviewSamples = MakeShared<FText>();
+	RulePreview->OnResultUpdated.AddLambda([RulePreview = &RulePreview.Get(), RulePreviewSamples]()
+	{
+		TArray<FString> SampleLines;
+		for (const FSoftObjectPath& SampleAsset : RulePreview->GetResult().SampleAssets)
+		{
+			SampleLines.Add(SampleAsset.ToString());
+		}
+		*RulePreviewSamples = FText::FromString(FString::Join(SampleLines, TEXT("\n")));
+	});
+	RulePreview->RequestUpdate(InItem);
 	if (UPropertyMatchRuleExecutor* PropertyRuleExecutor = Cast<UPropertyMatchRuleExecutor>(InItem))
 	{
 		PropertyMatchEditor = SNew(SPropertyMatchEditor, PropertyRuleExecutor);
@@ -499,6 +1083,11 @@ FReply FResScannerModule::OnEditRuleClicked(UResScannerRuleBase* InItem)
 		TSharedRef<IDetailsView> DetailsView = PropertyEditorModule.CreateDetailView(DetailsViewArgs);
 		// 把传进来的 ResScannerRule 对象绑定到 DetailsView
 		DetailsView->SetObject(InItem);		// 设置要编辑的对象
+		// 属性修改后（包括拖动数值、勾选）请求预览，连续修改时由预览防抖
+		DetailsView->OnFinishedChangingProperties().AddLambda([RulePreview, WeakItem = TWeakObjectPtr<UResScannerRuleBase>(InItem)](const FPropertyChangedEvent&)
+		{
+			RulePreview->RequestUpdate(WeakItem.Get());
+		});
 		Content = DetailsView;
 	}
 	
@@ -567,6 +1156,33 @@ FReply FResScannerModule::OnEditRuleClicked(UResScannerRuleBase* InItem)
 		[
 			Content.ToSharedRef()		// TODO：需要转换为 TSharedRef
 		]
+
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			SNew(STextBlock)
+			.AutoWrapText(true)
+			.Text_Lambda([RulePreview]()
+			{
+				return RulePreview->GetStatusText();
+			})
+		]
+		+ SVerticalBox::Slot()
+		.MaxHeight(120.0f)
+		.Padding(5)
+		[
+			// 前几个违规资源
+			SNew(SScrollBox)
+			+ SScrollBox::Slot()
+			[
+				SNew(STextBlock)
+				.Text_Lambda([RulePreviewSamples]()
+				{
+					return *RulePreviewSamples;
+				})
+			]
+		]
 	);
 
 	RuleEditorWindow->SetOnWindowClosed(FOnWindowClosed::CreateLambda([this](const TSharedRef<SWindow>&)
@@ -580,127 +1196,909 @@ FReply FResScannerModule::OnEditRuleClicked(UResScannerRuleBase* InItem)
 }
 
 
-// 生成列表每一行
-TSharedRef<ITableRow> FResScannerModule::OnGenerateResultRow(TSharedPtr<FScanResultItem> InItem,
+// 生成结果树的每一行
+// 分组行显示分组名和子树的计数，资源行显示资源路径和错误原因，错误原因在行可见时才取
+TSharedRef<ITableRow> FResScannerModule::OnGenerateResultRow(TSharedPtr<FResScannerResultTreeNode> InItem,
 	const TSharedRef<STableViewBase>& OwnerTable)
 {
-	return SNew(STableRow<TSharedPtr<FScanResultItem>>, OwnerTable)
+	const FResScannerResultStore& Results = ScanEngine.Results;
+	FString Name = InItem->Label;
+	FString ErrorReason;
+	if (InItem->IsGroup())
+	{
+		if (InItem->RuleId != INDEX_NONE)
+		{
+			ErrorReason = Results.GetRuleErrorReason(InItem->RuleId);
+		}
+	}
+	else
+	{
+		Name = Results.GetAssetPath(InItem->AssetId);
+		TArray<int32> ViolationIndices;
+		Results.GetAssetViolations(InItem->AssetId, ViolationIndices);
+		TArray<FString> ErrorReasons;
+		for (const int32 ViolationIndex : ViolationIndices)
+		{
+			const int32 RuleId = Results.GetViolationRule(ViolationIndex);
+			// 按规则分组时只显示这条规则的违规
+			if (InItem->RuleId == INDEX_NONE)
+			{
+				ErrorReasons.Add(FString::Printf(TEXT("%s: %s"), *Results.GetRuleName(RuleId), *FString(Results.GetErrorReason(ViolationIndex))));
+			}
+			else if (InItem->RuleId == RuleId)
+			{
+				ErrorReasons.Add(FString(Results.GetErrorReason(ViolationIndex)));
+			}
+		}
+		ErrorReason = FString::Join(ErrorReasons, TEXT("; "));
+	}
+
+	TSharedRef<STableRow<TSharedPtr<FResScannerResultTreeNode>>> Row = SNew(STableRow<TSharedPtr<FResScannerResultTreeNode>>, OwnerTable);
+	Row->SetContent(
+		SNew(SHorizontalBox)
+		+ SHorizontalBox::Slot()
+		.FillWidth(0.5f)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot()
-			.FillWidth(0.6f)
-			[
-				SNew(STextBlock)
-				.Text(FText::FromString(InItem->AssetPath))
-				.OnDoubleClicked_Lambda([InItem](const FGeometry& Geometry, const FPointerEvent& PointerEvent)
-				{
-					// 双击跳转到资源
-					FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-					FAssetData AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(InItem->AssetPath);
-					if (AssetData.IsValid())
-					{
-						GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(AssetData.GetAsset());
-					}
-					return FReply::Handled();
-				})
-			]
-			+ SHorizontalBox::Slot()
-			.FillWidth(0.2f)
+			.AutoWidth()
 			[
-				SNew(STextBlock)
-				.Text(FText::FromString(InItem->RuleName))		// 显示规则名称
+				SNew(SExpanderArrow, Row)
 			]
 			+ SHorizontalBox::Slot()
-			.FillWidth(0.2f)
+			.FillWidth(1.0f)
 			[
 				SNew(STextBlock)
-				.Text(FText::FromString(InItem->ErrorReason))	// 显示错误原因
+				.Text(FText::FromString(Name))
+				.ToolTipText(FText::FromString(Name))
 			]
-		];
+		]
+		+ SHorizontalBox::Slot()
+		.FillWidth(0.1f)
+		[
+			SNew(STextBlock)
+			.Text(FText::AsNumber(InItem->ViolationNum))
+		]
+		+ SHorizontalBox::Slot()
+		.FillWidth(0.1f)
+		[
+			SNew(STextBlock)
+			.Text(InItem->IsGroup() ? FText::AsNumber(InItem->AssetNum) : FText::GetEmpty())
+		]
+		+ SHorizontalBox::Slot()
+		.FillWidth(0.3f)
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(ErrorReason))	// 显示错误原因
+			.ToolTipText(FText::FromString(ErrorReason))
+		]);
+	return Row;
+}
+
+void FResScannerModule::OnGetResultChildren(TSharedPtr<FResScannerResultTreeNode> InItem, TArray<TSharedPtr<FResScannerResultTreeNode>>& OutChildren)
+{
+	if (!InItem->HasChildren())
+	{
+		return;
+	}
+	// STreeView 会查询每个可见节点的子节点来决定是否显示展开箭头，没有展开的分组不生成资源节点
+	if (!ResultTreeView.IsValid() || !ResultTreeView->IsItemExpanded(InItem))
+	{
+		OutChildren = UnexpandedChildren;
+		return;
+	}
+	ResultTree.Materialize(*InItem);
+	OutChildren = InItem->Children;
+}
+
+// 列名和 EResScannerResultSortColumn 对应
+static bool GetResultSortColumn(FName ColumnId, EResScannerResultSortColumn& OutSortColumn)
+{
+	if (ColumnId == "Name") OutSortColumn = EResScannerResultSortColumn::Name;
+	else if (ColumnId == "ViolationNum") OutSortColumn = EResScannerResultSortColumn::ViolationNum;
+	else if (ColumnId == "AssetNum") OutSortColumn = EResScannerResultSortColumn::AssetNum;
+	else return false;
+	return true;
+}
+
+EColumnSortMode::Type FResScannerModule::GetResultSortMode(FName ColumnId) const
+{
+	EResScannerResultSortColumn SortColumn;
+	if (!GetResultSortColumn(ColumnId, SortColumn) || SortColumn != ResultTree.GetSortColumn())
+	{
+		return EColumnSortMode::None;
+	}
+	return ResultTree.IsSortAscending() ? EColumnSortMode::Ascending : EColumnSortMode::Descending;
+}
+
+void FResScannerModule::OnResultSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type SortMode)
+{
+	EResScannerResultSortColumn SortColumn;
+	if (GetResultSortColumn(ColumnId, SortColumn))
+	{
+		// 排序只重排已经生成的节点，没有展开的分组在展开时排序
+		ResultTree.SetSortOrder(SortColumn, SortMode == EColumnSortMode::Ascending);
+		RefreshResultTree();
+	}
 }
 
 // 开始扫描资源
-void FResScannerModule::RunAssetScan()
+// 扫描分两条通道：
+//		优先通道：最近修改、未保存、正在编辑器中打开、当前关卡引用的资源，在这里同步评估，结果马上显示
+//		普通通道：其余资源按目录流式枚举，在 TickAssetScan 中分帧评估，不阻塞编辑器
+void FResScannerModule::RunAssetScan(EResScanMode InScanMode)
 {
-	// 清空旧结果
-	ScanResults.Empty();
+	// 停止上一次还没有结束的扫描，清空旧结果
+	StopAssetScan();
+	ScanEngine.ResetResults();
+	ResultSearch.Reset();
+	RuleQueryViolationNum = INDEX_NONE;
+	ResultTree.Reset();
+	ScannedAssetNum = 0;
+	PriorityAssetNum = 0;
+	bScanResultsFinal = true;
+	ScanMode = InScanMode;
+	ScanStartTime = FPlatformTime::Seconds();
+	bScanBudgetExhausted = false;
+	const UResScannerSettings* Settings = GetDefault<UResScannerSettings>();
 
 	// 获取 AssetRegistry
 	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
 
-	TArray<FAssetData> AssetDataList;
-	// 获取注册表中的所有资源，注意这里包含了引擎中的资源
-	// AssetRegistry.GetAllAssets(AssetDataList, true);
+	// 当前编辑的规则集和追加的规则集在一次扫描中一起评估
+	TArray<UResScannerRuleSet*> ScanRuleSets;
+	ScanRuleSets.Add(RuleSet);
+	ScanRuleSets.Append(AdditionalRuleSets);
+	ScanEngine.Prepare(ScanRuleSets);
+	bResumedFromCheckpoint = false;
 
-	// FName AssetPath = TEXT("/Game/FirstPersonArms/Character/Textures/Manny");
-	// GetAssetsByPath 是获取某个路径下的资源
-	// 用 "/Game" + GetAssetsByPath 就能获取到项目中的资源而排除引擎资源了
-	FName RootPath = TEXT("/Game");
-	if (!AssetRegistry.GetAssetsByPath(RootPath, AssetDataList, true, true))
+	// 每次扫描重新读取基线，版本库中的基线可能已经更新
+	const FString BaselineFilePath = Settings->GetBaselineFilePath();
+	if (BaselineFilePath.IsEmpty() || !ScanEngine.Baseline.Load(BaselineFilePath))
 	{
-		UE_LOG(LogResScanner, Warning, TEXT("[RunAssetScan] Cannot get assets from path: %s"), *RootPath.ToString());
-		return ;
+		ScanEngine.Baseline = FResScannerBaseline();
 	}
 
-	for (const FAssetData& AssetData : AssetDataList)
+	// 完整扫描记录到扫描历史中
+	ScanEngine.History.Reset();
+	if (ScanMode == EResScanMode::Full && Settings->bRecordHistory)
 	{
-		for (UResScannerRuleBase* Rule : RuleSet->Rules)
+		if (OpenScanHistory())
 		{
-			if (!Rule) continue;
-			bool bMatch = Rule->Match(AssetData);
-			if (Rule->bReverseCheck) bMatch = !bMatch;
-
-			if (bMatch)
+			TArray<FString> RuleSetNames;
+			for (const UResScannerRuleSet* ScanRuleSet : ScanEngine.CompiledRules.RuleSets)
 			{
-				TSharedPtr<FScanResultItem> Result = MakeShared<FScanResultItem>();
-				// Result->AssetPath = AssetData.ObjectPath.ToString();
-				Result->AssetPath = AssetData.GetObjectPathString();
-				Result->RuleName = Rule->GetClass()->GetName();
-				Result->ErrorReason = Rule->GetErrorReason();
-				ScanResults.Add(Result);
+				RuleSetNames.Add(ScanRuleSet->RuleSetName);
 			}
+			ScanHistory->BeginScan(ScanRootPath.ToString(), FString::Join(RuleSetNames, TEXT("+")), TEXT("Editor"));
+			ScanEngine.History = ScanHistory;
 		}
 	}
 
-	if (ScanResultsListView.IsValid())
+	// 抽样模式只需要一个估计值，不使用优先通道、检查点，也不跟踪扫描期间新增的资源
+	const int32 SampleSeed = Settings->SampleRandomSeed != 0 ? Settings->SampleRandomSeed : static_cast<int32>(FPlatformTime::Cycles());
+	SampleEstimator.Reset(ScanMode == EResScanMode::Sampled ? ScanEngine.CompiledRules.Rules.Num() : 0, Settings->SamplesPerStratum, SampleSeed);
+	SampleEstimateText.Reset();
+
+	// 原来用 GetAssetsByPath 把 /Game 下所有 FAssetData（包括 TagsAndValues）一次性拷贝到一个 TArray 中，
+	// 大项目里这个数组有几百 MB，并且评估开始前会卡很久
+	// 现在改成按目录流式枚举：先拿到目录列表（只有 FName，占用很小），再逐个目录 EnumerateAssets，
+	// 峰值内存只和单个目录的资源数量有关，和项目大小无关
+	PendingScanPaths.Reset();
+	PendingScanPaths.Add(ScanRootPath);
+	AssetRegistry.GetSubPaths(ScanRootPath, PendingScanPaths, true);
+	NextScanPathIndex = 0;
+	ScanPathIndices.Reset();
+	for (int32 PathIndex = 0; PathIndex < PendingScanPaths.Num(); ++PathIndex)
 	{
-		ScanResultsListView->RequestListRefresh();
+		ScanPathIndices.Add(PendingScanPaths[PathIndex], PathIndex);
 	}
-}
-
-// 用户点击菜单按钮或命令时，会打开这个插件的窗口
-void FResScannerModule::PluginButtonClicked()
-{
-	// 请求打开窗口
-	FGlobalTabmanager::Get()->TryInvokeTab(ResScannerTabName);
-}
-
-// 注册插件菜单项和工具栏按钮
-void FResScannerModule::RegisterMenus()
-{
-	// 设置当前模块为菜单项的所有者，方便后续卸载清理
-	// Owner will be used for cleanup in call to UToolMenus::UnregisterOwner
-	FToolMenuOwnerScoped OwnerScoped(this);
 
-	// 在主菜单 Window -> Layout 下添加插件菜单按钮
+	// 扫描期间资源注册表还会继续发现资源（编辑器刚启动）或者有新保存的资源，
+	// 它们如果落在已经扫描过的目录或者新目录中，需要单独评估
+	bDiscoveryFinished = !AssetRegistry.IsLoadingAssets();
+	if (ScanMode == EResScanMode::Full)
 	{
-		UToolMenu* Menu = UToolMenus::Get()->ExtendMenu("LevelEditor.MainMenu.Window");
-		{
-			FToolMenuSection& Section = Menu->FindOrAddSection("WindowLayout");
-			Section.AddMenuEntryWithCommandList(FResScannerCommands::Get().OpenPluginWindow, PluginCommands);
-		}
+		AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FResScannerModule::OnScanAssetAdded);
+	}
+	if (!bDiscoveryFinished)
+	{
+		FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FResScannerModule::OnScanFilesLoaded);
 	}
 
-	// 在工具栏的 Settings 区域添加按钮
+	// 上一次同样规则的扫描没有完成时，可以从检查点继续，跳过已经扫描过的目录和优先通道
+	PriorityPackages.Reset();
+	if (ScanMode == EResScanMode::Sampled)
 	{
-		UToolMenu* ToolbarMenu = UToolMenus::Get()->ExtendMenu("LevelEditor.LevelEditorToolBar");
+		UE_LOG(LogResScanner, Log, TEXT("[RunAssetScan] Sampled scan, %d samples per stratum, seed %d"), Settings->SamplesPerStratum, SampleSeed);
+	}
+	else if (!TryResumeFromCheckpoint())
+	{
+		FResScannerCheckpoint::Delete();
+		CheckpointedResultNum = 0;
+		CheckpointedLineNum = 0;
+
+		// 优先通道
+		if (Settings->bPrioritizeRecentAssets)
 		{
-			FToolMenuSection& Section = ToolbarMenu->FindOrAddSection("Settings");
+			GatherPriorityPackages(PriorityPackages);
+			ScanPriorityPackages(PriorityPackages);
+
+			// 遍历 Content 目录查看修改时间在大项目中要几秒，放到后台，普通通道先开始
+			if (Settings->RecentlyModifiedHours > 0.0f)
 			{
-				// 初始化工具栏按钮并绑定命令
-				FToolMenuEntry& Entry = Section.AddEntry(FToolMenuEntry::InitToolBarButton(FResScannerCommands::Get().OpenPluginWindow));
-				Entry.SetCommandList(PluginCommands);
+				const FString ContentDir = FPaths::ProjectContentDir();
+				const FDateTime ModifiedAfter = FDateTime::UtcNow() - FTimespan::FromHours(Settings->RecentlyModifiedHours);
+				RecentPackagesTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [ContentDir, ModifiedAfter]()
+				{
+					return GatherRecentlyModifiedPackages(ContentDir, ModifiedAfter);
+				});
+			}
+		}
+	}
+
+	// 普通通道在 Tick 中分帧执行
+	bScanInProgress = true;
+	LastCheckpointTime = FPlatformTime::Seconds();
+	LastReplanTime = LastCheckpointTime;
+	ScanTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FResScannerModule::TickAssetScan));
+}
+
+// 收集需要优先扫描的资源包：未保存的、正在编辑的、当前关卡引用的、最近保存或修改的
+void FResScannerModule::GatherPriorityPackages(TSet<FName>& OutPackageNames)
+{
+	const UResScannerSettings* Settings = GetDefault<UResScannerSettings>();
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	// 未保存（Dirty）的资源包
+	TArray<UPackage*> DirtyPackages;
+	FEditorFileUtils::GetDirtyContentPackages(DirtyPackages);
+	for (const UPackage* Package : DirtyPackages)
+	{
+		OutPackageNames.Add(Package->GetFName());
+	}
+
+	if (GEditor)
+	{
+		// 正在资源编辑器中打开的资源
+		if (UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
+		{
+			for (const UObject* EditedAsset : AssetEditorSubsystem->GetAllEditedAssets())
+			{
+				if (EditedAsset)
+				{
+					OutPackageNames.Add(EditedAsset->GetOutermost()->GetFName());
+				}
+			}
+		}
+
+		// 当前关卡以及它直接引用的资源
+		if (const UWorld* EditorWorld = GEditor->GetEditorWorldContext().World())
+		{
+			const FName WorldPackageName = EditorWorld->GetOutermost()->GetFName();
+			OutPackageNames.Add(WorldPackageName);
+			TArray<FName> Dependencies;
+			AssetRegistry.GetDependencies(WorldPackageName, Dependencies);
+			OutPackageNames.Append(Dependencies);
+		}
+	}
+
+	// 本次编辑器会话中保存过的资源包
+	OutPackageNames.Append(SessionSavedPackages);
+}
+
+// 最近一段时间内修改过的资源文件（包括其它会话中保存的，或者从版本库同步下来的）
+TArray<FName> FResScannerModule::GatherRecentlyModifiedPackages(const FString& ContentDir, const FDateTime& ModifiedAfter)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<FName> PackageNames;
+	IFileManager::Get().IterateDirectoryStatRecursively(*ContentDir,
+		[&PackageNames, &ModifiedAfter](const TCHAR* FilenameOrDirectory, const FFileStatData& StatData)
+		{
+			if (!StatData.bIsDirectory && StatData.ModificationTime > ModifiedAfter)
+			{
+				const FString Filename(FilenameOrDirectory);
+				FString PackageName;
+				if (FPackageName::IsPackageExtension(*FPaths::GetExtension(Filename, true))
+					&& FPackageName::TryConvertFilenameToLongPackageName(Filename, PackageName))
+				{
+					PackageNames.Add(FName(*PackageName));
+				}
+			}
+			return true;
+		});
+	UE_LOG(LogResScanner, Log, TEXT("[GatherRecentlyModifiedPackages] %d recently modified packages, %.2f s"), PackageNames.Num(), FPlatformTime::Seconds() - StartTime);
+	return PackageNames;
+}
+
+void FResScannerModule::ScanRecentPackages()
+{
+	TSet<FName> RecentPackages;
+	for (const FName& PackageName : RecentPackagesTask.GetResult())
+	{
+		// 所在目录已经扫描过的资源包已经评估过了
+		const int32* PathIndex = ScanPathIndices.Find(FName(*FPackageName::GetLongPackagePath(PackageName.ToString())));
+		if (!PriorityPackages.Contains(PackageName) && (!PathIndex || *PathIndex >= NextScanPathIndex))
+		{
+			RecentPackages.Add(PackageName);
+		}
+	}
+	RecentPackagesTask = UE::Tasks::TTask<TArray<FName>>();
+	PriorityPackages.Append(RecentPackages);
+	ScanPriorityPackages(RecentPackages);
+}
+
+// 同步评估优先通道中的资源
+void FResScannerModule::ScanPriorityPackages(const TSet<FName>& PackageNames)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	AssetChunk.Reset();
+	TArray<FAssetData> PackageAssets;
+	for (const FName& PackageName : PackageNames)
+	{
+		// 只扫描根目录下的资源，关卡引用的引擎资源等不在扫描范围内
+		if (!IsUnderScanRoot(FName(*FPackageName::GetLongPackagePath(PackageName.ToString()))))
+		{
+			continue;
+		}
+		// 未保存的新资源只在内存中，这里不能只取磁盘上的资源
+		PackageAssets.Reset();
+		AssetRegistry.GetAssetsByPackageName(PackageName, PackageAssets);
+		AssetChunk.Append(PackageAssets);
+	}
+
+	ScanEngine.EvaluateAssets(AssetChunk);
+	PriorityAssetNum += AssetChunk.Num();
+	ScannedAssetNum += AssetChunk.Num();
+	AssetChunk.Reset();
+
+	UE_LOG(LogResScanner, Log, TEXT("[ScanPriorityPackages] %d priority assets, %d results"), PriorityAssetNum, ScanEngine.Results.Num());
+	RefreshResultTree();
+}
+
+// 扫描一个目录
+void FResScannerModule::ScanNextPath()
+{
+	// 子目录已经在 PendingScanPaths 中了，优先通道已经评估过的资源包直接跳过
+	const FName ScanPath = PendingScanPaths[NextScanPathIndex++];
+	FResScannerEngine::GatherPathAssets(ScanPath, &PriorityPackages, AssetChunk);
+
+	if (ScanMode == EResScanMode::Sampled)
+	{
+		EvaluateSampledChunk();
+		return;
+	}
+
+	ScanEngine.EvaluateAssets(AssetChunk);
+	ScannedAssetNum += AssetChunk.Num();
+}
+
+// 抽样评估一个目录，目录中的每种资源类型是一层
+void FResScannerModule::EvaluateSampledChunk()
+{
+	TMap<FTopLevelAssetPath, TArray<int32>> Strata;
+	for (int32 AssetIndex = 0; AssetIndex < AssetChunk.Num(); ++AssetIndex)
+	{
+		Strata.FindOrAdd(AssetChunk[AssetIndex].AssetClassPath).Add(AssetIndex);
+	}
+
+	TArray<int32> SampleIndices;
+	TArray<FAssetData> SampleAssets;
+	TArray<int32> RuleReportedNum;
+	for (const TPair<FTopLevelAssetPath, TArray<int32>>& Stratum : Strata)
+	{
+		SampleEstimator.DrawSample(Stratum.Value.Num(), SampleIndices);
+		SampleAssets.Reset();
+		for (const int32 SampleIndex : SampleIndices)
+		{
+			SampleAssets.Add(AssetChunk[Stratum.Value[SampleIndex]]);
+		}
+
+		RuleReportedNum.Reset();
+		RuleReportedNum.SetNumZeroed(ScanEngine.CompiledRules.Rules.Num());
+		ScanEngine.EvaluateAssetChunk(SampleAssets, &RuleReportedNum);
+		SampleEstimator.AddStratum(Stratum.Value.Num(), SampleAssets.Num(), RuleReportedNum);
+		ScannedAssetNum += SampleAssets.Num();
+	}
+}
+
+bool FResScannerModule::IsScanBudgetExhausted() const
+{
+	const UResScannerSettings* Settings = GetDefault<UResScannerSettings>();
+	return (Settings->MaxScanSeconds > 0.0f && FPlatformTime::Seconds() - ScanStartTime >= Settings->MaxScanSeconds)
+		|| (Settings->MaxScanAssetNum > 0 && ScannedAssetNum >= Settings->MaxScanAssetNum);
+}
+
+// 分帧扫描，每帧最多使用 ScanTickBudgetSeconds 的时间，剩下的留到下一帧
+bool FResScannerModule::TickAssetScan(float DeltaTime)
+{
+	// 超过扫描预算时停止扫描，已经得到的结果保留（完整扫描还会保存检查点，下次可以继续）
+	if (IsScanBudgetExhausted())
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[TickAssetScan] Scan budget exhausted after %.1f s, %d assets"),
+			FPlatformTime::Seconds() - ScanStartTime, ScannedAssetNum);
+		bScanBudgetExhausted = true;
+		// 返回 false 后 Ticker 会被自动移除，StopAssetScan 中不用再移除
+		ScanTickerHandle.Reset();
+		StopAssetScan();
+		return false;
+	}
+
+	const double TickStartTime = FPlatformTime::Seconds();
+	bool bResultsChanged = false;
+	while (FPlatformTime::Seconds() - TickStartTime < ScanTickBudgetSeconds && !IsScanBudgetExhausted())
+	{
+		if (RecentPackagesTask.IsValid() && RecentPackagesTask.IsCompleted())
+		{
+			ScanRecentPackages();
+		}
+		else if (NextScanPathIndex < PendingScanPaths.Num())
+		{
+			ScanNextPath();
+		}
+		else if (PendingDiscoveredHead < PendingDiscoveredAssets.Num())
+		{
+			// 扫描期间新发现的资源
+			const int32 ChunkNum = FMath::Min(FResScannerEngine::ChunkSize, PendingDiscoveredAssets.Num() - PendingDiscoveredHead);
+			ScanEngine.EvaluateAssetChunk(TArrayView<const FAssetData>(PendingDiscoveredAssets).Slice(PendingDiscoveredHead, ChunkNum));
+			PendingDiscoveredHead += ChunkNum;
+			ScannedAssetNum += ChunkNum;
+			if (PendingDiscoveredHead == PendingDiscoveredAssets.Num())
+			{
+				PendingDiscoveredAssets.Reset();
+				PendingDiscoveredHead = 0;
+			}
+			else if (PendingDiscoveredHead > PendingDiscoveredAssets.Num() / 2)
+			{
+				PendingDiscoveredAssets.RemoveAt(0, PendingDiscoveredHead, false);
+				PendingDiscoveredHead = 0;
+			}
+		}
+		else
+		{
+			break;
+		}
+		bResultsChanged = true;
+	}
+
+	if (bResultsChanged)
+	{
+		// 统计数据在扫描过程中不断更新，定期按新的统计数据重新排序（这时本帧的预算已经用完，不能每帧都做）
+		if (FPlatformTime::Seconds() - LastReplanTime >= ReplanIntervalSeconds)
+		{
+			ScanEngine.RuleScheduler.Replan();
+			LastReplanTime = FPlatformTime::Seconds();
+		}
+		SampleEstimateText = SampleEstimator.Describe(ScanEngine.CompiledRules);
+		RefreshResultTree();
+
+		const float CheckpointInterval = GetDefault<UResScannerSettings>()->CheckpointIntervalSeconds;
+		if (ScanMode == EResScanMode::Full && CheckpointInterval > 0.0f && FPlatformTime::Seconds() - LastCheckpointTime >= CheckpointInterval)
+		{
+			SaveScanCheckpoint();
+		}
+	}
+
+	// 目录都扫描完了，队列中也没有新发现的资源，最近修改的资源包也查找完了
+	if (NextScanPathIndex >= PendingScanPaths.Num() && PendingDiscoveredHead == PendingDiscoveredAssets.Num() && !RecentPackagesTask.IsValid())
+	{
+		// 编辑器刚启动时资源注册表还在后台发现资源，渐进式扫描会跟随注册表继续评估新发现的资源，
+		// 直到 OnFilesLoaded 后结果才是最终结果，而不是等注册表发现完再开始扫描
+		if (!bDiscoveryFinished && ScanMode == EResScanMode::Full && GetDefault<UResScannerSettings>()->bProgressiveScan)
+		{
+			bScanResultsFinal = false;
+			return true;
+		}
+
+		// 返回 false 后 Ticker 会被自动移除
+		ScanTickerHandle.Reset();
+		bScanResultsFinal = bDiscoveryFinished;
+		EndAssetScan();
+		return false;
+	}
+	return true;
+}
+
+// 停止扫描（用户取消，或者开始新的扫描、修改规则时）
+void FResScannerModule::StopAssetScan()
+{
+	if (!bScanInProgress)
+	{
+		return;
+	}
+	UE_LOG(LogResScanner, Warning, TEXT("[StopAssetScan] Scan stopped, %d of %d paths scanned"), NextScanPathIndex, PendingScanPaths.Num());
+	if (ScanTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(ScanTickerHandle);
+		ScanTickerHandle.Reset();
+	}
+	bScanResultsFinal = false;
+	// 取消的扫描保存检查点，下次可以继续（只剩等待资源注册表发现资源时不用保存）
+	if (ScanMode == EResScanMode::Full && GetDefault<UResScannerSettings>()->CheckpointIntervalSeconds > 0.0f
+		&& (NextScanPathIndex < PendingScanPaths.Num() || PendingDiscoveredHead < PendingDiscoveredAssets.Num()))
+	{
+		SaveScanCheckpoint();
+	}
+	EndAssetScan();
+}
+
+// 扫描结束：取消订阅，保存统计数据，刷新列表
+void FResScannerModule::EndAssetScan()
+{
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		if (AssetAddedHandle.IsValid())
+		{
+			AssetRegistryModule->Get().OnAssetAdded().Remove(AssetAddedHandle);
+		}
+		if (FilesLoadedHandle.IsValid())
+		{
+			AssetRegistryModule->Get().OnFilesLoaded().Remove(FilesLoadedHandle);
+		}
+	}
+	AssetAddedHandle.Reset();
+	FilesLoadedHandle.Reset();
+	// 扫描完成后检查点就没用了（取消的扫描在 StopAssetScan 中已经保存了检查点）
+	if (ScanMode == EResScanMode::Full && NextScanPathIndex >= PendingScanPaths.Num() && PendingDiscoveredHead == PendingDiscoveredAssets.Num())
+	{
+		FResScannerCheckpoint::Delete();
+	}
+	PendingDiscoveredAssets.Empty();
+	PendingDiscoveredHead = 0;
+	// 任务只捕获了目录和时间，不用等它结束，结果直接丢弃
+	RecentPackagesTask = UE::Tasks::TTask<TArray<FName>>();
+	PendingScanPaths.Empty();
+	ScanPathIndices.Empty();
+	PriorityPackages.Empty();
+	AssetChunk.Empty();
+	bScanInProgress = false;
+
+	UE_LOG(LogResScanner, Log, TEXT("[EndAssetScan] Scanned %d assets (%d priority), %d results on %d assets (%.1f MB)%s"), ScannedAssetNum, PriorityAssetNum, ScanEngine.Results.Num(),
+		ScanEngine.Results.GetAssetNum(), ScanEngine.Results.GetAllocatedSize() / (1024.0 * 1024.0), bScanResultsFinal ? TEXT("") : TEXT(" (incomplete)"));
+	ScanEngine.RuleScheduler.Replan();
+	UE_LOG(LogResScanner, Log, TEXT("[EndAssetScan] %s"), *ScanEngine.RuleScheduler.DescribePlan());
+	if (SampleEstimator.HasEstimates())
+	{
+		SampleEstimateText = SampleEstimator.Describe(ScanEngine.CompiledRules);
+		UE_LOG(LogResScanner, Log, TEXT("[EndAssetScan] %s"), *SampleEstimateText);
+	}
+	ScanEngine.RuleScheduler.SaveStats();
+
+	// 从检查点继续的扫描只记录了后半部分的违规，不能算作完整扫描
+	if (ScanEngine.History.IsValid())
+	{
+		ScanEngine.History->EndScan(ScannedAssetNum, bScanResultsFinal && !bScanBudgetExhausted && !bResumedFromCheckpoint);
+		ScanEngine.History.Reset();
+	}
+
+	RefreshResultTree();
+}
+
+void FResScannerModule::OnResultSearchTextChanged(const FText& InSearchText)
+{
+	// 查询只用索引求匹配的资源，结果树按新的匹配结果重新建立（只有分组节点）
+	ResultSearch.SetQuery(InSearchText.ToString());
+	ResultTree.Reset();
+	RefreshResultTree();
+}
+
+void FResScannerModule::OnRuleQueryCommitted(const FText& InQueryText, ETextCommit::Type CommitType)
+{
+	if (CommitType != ETextCommit::OnEnter && CommitType != ETextCommit::OnCleared)
+	{
+		return;
+	}
+	RuleQueryExpression = InQueryText.ToString().TrimStartAndEnd();
+	RuleQueryViolationNum = INDEX_NONE;
+	EvaluateRuleQuery();
+	ResultTree.Reset();
+	RefreshResultTree();
+}
+
+void FResScannerModule::EvaluateRuleQuery()
+{
+	if (RuleQueryExpression.IsEmpty())
+	{
+		RuleQueryAssets.Reset();
+		RuleQueryStatusText.Reset();
+		return;
+	}
+	if (RuleQueryViolationNum == ScanEngine.Results.Num())
+	{
+		return;
+	}
+	RuleQueryViolationNum = ScanEngine.Results.Num();
+
+	const double StartTime = FPlatformTime::Seconds();
+	FString QueryError;
+	if (!FResScannerRuleQuery::Evaluate(ScanEngine.Results, RuleQueryExpression, RuleQueryAssets, QueryError))
+	{
+		// 查询有错误时不过滤结果
+		RuleQueryAssets = FResScannerBitmap::Range(ScanEngine.Results.GetAssetNum());
+		RuleQueryStatusText = QueryError;
+		return;
+	}
+	RuleQueryStatusText = FText::Format(LOCTEXT("RuleQueryMatched", "{0} 个资源（{1} μs）"),
+		FText::AsNumber(RuleQueryAssets.Num()), FText::AsNumber(FMath::RoundToInt((FPlatformTime::Seconds() - StartTime) * 1000000.0))).ToString();
+}
+
+// 结果存储中的结果只会追加，结果树只需要加入新增的结果
+void FResScannerModule::RefreshResultTree()
+{
+	// 规则集合查询和搜索索引先更新，结果树加入新资源时用到匹配结果
+	// 之前被过滤掉、有了新违规后匹配的资源会补进树中，已经显示的资源在下次提交查询之前不会移除
+	EvaluateRuleQuery();
+	ResultSearch.Update();
+	ResultTree.Update();
+	if (ResultTreeView.IsValid())
+	{
+		ResultTreeView->RequestTreeRefresh();
+	}
+}
+
+// 扫描期间资源注册表新增了资源
+void FResScannerModule::OnScanAssetAdded(const FAssetData& AssetData)
+{
+	if (!IsUnderScanRoot(AssetData.PackagePath) || PriorityPackages.Contains(AssetData.PackageName))
+	{
+		return;
+	}
+	// 所在目录还没有扫描到，之后枚举这个目录时自然会评估，这里不用重复加入
+	const int32* PathIndex = ScanPathIndices.Find(AssetData.PackagePath);
+	if (PathIndex && *PathIndex >= NextScanPathIndex)
+	{
+		return;
+	}
+	PendingDiscoveredAssets.Add(AssetData);
+}
+
+// 资源注册表发现完所有资源
+void FResScannerModule::OnScanFilesLoaded()
+{
+	bDiscoveryFinished = true;
+}
+
+// 记录本次会话中保存过的资源包，用于优先扫描
+void FResScannerModule::OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext ObjectSaveContext)
+{
+	if (Package && !ObjectSaveContext.IsProceduralSave())
+	{
+		SessionSavedPackages.Add(Package->GetFName());
+	}
+}
+
+TSharedRef<SWidget> FResScannerModule::OnGenerateAssetViolationBadge(const FAssetData& AssetData)
+{
+	// 格子生成后结果还会变化（扫描中、重新扫描），每次绘制时查一次哈希表决定是否显示
+	return SNew(SImage)
+		.Image(FAppStyle::GetBrush("Icons.ErrorWithColor"))
+		.Visibility_Lambda([this, PackageName = AssetData.PackageName, AssetName = AssetData.AssetName]()
+		{
+			return ScanEngine.Results.FindAsset(PackageName, AssetName) != INDEX_NONE ? EVisibility::HitTestInvisible : EVisibility::Collapsed;
+		});
+}
+
+TSharedRef<SWidget> FResScannerModule::OnGenerateAssetViolationToolTip(const FAssetData& AssetData)
+{
+	// 提示在鼠标悬停时才生成，这时才展开违规的规则和错误原因
+	const int32 AssetId = ScanEngine.Results.FindAsset(AssetData.PackageName, AssetData.AssetName);
+	if (AssetId == INDEX_NONE)
+	{
+		return SNullWidget::NullWidget;
+	}
+
+	TArray<int32> ViolationIndices;
+	ScanEngine.Results.GetAssetViolations(AssetId, ViolationIndices);
+	FString ToolTipString = FText::Format(LOCTEXT("AssetViolationToolTip", "ResScanner：违反 {0} 条规则"), FText::AsNumber(ViolationIndices.Num())).ToString();
+	for (const int32 ViolationIndex : ViolationIndices)
+	{
+		ToolTipString += FString::Printf(TEXT("\n%s：%s"),
+			*ScanEngine.Results.GetRuleName(ScanEngine.Results.GetViolationRule(ViolationIndex)),
+			*FString(ScanEngine.Results.GetErrorReason(ViolationIndex)));
+	}
+	return SNew(STextBlock)
+		.Text(FText::FromString(ToolTipString))
+		.ColorAndOpacity(FAppStyle::GetSlateColor("Colors.Error"));
+}
+
+bool FResScannerModule::IsUnderScanRoot(FName PackagePath)
+{
+	return PackagePath == ScanRootPath || PackagePath.ToString().StartsWith(ScanRootPath.ToString() + TEXT("/"));
+}
+
+// 保存检查点
+// 结果文件只追加上次保存之后新增的结果，清单每次整体重写
+void FResScannerModule::SaveScanCheckpoint()
+{
+	LastCheckpointTime = FPlatformTime::Seconds();
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(FResScannerCheckpoint::GetManifestFilePath()), true);
+	if (!FResScannerCheckpoint::AppendResults(ScanEngine.Results, CheckpointedResultNum, CheckpointedLineNum))
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[SaveScanCheckpoint] Failed to write %s"), *FResScannerCheckpoint::GetResultsFilePath());
+		return;
+	}
+	CheckpointedResultNum = ScanEngine.Results.Num();
+
+	FResScannerCheckpoint Checkpoint;
+	Checkpoint.RuleSetFingerprint = ScanEngine.CompiledRules.GetFingerprint();
+	Checkpoint.ScanRootPath = ScanRootPath.ToString();
+	Checkpoint.ScanPaths = PendingScanPaths;
+	Checkpoint.NextScanPathIndex = NextScanPathIndex;
+	Checkpoint.PriorityPackages = PriorityPackages.Array();
+	// 新发现、还没有评估的资源所在目录已经扫描过了，记下资源包，继续时重新评估
+	TSet<FName> PendingPackages;
+	for (int32 AssetIndex = PendingDiscoveredHead; AssetIndex < PendingDiscoveredAssets.Num(); ++AssetIndex)
+	{
+		PendingPackages.Add(PendingDiscoveredAssets[AssetIndex].PackageName);
+	}
+	Checkpoint.PendingPackages = PendingPackages.Array();
+	Checkpoint.ScannedAssetNum = ScannedAssetNum;
+	Checkpoint.PriorityAssetNum = PriorityAssetNum;
+	Checkpoint.ResultNum = CheckpointedLineNum;
+	if (!Checkpoint.SaveManifest())
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[SaveScanCheckpoint] Failed to write %s"), *FResScannerCheckpoint::GetManifestFilePath());
+		return;
+	}
+	// 统计数据也一起保存，编辑器崩溃时不会丢失
+	ScanEngine.RuleScheduler.SaveStats();
+}
+
+// 如果有同样规则的检查点，询问是否继续
+bool FResScannerModule::TryResumeFromCheckpoint()
+{
+	if (GetDefault<UResScannerSettings>()->CheckpointIntervalSeconds <= 0.0f)
+	{
+		return false;
+	}
+
+	FResScannerCheckpoint Checkpoint;
+	if (!Checkpoint.LoadManifest())
+	{
+		return false;
+	}
+	if (Checkpoint.RuleSetFingerprint != ScanEngine.CompiledRules.GetFingerprint() || Checkpoint.ScanRootPath != ScanRootPath.ToString())
+	{
+		UE_LOG(LogResScanner, Log, TEXT("[TryResumeFromCheckpoint] Rules changed since last checkpoint, starting a new scan"));
+		return false;
+	}
+
+	const FText Message = FText::Format(LOCTEXT("ResumeCheckpoint", "上一次使用同样规则的扫描没有完成（已扫描 {0}/{1} 个目录，{2} 条结果），是否从中断处继续？\n选择\"否\"将重新扫描。"),
+		FText::AsNumber(Checkpoint.NextScanPathIndex), FText::AsNumber(Checkpoint.ScanPaths.Num()), FText::AsNumber(Checkpoint.ResultNum));
+	if (FMessageDialog::Open(EAppMsgType::YesNo, Message) != EAppReturnType::Yes)
+	{
+		return false;
+	}
+
+	if (!Checkpoint.LoadResults(ScanEngine.Results))
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[TryResumeFromCheckpoint] Failed to load checkpoint results, starting a new scan"));
+		ScanEngine.ResetResults();
+		return false;
+	}
+	ScanEngine.ResultNum = ScanEngine.Results.Num();
+	bResumedFromCheckpoint = true;
+	CheckpointedResultNum = ScanEngine.Results.Num();
+	CheckpointedLineNum = Checkpoint.ResultNum;
+	ScannedAssetNum = Checkpoint.ScannedAssetNum;
+	PriorityAssetNum = Checkpoint.PriorityAssetNum;
+	PriorityPackages.Append(Checkpoint.PriorityPackages);
+
+	// 目录顺序必须和检查点一致，之后新建的目录追加到末尾
+	TArray<FName> CurrentScanPaths = MoveTemp(PendingScanPaths);
+	PendingScanPaths = MoveTemp(Checkpoint.ScanPaths);
+	NextScanPathIndex = FMath::Min(Checkpoint.NextScanPathIndex, PendingScanPaths.Num());
+	ScanPathIndices.Reset();
+	for (int32 PathIndex = 0; PathIndex < PendingScanPaths.Num(); ++PathIndex)
+	{
+		ScanPathIndices.Add(PendingScanPaths[PathIndex], PathIndex);
+	}
+	for (const FName& ScanPath : CurrentScanPaths)
+	{
+		if (!ScanPathIndices.Contains(ScanPath))
+		{
+			ScanPathIndices.Add(ScanPath, PendingScanPaths.Add(ScanPath));
+		}
+	}
+
+	// 中断时还没有评估的新发现资源
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FAssetData> PackageAssets;
+	for (const FName& PackageName : Checkpoint.PendingPackages)
+	{
+		PackageAssets.Reset();
+		AssetRegistry.GetAssetsByPackageName(PackageName, PackageAssets);
+		PendingDiscoveredAssets.Append(PackageAssets);
+	}
+
+	UE_LOG(LogResScanner, Log, TEXT("[TryResumeFromCheckpoint] Resumed at path %d of %d with %d results"),
+		NextScanPathIndex, PendingScanPaths.Num(), ScanEngine.Results.Num());
+	RefreshResultTree();
+	return true;
+}
+
+// 扫描状态
+FText FResScannerModule::GetScanStatusText() const
+{
+	if (!ScanEngine.Baseline.IsLoaded())
+	{
+		return GetScanProgressText();
+	}
+	return FText::Format(LOCTEXT("ScanStatusBaseline", "{0}，基线中已有的 {1} 条违规未显示，{2} 条基线违规没有出现（已修复或者不在扫描范围内）"),
+		GetScanProgressText(), FText::AsNumber(ScanEngine.Baseline.GetMatchedNum()), FText::AsNumber(ScanEngine.Baseline.GetUnseenNum()));
+}
+
+FText FResScannerModule::GetScanProgressText() const
+{
+	if (ScanMode == EResScanMode::Sampled)
+	{
+		return FText::Format(LOCTEXT("ScanStatusSampled", "抽样扫描{0}：已扫描 {1}/{2} 个目录，抽取 {3} 个资源，{4} 条结果{5}"),
+			bScanInProgress ? LOCTEXT("Running", "中") : FText::GetEmpty(),
+			FText::AsNumber(NextScanPathIndex), FText::AsNumber(PendingScanPaths.Num()),
+			FText::AsNumber(ScannedAssetNum), FText::AsNumber(ScanEngine.Results.Num()),
+			bScanBudgetExhausted ? LOCTEXT("BudgetExhausted", "（已达到扫描预算，估计只覆盖已扫描的目录）") : FText::GetEmpty());
+	}
+	if (bScanBudgetExhausted)
+	{
+		return FText::Format(LOCTEXT("ScanStatusBudget", "已扫描 {0} 个资源，{1} 条结果（已达到扫描预算，结果不完整，再次扫描可以从检查点继续）"),
+			FText::AsNumber(ScannedAssetNum), FText::AsNumber(ScanEngine.Results.Num()));
+	}
+	if (bScanInProgress)
+	{
+		if (NextScanPathIndex >= PendingScanPaths.Num())
+		{
+			return FText::Format(LOCTEXT("ScanStatusProgressive", "已扫描 {0} 个资源（优先 {1} 个），{2} 条结果（资源注册表仍在发现资源，结果未完成）"),
+				FText::AsNumber(ScannedAssetNum), FText::AsNumber(PriorityAssetNum), FText::AsNumber(ScanEngine.Results.Num()));
+		}
+		return FText::Format(LOCTEXT("ScanStatusRunning", "正在扫描 {0}/{1} 个目录，已扫描 {2} 个资源（优先 {3} 个），{4} 条结果"),
+			FText::AsNumber(NextScanPathIndex), FText::AsNumber(PendingScanPaths.Num()),
+			FText::AsNumber(ScannedAssetNum), FText::AsNumber(PriorityAssetNum), FText::AsNumber(ScanEngine.Results.Num()));
+	}
+	if (!bScanResultsFinal)
+	{
+		return FText::Format(LOCTEXT("ScanStatusIncomplete", "已扫描 {0} 个资源，{1} 条结果（扫描未完成，结果不完整）"),
+			FText::AsNumber(ScannedAssetNum), FText::AsNumber(ScanEngine.Results.Num()));
+	}
+	return FText::Format(LOCTEXT("ScanStatusFinal", "已扫描 {0} 个资源，{1} 条结果"),
+		FText::AsNumber(ScannedAssetNum), FText::AsNumber(ScanEngine.Results.Num()));
+}
+
+// 用户点击菜单按钮或命令时，会打开这个插件的窗口
+void FResScannerModule::PluginButtonClicked()
+{
+	// 请求打开窗口
+	FGlobalTabmanager::Get()->TryInvokeTab(ResScannerTabName);
+}
+
+// 注册插件菜单项和工具栏按钮
+void FResScannerModule::RegisterMenus()
+{
+	// 设置当前模块为菜单项的所有者，方便后续卸载清理
+	// Owner will be used for cleanup in call to UToolMenus::UnregisterOwner
+	FToolMenuOwnerScoped OwnerScoped(this);
+
+	// 在主菜单 Window -> Layout 下添加插件菜单按钮
+	{
+		UToolMenu* Menu = UToolMenus::Get()->ExtendMenu("LevelEditor.MainMenu.Window");
+		{
+			FToolMenuSection& Section = Menu->FindOrAddSection("WindowLayout");
+			Section.AddMenuEntryWithCommandList(FResScannerCommands::Get().OpenPluginWindow, PluginCommands);
+		}
+	}
+
+	// 在工具栏的 Settings 区域添加按钮
+	{
+		UToolMenu* ToolbarMenu = UToolMenus::Get()->ExtendMenu("LevelEditor.LevelEditorToolBar");
+		{
+			FToolMenuSection& Section = ToolbarMenu->FindOrAddSection("Settings");
+			{
+				// 初始化工具栏按钮并绑定命令
+				FToolMenuEntry& Entry = Section.AddEntry(FToolMenuEntry::InitToolBarButton(FResScannerCommands::Get().OpenPluginWindow));
+				Entry.SetCommandList(PluginCommands);
 			}
 		}
 	}
@@ -708,6 +2106,177 @@ void FResScannerModule::RegisterMenus()
 
 
 //-------------------------------- Util ---------------------------------
+/**
+ * 把规则的作用范围和 SaveAction 写入规则 Json，它们在规则基类上，不在 RuleData 中，需要单独处理
+ * @param InRule 规则
+ * @param OutRuleJson 规则的 Json 对象
+ */
+void FResScannerModule::WriteRuleScopeToJson(const UResScannerRuleBase* InRule, const TSharedRef<FJsonObject>& OutRuleJson)
+{
+	TArray<TSharedPtr<FJsonValue>> ScopePathsArray;
+	for (const FDirectoryPath& ScopePath : InRule->ScopePaths)
+	{
+		ScopePathsArray.Add(MakeShareable(new FJsonValueString(ScopePath.Path)));
+	}
+	OutRuleJson->SetArrayField("ScopePaths", ScopePathsArray);
+
+	TArray<TSharedPtr<FJsonValue>> ScopeClassesArray;
+	for (const TSoftClassPtr<UObject>& ScopeClass : InRule->ScopeClasses)
+	{
+		ScopeClassesArray.Add(MakeShareable(new FJsonValueString(ScopeClass.ToString())));
+	}
+	OutRuleJson->SetArrayField("ScopeClasses", ScopeClassesArray);
+
+	OutRuleJson->SetStringField("SaveAction", StaticEnum<EResScannerSaveAction>()->GetNameStringByValue(static_cast<int64>(InRule->SaveAction)));
+}
+
+/**
+ * 从规则 Json 中读取作用范围，旧的配置文件没有这两个字段，此时保持为空（作用于所有资源）
+ * @param InRuleJson 规则的 Json 对象
+ * @param OutRule 规则
+ */
+void FResScannerModule::ReadRuleScopeFromJson(const TSharedRef<FJsonObject>& InRuleJson, UResScannerRuleBase* OutRule)
+{
+	const TArray<TSharedPtr<FJsonValue>>* ScopePathsArray;
+	if (InRuleJson->TryGetArrayField(TEXT("ScopePaths"), ScopePathsArray))
+	{
+		for (const TSharedPtr<FJsonValue>& PathValue : *ScopePathsArray)
+		{
+			FDirectoryPath ScopePath;
+			ScopePath.Path = PathValue->AsString();
+			OutRule->ScopePaths.Add(ScopePath);
+		}
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* ScopeClassesArray;
+	if (InRuleJson->TryGetArrayField(TEXT("ScopeClasses"), ScopeClassesArray))
+	{
+		for (const TSharedPtr<FJsonValue>& ClassValue : *ScopeClassesArray)
+		{
+			OutRule->ScopeClasses.Add(TSoftClassPtr<UObject>(FSoftObjectPath(ClassValue->AsString())));
+		}
+	}
+
+	// 旧的配置文件没有 SaveAction，保持默认值
+	FString SaveActionString;
+	if (InRuleJson->TryGetStringField(TEXT("SaveAction"), SaveActionString))
+	{
+		const int64 SaveActionValue = StaticEnum<EResScannerSaveAction>()->GetValueByNameString(SaveActionString);
+		if (SaveActionValue != INDEX_NONE)
+		{
+			OutRule->SaveAction = static_cast<EResScannerSaveAction>(SaveActionValue);
+		}
+	}
+}
+
+/**
+ * 从文件加载一个规则集，规则集没有名字时使用文件名
+ * 返回的规则集已经 AddToRoot，移除时需要 RemoveFromRoot
+ * @param FilePath Json 文件路径
+ * @return 加载失败返回 nullptr
+ */
+UResScannerRuleSet* FResScannerModule::LoadRuleSetFromFile(const FString& FilePath)
+{
+	FString JsonString;
+	if (!FFileHelper::LoadFileToString(JsonString, *FilePath))
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[LoadRuleSetFromFile] 文件读取失败: %s"), *FilePath);
+		return nullptr;
+	}
+
+	UResScannerRuleSet* NewRuleSet = NewObject<UResScannerRuleSet>();
+	NewRuleSet->RuleSetName = FPaths::GetBaseFilename(FilePath);
+	if (!DeserializeRuleSetFromJson(JsonString, NewRuleSet))
+	{
+		return nullptr;
+	}
+	// 模块不是 UObject，不能用 UPROPERTY 引用，需要手动防止被 GC
+	NewRuleSet->AddToRoot();
+	return NewRuleSet;
+}
+
+/**
+ * 将 SerializeRuleSetToJson 生成的 Json 字符串反序列化到规则集中，会清空规则集原有的规则
+ * @param InJsonStr Json 字符串
+ * @param OutRuleSet 规则集，同时作为新建规则的 Outer
+ * @return 
+ */
+bool FResScannerModule::DeserializeRuleSetFromJson(const FString& InJsonStr, UResScannerRuleSet* OutRuleSet)
+{
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(InJsonStr);
+	// 将 json 字符串反序列化为 json 对象
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[DeserializeRuleSetFromJson] 文件反序列化失败"));
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* RulesArray;
+	// 根据 "Rules" 字段获取 json 对象中的规则数组
+	if (!JsonObject->TryGetArrayField(TEXT("Rules"), RulesArray))
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[DeserializeRuleSetFromJson] 规则数组获取失败"));
+		return false;
+	}
+
+	OutRuleSet->Rules.Empty();
+	JsonObject->TryGetStringField(TEXT("RuleSetName"), OutRuleSet->RuleSetName);
+	// 组合逻辑，旧的配置文件没有这个字段，使用默认值
+	OutRuleSet->CompositeLogic = ERuleSetLogic::Independent;
+	FString LogicString;
+	if (JsonObject->TryGetStringField(TEXT("CompositeLogic"), LogicString))
+	{
+		const int64 LogicValue = StaticEnum<ERuleSetLogic>()->GetValueByNameString(LogicString);
+		if (LogicValue != INDEX_NONE)
+		{
+			OutRuleSet->CompositeLogic = static_cast<ERuleSetLogic>(LogicValue);
+		}
+	}
+
+	for (const TSharedPtr<FJsonValue>& RuleValue : *RulesArray)
+	{
+		// TODO: 注意这里展示了 TSharedPtr 怎么转换为 TSharedRef!!!
+		const TSharedRef<FJsonObject>& RuleJsonObject = RuleValue->AsObject().ToSharedRef();
+		FString RuleType;
+		if (!RuleJsonObject->TryGetStringField(TEXT("Type"), RuleType))
+		{
+			continue;
+		}
+		UE_LOG(LogResScanner, Log, TEXT("[DeserializeRuleSetFromJson] RuleType: %s"), *RuleType);
+
+		// 规则集作为规则的 Outer
+		// 注意不能给规则指定固定的名字，同一个 Outer 下同名会替换掉之前创建的规则
+		UResScannerRuleBase* NewRule = nullptr;
+		if (RuleType.Equals(TEXT("NameMatch")))
+		{
+			UNameMatchRuleExecutor* NameRule = NewObject<UNameMatchRuleExecutor>(OutRuleSet);
+			// JsonObject, StructDefinition, OutStruct, Flag
+			FJsonObjectConverter::JsonObjectToUStruct(RuleJsonObject, FNameMatchRule::StaticStruct(), &NameRule->RuleData, 0, 0);
+			NewRule = NameRule;
+		}
+		else if (RuleType.Equals(TEXT("PropertyMatch")))
+		{
+			UPropertyMatchRuleExecutor* PropertyRule = NewObject<UPropertyMatchRuleExecutor>(OutRuleSet);
+			FJsonObjectConverter::JsonObjectToUStruct(RuleJsonObject, FPropertyMatchRule::StaticStruct(), &PropertyRule->RuleData, 0, 0);
+			NewRule = PropertyRule;
+		}
+		else if (RuleType.Equals(TEXT("TagMatch")))
+		{
+			UTagMatchRuleExecutor* TagRule = NewObject<UTagMatchRuleExecutor>(OutRuleSet);
+			FJsonObjectConverter::JsonObjectToUStruct(RuleJsonObject, FTagMatchRule::StaticStruct(), &TagRule->RuleData, 0, 0);
+			NewRule = TagRule;
+		}
+
+		if (NewRule)
+		{
+			ReadRuleScopeFromJson(RuleJsonObject, NewRule);
+			OutRuleSet->Rules.Add(NewRule);
+		}
+	}
+	return true;
+}
+
 /**
  * 使用 FJsonObjectConverter 将 UResScannerRuleSet 和 FNameMatchRule 转换为 Json
  * @param InRuleSet 规则集
@@ -728,6 +2297,8 @@ bool FResScannerModule::SerializeRuleSetToJson(const UResScannerRuleSet* InRuleS
 		TSharedRef<FJsonObject> RuleJson = MakeShareable(new FJsonObject);
 		// 根据规则类型设置 Json 中 Type 的值
 		RuleJson->SetStringField("Type", Rule->ScanRuleTypeToString(Rule->GetRuleType()));
+		// 规则的作用范围（目录、类型）
+		WriteRuleScopeToJson(Rule, RuleJson);
 		
 		if (auto NameRule = Cast<UNameMatchRuleExecutor>(Rule))
 		{
@@ -741,10 +2312,17 @@ bool FResScannerModule::SerializeRuleSetToJson(const UResScannerRuleSet* InRuleS
 			FJsonObjectConverter::UStructToJsonObject(FPropertyMatchRule::StaticStruct(), &PropertyRule->RuleData, RuleJson, 0, 0);
 			RulesArray.Add(MakeShareable(new FJsonValueObject(RuleJson)));
 		}
+		else if (auto TagRule = Cast<UTagMatchRuleExecutor>(Rule))
+		{
+			FJsonObjectConverter::UStructToJsonObject(FTagMatchRule::StaticStruct(), &TagRule->RuleData, RuleJson, 0, 0);
+			RulesArray.Add(MakeShareable(new FJsonValueObject(RuleJson)));
+		}
 		
 		// TODO: 其它类型的规则处理
 	}
 	JsonObject->SetArrayField("Rules", RulesArray);
+	JsonObject->SetStringField("CompositeLogic", StaticEnum<ERuleSetLogic>()->GetNameStringByValue(static_cast<int64>(InRuleSet->CompositeLogic)));
+	JsonObject->SetStringField("RuleSetName", InRuleSet->RuleSetName);
 
 	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutJsonStr);
 	FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
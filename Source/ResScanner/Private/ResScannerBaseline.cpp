@@ -0,0 +1,152 @@
+#include "ResScannerBaseline.h"
+#include "ResScannerEngine.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Unique.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+
+// 基线文件格式版本，格式变化时旧的基线需要重新生成
+static constexpr uint32 BaselineMagic = 0x4C425352;		// "RSBL"
+// 2：违规键和规则指纹改为对 UTF-8 哈希，不同平台生成的键一致
+static constexpr uint32 BaselineVersion = 2;
+// 布隆过滤器的探测次数
+static constexpr int32 BloomProbeNum = 4;
+
+uint64 FResScannerBaseline::MakeViolationKey(const FString& AssetPath, const FString& RuleFingerprint, const FString& ErrorReason)
+{
+	const FString KeySource = FString::Printf(TEXT("%s|%s|%s"), *AssetPath, *RuleFingerprint, *ErrorReason);
+	// 按 UTF-8 哈希，Windows 上生成的基线在 Linux CI 上也能匹配
+	const FTCHARToUTF8 Utf8Source(*KeySource);
+	return CityHash64(Utf8Source.Get(), Utf8Source.Length());
+}
+
+bool FResScannerBaseline::Save(const FString& FilePath, TArray<uint64> SortedKeys)
+{
+	SortedKeys.Sort();
+	// 同一个键只保存一次
+	SortedKeys.SetNum(Algo::Unique(SortedKeys));
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer)
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[Baseline] Failed to create %s"), *FilePath);
+		return false;
+	}
+	uint32 Magic = BaselineMagic;
+	uint32 Version = BaselineVersion;
+	int32 KeyNum = SortedKeys.Num();
+	*Writer << Magic << Version << KeyNum;
+	Writer->Serialize(SortedKeys.GetData(), SortedKeys.Num() * sizeof(uint64));
+	const bool bSaved = Writer->Close();
+	UE_LOG(LogResScanner, Display, TEXT("[Baseline] Saved %d violation keys to %s"), KeyNum, *FilePath);
+	return bSaved;
+}
+
+void FResScannerBaseline::GatherAcceptedKeys(const FResScannerResultStore& Results, TArray<uint64>& OutKeys) const
+{
+	OutKeys.Reserve(OutKeys.Num() + Results.Num() + SeenKeys.CountSetBits());
+	for (int32 ViolationIndex = 0; ViolationIndex < Results.Num(); ++ViolationIndex)
+	{
+		OutKeys.Add(Results.GetViolationKey(ViolationIndex));
+	}
+	for (TConstSetBitIterator<> It(SeenKeys); It; ++It)
+	{
+		OutKeys.Add(Keys[It.GetIndex()]);
+	}
+}
+
+bool FResScannerBaseline::Load(const FString& FilePath)
+{
+	Keys.Reset();
+	bLoaded = false;
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader)
+	{
+		return false;
+	}
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int32 KeyNum = 0;
+	*Reader << Magic << Version << KeyNum;
+	if (Magic != BaselineMagic || Version != BaselineVersion || KeyNum < 0
+		|| Reader->TotalSize() - Reader->Tell() != static_cast<int64>(KeyNum) * sizeof(uint64))
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[Baseline] %s is not a valid baseline file"), *FilePath);
+		return false;
+	}
+	Keys.SetNumUninitialized(KeyNum);
+	Reader->Serialize(Keys.GetData(), KeyNum * sizeof(uint64));
+	if (Reader->IsError())
+	{
+		Keys.Reset();
+		return false;
+	}
+
+	BuildBloomFilter();
+	ResetMarks();
+	bLoaded = true;
+	UE_LOG(LogResScanner, Display, TEXT("[Baseline] Loaded %d violation keys from %s"), KeyNum, *FilePath);
+	return true;
+}
+
+bool FResScannerBaseline::MatchAndMark(uint64 ViolationKey)
+{
+	if (!MayContain(ViolationKey))
+	{
+		return false;
+	}
+	const int32 KeyIndex = Algo::BinarySearch(Keys, ViolationKey);
+	if (KeyIndex == INDEX_NONE)
+	{
+		return false;
+	}
+	// 同一个违规重复评估（优先扫描、检查点恢复）时只统计一次
+	if (!SeenKeys[KeyIndex])
+	{
+		SeenKeys[KeyIndex] = true;
+		++MatchedNum;
+	}
+	return true;
+}
+
+void FResScannerBaseline::ResetMarks()
+{
+	SeenKeys.Init(false, Keys.Num());
+	MatchedNum = 0;
+}
+
+void FResScannerBaseline::BuildBloomFilter()
+{
+	// 每个键约 10 位，向上取 2 的幂方便用掩码取模
+	const uint64 BitNum = FMath::RoundUpToPowerOfTwo64(FMath::Max<uint64>(static_cast<uint64>(Keys.Num()) * 10, 64));
+	BloomMask = BitNum - 1;
+	BloomWords.Init(0, BitNum / 64);
+	for (const uint64 Key : Keys)
+	{
+		// 键本身就是哈希值，高低 32 位做双重哈希
+		const uint64 Step = (Key >> 32) | 1;
+		for (int32 ProbeIndex = 0; ProbeIndex < BloomProbeNum; ++ProbeIndex)
+		{
+			const uint64 Bit = (Key + ProbeIndex * Step) & BloomMask;
+			BloomWords[Bit >> 6] |= 1ull << (Bit & 63);
+		}
+	}
+}
+
+bool FResScannerBaseline::MayContain(uint64 ViolationKey) const
+{
+	if (BloomWords.Num() == 0)
+	{
+		return false;
+	}
+	const uint64 Step = (ViolationKey >> 32) | 1;
+	for (int32 ProbeIndex = 0; ProbeIndex < BloomProbeNum; ++ProbeIndex)
+	{
+		const uint64 Bit = (ViolationKey + ProbeIndex * Step) & BloomMask;
+		if ((BloomWords[Bit >> 6] & (1ull << (Bit & 63))) == 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
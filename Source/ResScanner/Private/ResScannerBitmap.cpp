@@ -0,0 +1,404 @@
+#include "ResScannerBitmap.h"
+#include "Algo/BinarySearch.h"
+
+bool FResScannerBitmap::FContainer::Contains(uint16 Low) const
+{
+	if (IsBitmap())
+	{
+		return (Words[Low / 64] & (1ull << (Low % 64))) != 0;
+	}
+	return Algo::BinarySearch(Values, Low) != INDEX_NONE;
+}
+
+void FResScannerBitmap::FContainer::Add(uint16 Low)
+{
+	if (IsBitmap())
+	{
+		uint64& Word = Words[Low / 64];
+		const uint64 Bit = 1ull << (Low % 64);
+		if (!(Word & Bit))
+		{
+			Word |= Bit;
+			++Cardinality;
+		}
+		return;
+	}
+
+	if (Values.Num() == 0 || Values.Last() < Low)
+	{
+		Values.Add(Low);
+	}
+	else
+	{
+		const int32 Index = Algo::LowerBound(Values, Low);
+		if (Values[Index] == Low)
+		{
+			return;
+		}
+		Values.Insert(Low, Index);
+	}
+	++Cardinality;
+	if (Cardinality > MaxArrayNum)
+	{
+		ConvertToBitmap();
+	}
+}
+
+void FResScannerBitmap::FContainer::ConvertToBitmap()
+{
+	Words.SetNumZeroed(BitmapWordNum);
+	for (const uint16 Low : Values)
+	{
+		Words[Low / 64] |= 1ull << (Low % 64);
+	}
+	Values.Empty();
+}
+
+void FResScannerBitmap::FContainer::Optimize()
+{
+	if (!IsBitmap())
+	{
+		Cardinality = Values.Num();
+		return;
+	}
+	Cardinality = 0;
+	for (const uint64 Word : Words)
+	{
+		Cardinality += FMath::CountBits(Word);
+	}
+	if (Cardinality > MaxArrayNum)
+	{
+		return;
+	}
+	Values.Reset(Cardinality);
+	for (int32 WordIndex = 0; WordIndex < BitmapWordNum; ++WordIndex)
+	{
+		for (uint64 Word = Words[WordIndex]; Word; Word &= Word - 1)
+		{
+			Values.Add(uint16(WordIndex * 64 + FMath::CountTrailingZeros64(Word)));
+		}
+	}
+	Words.Empty();
+}
+
+void FResScannerBitmap::Add(uint32 Value)
+{
+	FindOrAddContainer(uint16(Value >> 16)).Add(uint16(Value & 0xFFFF));
+}
+
+bool FResScannerBitmap::Contains(uint32 Value) const
+{
+	const FContainer* Container = FindContainer(uint16(Value >> 16));
+	return Container && Container->Contains(uint16(Value & 0xFFFF));
+}
+
+int64 FResScannerBitmap::Num() const
+{
+	int64 Num = 0;
+	for (const FContainer& Container : Containers)
+	{
+		Num += Container.Cardinality;
+	}
+	return Num;
+}
+
+void FResScannerBitmap::ForEach(TFunctionRef<void(uint32 Value)> Visitor) const
+{
+	for (const FContainer& Container : Containers)
+	{
+		const uint32 High = uint32(Container.Key) << 16;
+		if (!Container.IsBitmap())
+		{
+			for (const uint16 Low : Container.Values)
+			{
+				Visitor(High | Low);
+			}
+			continue;
+		}
+		for (int32 WordIndex = 0; WordIndex < BitmapWordNum; ++WordIndex)
+		{
+			for (uint64 Word = Container.Words[WordIndex]; Word; Word &= Word - 1)
+			{
+				Visitor(High | uint32(WordIndex * 64 + FMath::CountTrailingZeros64(Word)));
+			}
+		}
+	}
+}
+
+FResScannerBitmap FResScannerBitmap::And(const FResScannerBitmap& A, const FResScannerBitmap& B)
+{
+	FResScannerBitmap Result;
+	int32 IndexA = 0;
+	int32 IndexB = 0;
+	while (IndexA < A.Containers.Num() && IndexB < B.Containers.Num())
+	{
+		const FContainer& ContainerA = A.Containers[IndexA];
+		const FContainer& ContainerB = B.Containers[IndexB];
+		if (ContainerA.Key < ContainerB.Key)
+		{
+			++IndexA;
+		}
+		else if (ContainerB.Key < ContainerA.Key)
+		{
+			++IndexB;
+		}
+		else
+		{
+			FContainer Container = AndContainers(ContainerA, ContainerB);
+			if (Container.Cardinality > 0)
+			{
+				Result.Containers.Add(MoveTemp(Container));
+			}
+			++IndexA;
+			++IndexB;
+		}
+	}
+	return Result;
+}
+
+FResScannerBitmap FResScannerBitmap::Or(const FResScannerBitmap& A, const FResScannerBitmap& B)
+{
+	FResScannerBitmap Result;
+	Result.Containers.Reserve(FMath::Max(A.Containers.Num(), B.Containers.Num()));
+	int32 IndexA = 0;
+	int32 IndexB = 0;
+	while (IndexA < A.Containers.Num() || IndexB < B.Containers.Num())
+	{
+		if (IndexB >= B.Containers.Num() || (IndexA < A.Containers.Num() && A.Containers[IndexA].Key < B.Containers[IndexB].Key))
+		{
+			Result.Containers.Add(A.Containers[IndexA++]);
+		}
+		else if (IndexA >= A.Containers.Num() || B.Containers[IndexB].Key < A.Containers[IndexA].Key)
+		{
+			Result.Containers.Add(B.Containers[IndexB++]);
+		}
+		else
+		{
+			Result.Containers.Add(OrContainers(A.Containers[IndexA++], B.Containers[IndexB++]));
+		}
+	}
+	return Result;
+}
+
+FResScannerBitmap FResScannerBitmap::AndNot(const FResScannerBitmap& A, const FResScannerBitmap& B)
+{
+	FResScannerBitmap Result;
+	int32 IndexB = 0;
+	for (const FContainer& ContainerA : A.Containers)
+	{
+		while (IndexB < B.Containers.Num() && B.Containers[IndexB].Key < ContainerA.Key)
+		{
+			++IndexB;
+		}
+		if (IndexB >= B.Containers.Num() || B.Containers[IndexB].Key != ContainerA.Key)
+		{
+			Result.Containers.Add(ContainerA);
+			continue;
+		}
+		FContainer Container = AndNotContainers(ContainerA, B.Containers[IndexB]);
+		if (Container.Cardinality > 0)
+		{
+			Result.Containers.Add(MoveTemp(Container));
+		}
+	}
+	return Result;
+}
+
+FResScannerBitmap FResScannerBitmap::Range(uint32 Count)
+{
+	FResScannerBitmap Result;
+	for (uint32 First = 0; First < Count; First += 65536)
+	{
+		FContainer& Container = Result.Containers.AddDefaulted_GetRef();
+		Container.Key = uint16(First >> 16);
+		const uint32 Num = FMath::Min<uint32>(Count - First, 65536);
+		Container.Words.SetNumZeroed(BitmapWordNum);
+		for (uint32 WordIndex = 0; WordIndex < Num / 64; ++WordIndex)
+		{
+			Container.Words[WordIndex] = ~0ull;
+		}
+		if (Num % 64)
+		{
+			Container.Words[Num / 64] = (1ull << (Num % 64)) - 1;
+		}
+		Container.Optimize();
+	}
+	return Result;
+}
+
+SIZE_T FResScannerBitmap::GetAllocatedSize() const
+{
+	SIZE_T Size = Containers.GetAllocatedSize();
+	for (const FContainer& Container : Containers)
+	{
+		Size += Container.Values.GetAllocatedSize() + Container.Words.GetAllocatedSize();
+	}
+	return Size;
+}
+
+FResScannerBitmap::FContainer FResScannerBitmap::AndContainers(const FContainer& A, const FContainer& B)
+{
+	FContainer Result;
+	Result.Key = A.Key;
+	if (A.IsBitmap() && B.IsBitmap())
+	{
+		Result.Words.SetNumUninitialized(BitmapWordNum);
+		for (int32 WordIndex = 0; WordIndex < BitmapWordNum; ++WordIndex)
+		{
+			Result.Words[WordIndex] = A.Words[WordIndex] & B.Words[WordIndex];
+		}
+	}
+	else if (!A.IsBitmap() && !B.IsBitmap())
+	{
+		// 两个升序数组归并
+		int32 IndexA = 0;
+		int32 IndexB = 0;
+		while (IndexA < A.Values.Num() && IndexB < B.Values.Num())
+		{
+			if (A.Values[IndexA] < B.Values[IndexB])
+			{
+				++IndexA;
+			}
+			else if (B.Values[IndexB] < A.Values[IndexA])
+			{
+				++IndexB;
+			}
+			else
+			{
+				Result.Values.Add(A.Values[IndexA]);
+				++IndexA;
+				++IndexB;
+			}
+		}
+	}
+	else
+	{
+		// 数组和位图：逐个查位图
+		const FContainer& ArrayContainer = A.IsBitmap() ? B : A;
+		const FContainer& BitmapContainer = A.IsBitmap() ? A : B;
+		for (const uint16 Low : ArrayContainer.Values)
+		{
+			if (BitmapContainer.Contains(Low))
+			{
+				Result.Values.Add(Low);
+			}
+		}
+	}
+	Result.Optimize();
+	return Result;
+}
+
+FResScannerBitmap::FContainer FResScannerBitmap::OrContainers(const FContainer& A, const FContainer& B)
+{
+	FContainer Result;
+	Result.Key = A.Key;
+	if (!A.IsBitmap() && !B.IsBitmap() && A.Cardinality + B.Cardinality <= MaxArrayNum)
+	{
+		Result.Values.Reserve(A.Cardinality + B.Cardinality);
+		int32 IndexA = 0;
+		int32 IndexB = 0;
+		while (IndexA < A.Values.Num() || IndexB < B.Values.Num())
+		{
+			if (IndexB >= B.Values.Num() || (IndexA < A.Values.Num() && A.Values[IndexA] < B.Values[IndexB]))
+			{
+				Result.Values.Add(A.Values[IndexA++]);
+			}
+			else if (IndexA >= A.Values.Num() || B.Values[IndexB] < A.Values[IndexA])
+			{
+				Result.Values.Add(B.Values[IndexB++]);
+			}
+			else
+			{
+				Result.Values.Add(A.Values[IndexA++]);
+				++IndexB;
+			}
+		}
+		Result.Cardinality = Result.Values.Num();
+		return Result;
+	}
+
+	// 结果可能超过数组块的上限，用位图合并
+	Result.Words.SetNumZeroed(BitmapWordNum);
+	for (const FContainer* Container : { &A, &B })
+	{
+		if (Container->IsBitmap())
+		{
+			for (int32 WordIndex = 0; WordIndex < BitmapWordNum; ++WordIndex)
+			{
+				Result.Words[WordIndex] |= Container->Words[WordIndex];
+			}
+		}
+		else
+		{
+			for (const uint16 Low : Container->Values)
+			{
+				Result.Words[Low / 64] |= 1ull << (Low % 64);
+			}
+		}
+	}
+	Result.Optimize();
+	return Result;
+}
+
+FResScannerBitmap::FContainer FResScannerBitmap::AndNotContainers(const FContainer& A, const FContainer& B)
+{
+	FContainer Result;
+	Result.Key = A.Key;
+	if (!A.IsBitmap())
+	{
+		for (const uint16 Low : A.Values)
+		{
+			if (!B.Contains(Low))
+			{
+				Result.Values.Add(Low);
+			}
+		}
+	}
+	else
+	{
+		Result.Words = A.Words;
+		if (B.IsBitmap())
+		{
+			for (int32 WordIndex = 0; WordIndex < BitmapWordNum; ++WordIndex)
+			{
+				Result.Words[WordIndex] &= ~B.Words[WordIndex];
+			}
+		}
+		else
+		{
+			for (const uint16 Low : B.Values)
+			{
+				Result.Words[Low / 64] &= ~(1ull << (Low % 64));
+			}
+		}
+	}
+	Result.Optimize();
+	return Result;
+}
+
+FResScannerBitmap::FContainer& FResScannerBitmap::FindOrAddContainer(uint16 Key)
+{
+	// 资源编号通常按升序添加，先看最后一块
+	if (Containers.Num() > 0 && Containers.Last().Key == Key)
+	{
+		return Containers.Last();
+	}
+	int32 Index = Containers.Num();
+	if (Containers.Num() > 0 && Key < Containers.Last().Key)
+	{
+		Index = Algo::LowerBoundBy(Containers, Key, &FContainer::Key);
+		if (Containers[Index].Key == Key)
+		{
+			return Containers[Index];
+		}
+	}
+	FContainer& Container = Containers.InsertDefaulted_GetRef(Index);
+	Container.Key = Key;
+	return Container;
+}
+
+const FResScannerBitmap::FContainer* FResScannerBitmap::FindContainer(uint16 Key) const
+{
+	const int32 Index = Algo::LowerBoundBy(Containers, Key, &FContainer::Key);
+	return Containers.IsValidIndex(Index) && Containers[Index].Key == Key ? &Containers[Index] : nullptr;
+}
@@ -0,0 +1,118 @@
+#include "ResScannerChangeScope.h"
+#include "ResScannerEngine.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+// 执行 git 并按字节读取标准输出；ExecProcess 把输出转成 FString，-z 输出中的 NUL 会截断字符串
+static bool ExecGit(const FString& Params, TArray<uint8>& OutStdOut, FString& OutStdErr, int32& OutReturnCode)
+{
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	void* StdErrRead = nullptr;
+	void* StdErrWrite = nullptr;
+	if (!FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite) || !FPlatformProcess::CreatePipe(StdErrRead, StdErrWrite))
+	{
+		FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+		return false;
+	}
+
+	FProcHandle Proc = FPlatformProcess::CreateProc(TEXT("git"), *Params, false, true, true, nullptr, 0, nullptr, StdOutWrite, nullptr, StdErrWrite);
+	if (Proc.IsValid())
+	{
+		// 边运行边读取，输出超过管道缓冲区时 git 不会阻塞
+		TArray<uint8> Chunk;
+		bool bRunning = true;
+		while (bRunning)
+		{
+			bRunning = FPlatformProcess::IsProcRunning(Proc);
+			while (FPlatformProcess::ReadPipeToArray(StdOutRead, Chunk) && Chunk.Num() > 0)
+			{
+				OutStdOut.Append(Chunk);
+			}
+			OutStdErr += FPlatformProcess::ReadPipe(StdErrRead);
+			if (bRunning)
+			{
+				FPlatformProcess::Sleep(0.001f);
+			}
+		}
+		FPlatformProcess::GetProcReturnCode(Proc, &OutReturnCode);
+		FPlatformProcess::CloseProc(Proc);
+	}
+	FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+	FPlatformProcess::ClosePipe(StdErrRead, StdErrWrite);
+	return Proc.IsValid();
+}
+
+bool FResScannerChangeScope::GatherChangedPackages(const FString& RevisionRange, TArray<FName>& OutPackageNames, TArray<FString>* OutFilenames)
+{
+	const FString ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+	// --relative：输出相对于项目目录的路径，项目不在仓库根目录时也能直接拼接
+	// --diff-filter=ACMRT：只要新增、复制、修改、重命名、类型变化的文件，不要删除的文件
+	// -z：文件名以 NUL 分隔、不加引号转义，否则中文等非 ASCII 路径会被输出成 "\344\270\255..." 的形式
+	const FString GitParams = FString::Printf(TEXT("-C \"%s\" diff --name-only -z --relative --diff-filter=ACMRT %s -- Content"),
+		*ProjectDir, *RevisionRange);
+
+	int32 ReturnCode = -1;
+	TArray<uint8> StdOut;
+	FString StdErr;
+	if (!ExecGit(GitParams, StdOut, StdErr, ReturnCode) || ReturnCode != 0)
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[GatherChangedPackages] git %s failed (%d): %s"), *GitParams, ReturnCode, *StdErr);
+		return false;
+	}
+
+	// git 输出的路径是 UTF-8
+	TArray<FString> ChangedFiles;
+	int32 NameStart = 0;
+	for (int32 ByteIndex = 0; ByteIndex < StdOut.Num(); ++ByteIndex)
+	{
+		if (StdOut[ByteIndex] == 0)
+		{
+			if (ByteIndex > NameStart)
+			{
+				const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(StdOut.GetData() + NameStart), ByteIndex - NameStart);
+				ChangedFiles.Emplace(Converted.Length(), Converted.Get());
+			}
+			NameStart = ByteIndex + 1;
+		}
+	}
+
+	TSet<FName> PackageNames;
+	for (const FString& ChangedFile : ChangedFiles)
+	{
+		const FString Filename = ProjectDir / ChangedFile;
+		FString PackageName;
+		if (FPackageName::IsPackageExtension(*FPaths::GetExtension(Filename, true))
+			&& FPackageName::TryConvertFilenameToLongPackageName(Filename, PackageName))
+		{
+			bool bAlreadyInSet = false;
+			PackageNames.Add(FName(*PackageName), &bAlreadyInSet);
+			if (OutFilenames && !bAlreadyInSet)
+			{
+				OutFilenames->Add(Filename);
+			}
+		}
+	}
+	OutPackageNames = PackageNames.Array();
+	UE_LOG(LogResScanner, Display, TEXT("[GatherChangedPackages] %d changed files, %d packages in %s"),
+		ChangedFiles.Num(), OutPackageNames.Num(), *RevisionRange);
+	return true;
+}
+
+void FResScannerChangeScope::AddDirectReferencers(TArray<FName>& InOutPackageNames)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	TSet<FName> PackageNames(InOutPackageNames);
+	TArray<FName> Referencers;
+	for (const FName& PackageName : InOutPackageNames)
+	{
+		Referencers.Reset();
+		AssetRegistry.GetReferencers(PackageName, Referencers);
+		PackageNames.Append(Referencers);
+	}
+	UE_LOG(LogResScanner, Display, TEXT("[AddDirectReferencers] %d packages, %d with direct referencers"),
+		InOutPackageNames.Num(), PackageNames.Num());
+	InOutPackageNames = PackageNames.Array();
+}
@@ -0,0 +1,197 @@
+#include "ResScannerCheckpoint.h"
+#include "ResScannerEngine.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+// 清单格式版本，格式变化时旧的检查点直接作废
+static constexpr int32 CheckpointVersion = 1;
+
+FString FResScannerCheckpoint::GetManifestFilePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("ResScanner") / TEXT("Checkpoint.json");
+}
+
+FString FResScannerCheckpoint::GetResultsFilePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("ResScanner") / TEXT("CheckpointResults.ndjson");
+}
+
+bool FResScannerCheckpoint::SaveManifest() const
+{
+	TSharedRef<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
+	JsonObject->SetNumberField(TEXT("Version"), CheckpointVersion);
+	JsonObject->SetStringField(TEXT("RuleSetFingerprint"), RuleSetFingerprint);
+	JsonObject->SetStringField(TEXT("ScanRootPath"), ScanRootPath);
+	JsonObject->SetNumberField(TEXT("NextScanPathIndex"), NextScanPathIndex);
+	JsonObject->SetNumberField(TEXT("ScannedAssetNum"), ScannedAssetNum);
+	JsonObject->SetNumberField(TEXT("PriorityAssetNum"), PriorityAssetNum);
+	JsonObject->SetNumberField(TEXT("ResultNum"), ResultNum);
+
+	TArray<TSharedPtr<FJsonValue>> ScanPathsArray;
+	for (const FName& ScanPath : ScanPaths)
+	{
+		ScanPathsArray.Add(MakeShareable(new FJsonValueString(ScanPath.ToString())));
+	}
+	JsonObject->SetArrayField(TEXT("ScanPaths"), ScanPathsArray);
+
+	TArray<TSharedPtr<FJsonValue>> PriorityPackagesArray;
+	for (const FName& PackageName : PriorityPackages)
+	{
+		PriorityPackagesArray.Add(MakeShareable(new FJsonValueString(PackageName.ToString())));
+	}
+	JsonObject->SetArrayField(TEXT("PriorityPackages"), PriorityPackagesArray);
+
+	TArray<TSharedPtr<FJsonValue>> PendingPackagesArray;
+	for (const FName& PackageName : PendingPackages)
+	{
+		PendingPackagesArray.Add(MakeShareable(new FJsonValueString(PackageName.ToString())));
+	}
+	JsonObject->SetArrayField(TEXT("PendingPackages"), PendingPackagesArray);
+
+	FString JsonString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+	FJsonSerializer::Serialize(JsonObject, Writer);
+	return FFileHelper::SaveStringToFile(JsonString, *GetManifestFilePath());
+}
+
+bool FResScannerCheckpoint::LoadManifest()
+{
+	FString JsonString;
+	if (!FFileHelper::LoadFileToString(JsonString, *GetManifestFilePath()))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[LoadManifest] Failed to parse %s"), *GetManifestFilePath());
+		return false;
+	}
+
+	int32 Version = 0;
+	if (!JsonObject->TryGetNumberField(TEXT("Version"), Version) || Version != CheckpointVersion)
+	{
+		return false;
+	}
+	RuleSetFingerprint = JsonObject->GetStringField(TEXT("RuleSetFingerprint"));
+	ScanRootPath = JsonObject->GetStringField(TEXT("ScanRootPath"));
+	NextScanPathIndex = JsonObject->GetIntegerField(TEXT("NextScanPathIndex"));
+	ScannedAssetNum = JsonObject->GetIntegerField(TEXT("ScannedAssetNum"));
+	PriorityAssetNum = JsonObject->GetIntegerField(TEXT("PriorityAssetNum"));
+	ResultNum = JsonObject->GetIntegerField(TEXT("ResultNum"));
+
+	ScanPaths.Reset();
+	for (const TSharedPtr<FJsonValue>& PathValue : JsonObject->GetArrayField(TEXT("ScanPaths")))
+	{
+		ScanPaths.Add(FName(*PathValue->AsString()));
+	}
+	PriorityPackages.Reset();
+	for (const TSharedPtr<FJsonValue>& PackageValue : JsonObject->GetArrayField(TEXT("PriorityPackages")))
+	{
+		PriorityPackages.Add(FName(*PackageValue->AsString()));
+	}
+	PendingPackages.Reset();
+	for (const TSharedPtr<FJsonValue>& PackageValue : JsonObject->GetArrayField(TEXT("PendingPackages")))
+	{
+		PendingPackages.Add(FName(*PackageValue->AsString()));
+	}
+	return true;
+}
+
+bool FResScannerCheckpoint::AppendResults(const FResScannerResultStore& Results, int32 FirstIndex, int32& InOutLineNum)
+{
+	if (FirstIndex >= Results.Num())
+	{
+		return true;
+	}
+
+	FString Lines;
+	FScanResultItem Result;
+	for (int32 ViolationIndex = FirstIndex; ViolationIndex < Results.Num(); ++ViolationIndex)
+	{
+		// 每条结果一行，不能有换行，使用紧凑格式
+		FString Line;
+		Results.MakeItem(ViolationIndex, Result);
+		FResScannerResultSink::FormatJsonLine(Result, Line, true);
+		Lines += Line;
+		Lines += TEXT("\n");
+	}
+	if (!FFileHelper::SaveStringToFile(Lines, *GetResultsFilePath(), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM,
+		&IFileManager::Get(), FILEWRITE_Append))
+	{
+		return false;
+	}
+	InOutLineNum += Results.Num() - FirstIndex;
+	return true;
+}
+
+bool FResScannerCheckpoint::LoadResults(FResScannerResultStore& OutResults) const
+{
+	TArray<FString> Lines;
+	if (ResultNum == 0)
+	{
+		// 第一次保存清单前写入的结果都无效
+		IFileManager::Get().Delete(*GetResultsFilePath(), false, false, true);
+		return true;
+	}
+	if (!FFileHelper::LoadFileToStringArray(Lines, *GetResultsFilePath()))
+	{
+		return false;
+	}
+	if (Lines.Num() < ResultNum)
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[LoadResults] Checkpoint results truncated: %d of %d"), Lines.Num(), ResultNum);
+		return false;
+	}
+	if (Lines.Num() > ResultNum)
+	{
+		// 追加结果后、保存清单前中断，多出的行对应的资源会重新评估，不截掉的话继续扫描时追加的结果会接在它们后面
+		UE_LOG(LogResScanner, Log, TEXT("[LoadResults] Discarding %d uncommitted checkpoint results"), Lines.Num() - ResultNum);
+		Lines.SetNum(ResultNum);
+		FString Text = FString::Join(Lines, TEXT("\n"));
+		Text += TEXT("\n");
+		if (!FFileHelper::SaveStringToFile(Text, *GetResultsFilePath(), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+		{
+			return false;
+		}
+	}
+
+	for (int32 LineIndex = 0; LineIndex < ResultNum; ++LineIndex)
+	{
+		TSharedPtr<FJsonObject> ResultJson;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Lines[LineIndex]);
+		if (!FJsonSerializer::Deserialize(Reader, ResultJson) || !ResultJson.IsValid())
+		{
+			return false;
+		}
+		FScanResultItem Result;
+		Result.AssetPath = ResultJson->GetStringField(TEXT("AssetPath"));
+		Result.RuleName = ResultJson->GetStringField(TEXT("RuleName"));
+		Result.ErrorReason = ResultJson->GetStringField(TEXT("ErrorReason"));
+		Result.RuleSetName = ResultJson->GetStringField(TEXT("RuleSetName"));
+		// 检查点和当前扫描的规则集指纹相同，规则下标可以直接使用
+		ResultJson->TryGetNumberField(TEXT("RuleIndex"), Result.RuleIndex);
+		ResultJson->TryGetStringField(TEXT("RuleFingerprint"), Result.RuleFingerprint);
+		FString ViolationKeyString;
+		if (ResultJson->TryGetStringField(TEXT("ViolationKey"), ViolationKeyString))
+		{
+			Result.ViolationKey = FParse::HexNumber64(*ViolationKeyString);
+		}
+		ResultJson->TryGetStringField(TEXT("AssetClass"), Result.AssetClass);
+		OutResults.Add(Result);
+	}
+	return true;
+}
+
+void FResScannerCheckpoint::Delete()
+{
+	IFileManager::Get().Delete(*GetManifestFilePath(), false, false, true);
+	IFileManager::Get().Delete(*GetResultsFilePath(), false, false, true);
+}
@@ -0,0 +1,496 @@
+#include "ResScannerCommandlet.h"
+#include "ResScanner.h"
+#include "ResScannerEngine.h"
+#include "ResScannerRuleBase.h"
+#include "ResScannerShardPlan.h"
+#include "ResScannerChangeScope.h"
+#include "ResScannerHistory.h"
+#include "ResScannerRuleQuery.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/AssetRegistryState.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+
+// 命令行的返回值
+static constexpr int32 CommandletResultNoViolation = 0;
+static constexpr int32 CommandletResultViolation = 1;
+static constexpr int32 CommandletResultError = 2;
+// -Query 的结果在 Display 级别最多显示的资源数量
+static constexpr int32 MaxDisplayedQueryAssetNum = 20;
+// 分片扫描时工作进程的默认期限（分钟）
+static constexpr int32 DefaultShardTimeoutMinutes = 120;
+
+UResScannerCommandlet::UResScannerCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	HelpDescription = TEXT("Scan assets with ResScanner rule sets exported from the editor");
+	HelpUsage = TEXT("-run=ResScanner -RuleSets=A.json+B.json [-Report=Report.json] [-Root=/Game] [-RegistryState=Path.bin] [-IoStore=Path] [-Shards=N [-ShardTimeoutMinutes=N]] [-MemoryBudgetMB=N] [-PackageList=Path.txt] [-GitDiff=Range [-IncludeReferencers]] [-Output=A.sarif+B.csv [-StreamOnly]] [-Baseline=Path.bin] [-WriteBaseline=Path.bin] [-History[=Path.db]] [-Query=\"Art#1 - Art#2;rules>=3\"]");
+}
+
+bool UResScannerCommandlet::LoadRuleSets(const FString& RuleSetsParam, TArray<UResScannerRuleSet*>& OutRuleSets)
+{
+	TArray<FString> RuleSetFiles;
+	RuleSetsParam.ParseIntoArray(RuleSetFiles, TEXT("+"));
+
+	bool bAllLoaded = RuleSetFiles.Num() > 0;
+	for (const FString& RuleSetFile : RuleSetFiles)
+	{
+		UResScannerRuleSet* LoadedRuleSet = FResScannerModule::LoadRuleSetFromFile(FPaths::ConvertRelativePathToFull(RuleSetFile));
+		if (!LoadedRuleSet)
+		{
+			// CI 中规则集写错了不能当作没有违规
+			UE_LOG(LogResScanner, Error, TEXT("[ResScannerCommandlet] Failed to load rule set %s"), *RuleSetFile);
+			bAllLoaded = false;
+			continue;
+		}
+		OutRuleSets.Add(LoadedRuleSet);
+	}
+	return bAllLoaded;
+}
+
+int32 UResScannerCommandlet::Main(const FString& Params)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	FString RuleSetsParam;
+	if (!FParse::Value(*Params, TEXT("RuleSets="), RuleSetsParam, false))
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[ResScannerCommandlet] Usage: %s"), *HelpUsage);
+		return CommandletResultError;
+	}
+	FString ReportPath = FPaths::ProjectSavedDir() / TEXT("ResScanner") / TEXT("Report.json");
+	FParse::Value(*Params, TEXT("Report="), ReportPath);
+	FString RootPathString = TEXT("/Game");
+	FParse::Value(*Params, TEXT("Root="), RootPathString);
+	const FName RootPath(*RootPathString);
+	FString RegistryStatePath;
+	FString IoStorePath;
+	const bool bIoStore = FParse::Value(*Params, TEXT("IoStore="), IoStorePath);
+	const bool bOffline = FParse::Value(*Params, TEXT("RegistryState="), RegistryStatePath) || bIoStore;
+	int32 ShardNum = 0;
+	FParse::Value(*Params, TEXT("Shards="), ShardNum);
+	int32 ShardTimeoutMinutes = DefaultShardTimeoutMinutes;
+	FParse::Value(*Params, TEXT("ShardTimeoutMinutes="), ShardTimeoutMinutes);
+	int32 MemoryBudgetMB = 0;
+	FParse::Value(*Params, TEXT("MemoryBudgetMB="), MemoryBudgetMB);
+	// 不分片时本进程独占预算，没有指定时和分片一样按本机物理内存计算（分片时在 RunShards 中按分片数平分）
+	const uint64 MemoryBudgetBytes = static_cast<uint64>(MemoryBudgetMB > 0 ? MemoryBudgetMB : GetDefaultMemoryBudgetMB(1)) * 1024 * 1024;
+	FString PackageListPath;
+	const bool bPackageList = FParse::Value(*Params, TEXT("PackageList="), PackageListPath);
+	FString GitRevisionRange;
+	const bool bGitDiff = FParse::Value(*Params, TEXT("GitDiff="), GitRevisionRange);
+	// 分片扫描的工作进程不保存统计数据，避免多个进程同时写同一个文件
+	const bool bShardWorker = FParse::Param(*Params, TEXT("ShardWorker"));
+
+	TArray<UResScannerRuleSet*> RuleSets;
+	const bool bRuleSetsLoaded = LoadRuleSets(RuleSetsParam, RuleSets);
+	ON_SCOPE_EXIT
+	{
+		for (UResScannerRuleSet* LoadedRuleSet : RuleSets)
+		{
+			LoadedRuleSet->RemoveFromRoot();
+		}
+	};
+	if (!bRuleSetsLoaded)
+	{
+		return CommandletResultError;
+	}
+
+	FResScannerEngine Engine;
+	Engine.RuleScheduler.LoadStats();
+
+	// 基线中已有的违规不报告
+	FString BaselinePath;
+	if (FParse::Value(*Params, TEXT("Baseline="), BaselinePath) && !Engine.Baseline.Load(FPaths::ConvertRelativePathToFull(BaselinePath)))
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[ResScannerCommandlet] Failed to load baseline %s"), *BaselinePath);
+		return CommandletResultError;
+	}
+	FString WriteBaselinePath;
+	const bool bWriteBaseline = FParse::Value(*Params, TEXT("WriteBaseline="), WriteBaselinePath);
+
+	// 记录到扫描历史，分片扫描的工作进程不记录，由主进程合并结果时记录
+	FString HistoryPath = FResScannerHistory::GetDefaultFilePath();
+	const bool bHistory = !bShardWorker && (FParse::Value(*Params, TEXT("History="), HistoryPath) || FParse::Param(*Params, TEXT("History")));
+	if (bHistory)
+	{
+		Engine.History = MakeShared<FResScannerHistory>();
+		if (!Engine.History->Open(FPaths::ConvertRelativePathToFull(HistoryPath)))
+		{
+			return CommandletResultError;
+		}
+		Engine.History->BeginScan(RootPathString, RuleSetsParam, TEXT("Commandlet"));
+	}
+
+	// 扫描过程中把结果写到输出文件
+	FString OutputParam;
+	if (FParse::Value(*Params, TEXT("Output="), OutputParam, false))
+	{
+		TArray<FString> OutputFiles;
+		OutputParam.ParseIntoArray(OutputFiles, TEXT("+"));
+		for (const FString& OutputFile : OutputFiles)
+		{
+			TUniquePtr<FResScannerResultSink> ResultSink = FResScannerResultSink::Create(FPaths::ConvertRelativePathToFull(OutputFile));
+			if (!ResultSink)
+			{
+				return CommandletResultError;
+			}
+			Engine.ResultSinks.Add(MoveTemp(ResultSink));
+		}
+		// 生成基线需要所有结果
+		Engine.bRetainResults = bWriteBaseline || !FParse::Param(*Params, TEXT("StreamOnly"));
+	}
+	int64 ScannedAssetNum = 0;
+
+	if (bIoStore)
+	{
+		// 检查打包结果：直接读取 IoStore 容器的目录，不需要项目内容
+		Engine.Prepare(RuleSets, true);
+		UE_LOG(LogResScanner, Display, TEXT("[ResScannerCommandlet] %s"), *Engine.RuleScheduler.DescribePlan());
+		if (!Engine.ScanIoStore(IoStorePath, RootPath, ScannedAssetNum))
+		{
+			return CommandletResultError;
+		}
+	}
+	else if (bOffline)
+	{
+		// 离线扫描：不扫描项目内容，只评估注册表文件中的资源
+		FAssetRegistryState RegistryState;
+		if (!FResScannerEngine::LoadRegistryState(FPaths::ConvertRelativePathToFull(RegistryStatePath), RegistryState))
+		{
+			return CommandletResultError;
+		}
+		Engine.Prepare(RuleSets, true);
+		UE_LOG(LogResScanner, Display, TEXT("[ResScannerCommandlet] %s"), *Engine.RuleScheduler.DescribePlan());
+		ScannedAssetNum = Engine.ScanRegistryState(RegistryState, RootPath);
+	}
+	else
+	{
+		// 按 git 变更扫描时先拿到变更的资源包
+		const bool bIncludeReferencers = FParse::Param(*Params, TEXT("IncludeReferencers"));
+		TArray<FName> ChangedPackages;
+		TArray<FString> ChangedFiles;
+		if (bGitDiff && !FResScannerChangeScope::GatherChangedPackages(GitRevisionRange, ChangedPackages, &ChangedFiles))
+		{
+			return CommandletResultError;
+		}
+
+		// 命令行中资源注册表不会自动搜索资源，只同步扫描需要的目录，比 SearchAllAssets 快得多
+		// 按 git 变更扫描并且不需要引用者时只扫描变更的文件，启动耗时也和变更大小有关
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		if (bGitDiff && !bIncludeReferencers)
+		{
+			AssetRegistry.ScanFilesSynchronous(ChangedFiles, true);
+		}
+		else
+		{
+			AssetRegistry.ScanPathsSynchronous({ RootPathString }, true);
+		}
+		UE_LOG(LogResScanner, Display, TEXT("[ResScannerCommandlet] Asset registry ready in %.1f s"), FPlatformTime::Seconds() - StartTime);
+
+		Engine.Prepare(RuleSets);
+		UE_LOG(LogResScanner, Display, TEXT("[ResScannerCommandlet] %s"), *Engine.RuleScheduler.DescribePlan());
+
+		if (bGitDiff)
+		{
+			if (bIncludeReferencers)
+			{
+				FResScannerChangeScope::AddDirectReferencers(ChangedPackages);
+			}
+			// 只扫描根目录下的资源
+			ChangedPackages.RemoveAll([&RootPath](const FName& PackageName)
+			{
+				const FString PackagePath = FPackageName::GetLongPackagePath(PackageName.ToString());
+				return PackagePath != RootPath.ToString() && !PackagePath.StartsWith(RootPath.ToString() + TEXT("/"));
+			});
+			ScannedAssetNum = ScanPackages(Engine, ChangedPackages, MemoryBudgetBytes);
+		}
+		else if (ShardNum > 1)
+		{
+			if (!RunShards(Engine, RuleSetsParam, RootPathString, ShardNum, MemoryBudgetMB, ShardTimeoutMinutes, ScannedAssetNum))
+			{
+				return CommandletResultError;
+			}
+		}
+		else if (bPackageList)
+		{
+			TArray<FString> PackageLines;
+			if (!FFileHelper::LoadFileToStringArray(PackageLines, *PackageListPath))
+			{
+				UE_LOG(LogResScanner, Error, TEXT("[ResScannerCommandlet] Failed to read package list %s"), *PackageListPath);
+				return CommandletResultError;
+			}
+			TArray<FName> PackageNames;
+			for (const FString& PackageLine : PackageLines)
+			{
+				PackageNames.Add(FName(*PackageLine));
+			}
+			ScannedAssetNum = ScanPackages(Engine, PackageNames, MemoryBudgetBytes);
+		}
+		else
+		{
+			TArray<FName> ScanPaths;
+			ScanPaths.Add(RootPath);
+			AssetRegistry.GetSubPaths(RootPath, ScanPaths, true);
+
+			// 命令行中没有 Tick，直接按目录同步扫描
+			TArray<FAssetData> PathAssets;
+			for (int32 PathIndex = 0; PathIndex < ScanPaths.Num(); ++PathIndex)
+			{
+				FResScannerEngine::GatherPathAssets(ScanPaths[PathIndex], nullptr, PathAssets);
+				Engine.EvaluateAssets(PathAssets);
+				ScannedAssetNum += PathAssets.Num();
+				CollectGarbageIfOverBudget(MemoryBudgetBytes);
+				UE_LOG(LogResScanner, Verbose, TEXT("[ResScannerCommandlet] %d/%d %s"), PathIndex + 1, ScanPaths.Num(), *ScanPaths[PathIndex].ToString());
+			}
+		}
+	}
+	if (!bShardWorker)
+	{
+		Engine.RuleScheduler.SaveStats();
+	}
+	Engine.CloseResultSinks();
+	if (Engine.History.IsValid())
+	{
+		// 按 git 变更扫描只覆盖部分资源，不能算作完整扫描
+		Engine.History->EndScan(ScannedAssetNum, !bGitDiff);
+	}
+
+	if (bWriteBaseline)
+	{
+		TArray<uint64> BaselineKeys;
+		Engine.Baseline.GatherAcceptedKeys(Engine.Results, BaselineKeys);
+		if (!FResScannerBaseline::Save(FPaths::ConvertRelativePathToFull(WriteBaselinePath), MoveTemp(BaselineKeys)))
+		{
+			return CommandletResultError;
+		}
+	}
+	if (Engine.Baseline.IsLoaded())
+	{
+		UE_LOG(LogResScanner, Display, TEXT("[ResScannerCommandlet] Baseline: %lld known violations suppressed, %d not seen (fixed or out of scope)"),
+			Engine.Baseline.GetMatchedNum(), Engine.Baseline.GetUnseenNum());
+	}
+
+	FString QueryParam;
+	if (FParse::Value(*Params, TEXT("Query="), QueryParam, false) && !RunRuleQueries(Engine, QueryParam))
+	{
+		return CommandletResultError;
+	}
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogResScanner, Display, TEXT("[ResScannerCommandlet] Scanned %lld assets, %lld results, %.1f s"),
+		ScannedAssetNum, Engine.ResultNum, ElapsedSeconds);
+
+	if (!Engine.WriteReport(ReportPath, RootPathString, bOffline, ScannedAssetNum, ElapsedSeconds))
+	{
+		return CommandletResultError;
+	}
+	return Engine.ResultNum > 0 ? CommandletResultViolation : CommandletResultNoViolation;
+}
+
+bool UResScannerCommandlet::RunRuleQueries(const FResScannerEngine& Engine, const FString& QueryParam)
+{
+	if (!Engine.bRetainResults)
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[ResScannerCommandlet] -Query needs results in memory, ignored with -StreamOnly"));
+		return true;
+	}
+
+	TArray<FString> Expressions;
+	QueryParam.ParseIntoArray(Expressions, TEXT(";"));
+	for (const FString& Expression : Expressions)
+	{
+		const double QueryStartTime = FPlatformTime::Seconds();
+		FResScannerBitmap MatchedAssets;
+		FString QueryError;
+		if (!FResScannerRuleQuery::Evaluate(Engine.Results, Expression, MatchedAssets, QueryError))
+		{
+			UE_LOG(LogResScanner, Error, TEXT("[ResScannerCommandlet] Query \"%s\": %s"), *Expression, *QueryError);
+			return false;
+		}
+		UE_LOG(LogResScanner, Display, TEXT("[ResScannerCommandlet] Query \"%s\": %lld assets, %.0f us"),
+			*Expression, MatchedAssets.Num(), (FPlatformTime::Seconds() - QueryStartTime) * 1000000.0);
+
+		// 前几个资源直接显示，完整列表在 Log 级别
+		int32 LoggedNum = 0;
+		MatchedAssets.ForEach([&Engine, &LoggedNum](uint32 AssetId)
+		{
+			const ELogVerbosity::Type Verbosity = LoggedNum++ < MaxDisplayedQueryAssetNum ? ELogVerbosity::Display : ELogVerbosity::Log;
+			GLog->CategorizedLogf(LogResScanner.GetCategoryName(), Verbosity, TEXT("[ResScannerCommandlet]     %s"), *Engine.Results.GetAssetPath(AssetId));
+		});
+	}
+	return true;
+}
+
+int64 UResScannerCommandlet::ScanPackages(FResScannerEngine& Engine, const TArray<FName>& PackageNames, uint64 MemoryBudgetBytes)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	int64 ScannedAssetNum = 0;
+	TArray<FAssetData> PackageAssets;
+	TArray<FAssetData> AssetChunk;
+	for (const FName& PackageName : PackageNames)
+	{
+		PackageAssets.Reset();
+		AssetRegistry.GetAssetsByPackageName(PackageName, PackageAssets);
+		AssetChunk.Append(PackageAssets);
+		if (AssetChunk.Num() >= FResScannerEngine::ChunkSize)
+		{
+			Engine.EvaluateAssets(AssetChunk);
+			ScannedAssetNum += AssetChunk.Num();
+			AssetChunk.Reset();
+			CollectGarbageIfOverBudget(MemoryBudgetBytes);
+		}
+	}
+	Engine.EvaluateAssets(AssetChunk);
+	ScannedAssetNum += AssetChunk.Num();
+	return ScannedAssetNum;
+}
+
+bool UResScannerCommandlet::RunShards(FResScannerEngine& Engine, const FString& RuleSetsParam, const FString& RootPathString,
+	int32 ShardNum, int32 MemoryBudgetMB, int32 TimeoutMinutes, int64& OutScannedAssetNum)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	const FName RootPath(*RootPathString);
+
+	// 只有至少一条规则作用的资源包才需要分给工作进程
+	TArray<FName> ScanPaths;
+	ScanPaths.Add(RootPath);
+	AssetRegistry.GetSubPaths(RootPath, ScanPaths, true);
+	TSet<FName> InScopePackages;
+	TArray<FAssetData> PathAssets;
+	TArray<int32> AssetRules;
+	for (const FName& ScanPath : ScanPaths)
+	{
+		FResScannerEngine::GatherPathAssets(ScanPath, nullptr, PathAssets);
+		for (const FAssetData& AssetData : PathAssets)
+		{
+			Engine.RuleDispatchIndex.GatherApplicableRules(AssetData, AssetRules);
+			if (AssetRules.Num() > 0)
+			{
+				InScopePackages.Add(AssetData.PackageName);
+			}
+		}
+	}
+
+	FResScannerShardPlan ShardPlan;
+	ShardPlan.Build(InScopePackages.Array(), ShardNum);
+	UE_LOG(LogResScanner, Display, TEXT("[RunShards] %d packages in scope, %d shards"), InScopePackages.Num(), ShardNum);
+
+	// 每个工作进程的内存预算，默认平分本机 3/4 的物理内存
+	if (MemoryBudgetMB <= 0)
+	{
+		MemoryBudgetMB = GetDefaultMemoryBudgetMB(ShardNum);
+	}
+
+	// 工作进程需要绝对路径
+	TArray<FString> RuleSetFiles;
+	RuleSetsParam.ParseIntoArray(RuleSetFiles, TEXT("+"));
+	for (FString& RuleSetFile : RuleSetFiles)
+	{
+		RuleSetFile = FPaths::ConvertRelativePathToFull(RuleSetFile);
+	}
+	const FString AbsoluteRuleSets = FString::Join(RuleSetFiles, TEXT("+"));
+
+	const FString ShardDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("ResScanner") / TEXT("Shards"));
+	IFileManager::Get().MakeDirectory(*ShardDir, true);
+
+	TArray<FProcHandle> Workers;
+	TArray<FString> WorkerReports;
+	for (int32 ShardIndex = 0; ShardIndex < ShardPlan.Shards.Num(); ++ShardIndex)
+	{
+		const TArray<FName>& Shard = ShardPlan.Shards[ShardIndex];
+		if (Shard.Num() == 0)
+		{
+			continue;
+		}
+
+		TArray<FString> PackageLines;
+		PackageLines.Reserve(Shard.Num());
+		for (const FName& PackageName : Shard)
+		{
+			PackageLines.Add(PackageName.ToString());
+		}
+		const FString PackageListPath = ShardDir / FString::Printf(TEXT("Shard_%d.txt"), ShardIndex);
+		const FString WorkerReportPath = ShardDir / FString::Printf(TEXT("Shard_%d.json"), ShardIndex);
+		const FString WorkerLogPath = ShardDir / FString::Printf(TEXT("Shard_%d.log"), ShardIndex);
+		FFileHelper::SaveStringArrayToFile(PackageLines, *PackageListPath);
+		IFileManager::Get().Delete(*WorkerReportPath, false, false, true);
+
+		const FString WorkerParams = FString::Printf(
+			TEXT("\"%s\" -run=ResScanner -RuleSets=\"%s\" -Root=\"%s\" -PackageList=\"%s\" -Report=\"%s\" -MemoryBudgetMB=%d -ShardWorker ")
+			TEXT("-abslog=\"%s\" -nullrhi -nosplash -nosound -unattended -nopause -NoShaderCompile"),
+			*FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()), *AbsoluteRuleSets, *RootPathString,
+			*PackageListPath, *WorkerReportPath, MemoryBudgetMB, *WorkerLogPath);
+		FProcHandle Worker = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *WorkerParams,
+			false, true, true, nullptr, 0, nullptr, nullptr);
+		if (!Worker.IsValid())
+		{
+			UE_LOG(LogResScanner, Error, TEXT("[RunShards] Failed to launch worker %d"), ShardIndex);
+			for (FProcHandle& LaunchedWorker : Workers)
+			{
+				FPlatformProcess::TerminateProc(LaunchedWorker);
+				FPlatformProcess::CloseProc(LaunchedWorker);
+			}
+			return false;
+		}
+		UE_LOG(LogResScanner, Display, TEXT("[RunShards] Worker %d: %d packages, log %s"), ShardIndex, Shard.Num(), *WorkerLogPath);
+		Workers.Add(Worker);
+		WorkerReports.Add(WorkerReportPath);
+	}
+
+	// 工作进程卡住（弹出模态对话框、编译着色器）时不能一直等下去，所有工作进程同时启动，共用一个期限
+	// 超过期限的工作进程连同它的子进程一起结束，这个分片算作失败
+	const double Deadline = FPlatformTime::Seconds() + TimeoutMinutes * 60.0;
+	bool bAllSucceeded = true;
+	for (int32 WorkerIndex = 0; WorkerIndex < Workers.Num(); ++WorkerIndex)
+	{
+		while (FPlatformProcess::IsProcRunning(Workers[WorkerIndex]) && (TimeoutMinutes <= 0 || FPlatformTime::Seconds() < Deadline))
+		{
+			FPlatformProcess::Sleep(1.0f);
+		}
+		if (FPlatformProcess::IsProcRunning(Workers[WorkerIndex]))
+		{
+			UE_LOG(LogResScanner, Error, TEXT("[RunShards] Worker for %s did not finish in %d minutes, terminated"), *WorkerReports[WorkerIndex], TimeoutMinutes);
+			FPlatformProcess::TerminateProc(Workers[WorkerIndex], true);
+			FPlatformProcess::CloseProc(Workers[WorkerIndex]);
+			bAllSucceeded = false;
+			continue;
+		}
+		int32 ReturnCode = CommandletResultError;
+		FPlatformProcess::GetProcReturnCode(Workers[WorkerIndex], &ReturnCode);
+		FPlatformProcess::CloseProc(Workers[WorkerIndex]);
+
+		int64 WorkerScannedAssetNum = 0;
+		if (ReturnCode == CommandletResultError || !Engine.ReadReport(WorkerReports[WorkerIndex], WorkerScannedAssetNum))
+		{
+			UE_LOG(LogResScanner, Error, TEXT("[RunShards] Worker for %s failed with code %d"), *WorkerReports[WorkerIndex], ReturnCode);
+			bAllSucceeded = false;
+			continue;
+		}
+		OutScannedAssetNum += WorkerScannedAssetNum;
+	}
+	return bAllSucceeded;
+}
+
+int32 UResScannerCommandlet::GetDefaultMemoryBudgetMB(int32 ProcessNum)
+{
+	const uint64 TotalPhysicalMB = FPlatformMemory::GetConstants().TotalPhysical / (1024 * 1024);
+	return static_cast<int32>(TotalPhysicalMB * 3 / 4 / FMath::Max(1, ProcessNum));
+}
+
+void UResScannerCommandlet::CollectGarbageIfOverBudget(uint64 MemoryBudgetBytes)
+{
+	if (MemoryBudgetBytes > 0 && FPlatformMemory::GetStats().UsedPhysical > MemoryBudgetBytes)
+	{
+		UE_LOG(LogResScanner, Display, TEXT("[ResScannerCommandlet] Memory over budget (%llu MB), collecting garbage"),
+			FPlatformMemory::GetStats().UsedPhysical / (1024 * 1024));
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+}
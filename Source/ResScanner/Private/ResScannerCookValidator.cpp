@@ -0,0 +1,132 @@
+#include "ResScannerCookValidator.h"
+#include "ResScanner.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/ICookInfo.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+
+// 打包时检查的资源根目录，和编辑器扫描一致
+static const FString CookValidateRootPath(TEXT("/Game"));
+
+TUniquePtr<FResScannerCookValidator> FResScannerCookValidator::CreateFromCommandLine()
+{
+	FString RuleSetsParam;
+	if (!IsRunningCookCommandlet() || !FParse::Value(FCommandLine::Get(), TEXT("ResScannerRuleSets="), RuleSetsParam, false))
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<FResScannerCookValidator> Validator(new FResScannerCookValidator());
+	TArray<FString> RuleSetFiles;
+	RuleSetsParam.ParseIntoArray(RuleSetFiles, TEXT("+"));
+	for (const FString& RuleSetFile : RuleSetFiles)
+	{
+		if (UResScannerRuleSet* LoadedRuleSet = FResScannerModule::LoadRuleSetFromFile(FPaths::ConvertRelativePathToFull(RuleSetFile)))
+		{
+			Validator->RuleSets.Add(LoadedRuleSet);
+		}
+		else
+		{
+			UE_LOG(LogResScanner, Error, TEXT("[CookValidator] Failed to load rule set %s"), *RuleSetFile);
+		}
+	}
+	if (Validator->RuleSets.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	Validator->ReportPath = FPaths::ProjectSavedDir() / TEXT("ResScanner") / TEXT("CookReport.json");
+	FParse::Value(FCommandLine::Get(), TEXT("ResScannerReport="), Validator->ReportPath);
+	Validator->bFailOnViolation = FParse::Param(FCommandLine::Get(), TEXT("ResScannerFailOnViolation"));
+
+	Validator->Engine.RuleScheduler.LoadStats();
+	Validator->Engine.Prepare(Validator->RuleSets);
+
+	FResScannerCookValidator* RawValidator = Validator.Get();
+	Validator->PreSavePackageHandle = UPackage::PreSavePackageWithContextEvent.AddRaw(RawValidator, &FResScannerCookValidator::OnPreSavePackage);
+	// Cook 结束时（Cook 命令行返回退出码之前）写报告并输出 Error 日志，-ResScannerFailOnViolation 才能让 Cook 失败
+	Validator->CookFinishedHandle = UE::Cook::FDelegates::CookByTheBookFinished.AddRaw(RawValidator, &FResScannerCookValidator::OnCookFinished);
+	// Cook 中途退出时不会广播 Cook 结束，模块关闭时 UObject 可能已经销毁，在引擎退出前写报告
+	Validator->PreExitHandle = FCoreDelegates::OnEnginePreExit.AddRaw(RawValidator, &FResScannerCookValidator::Finish);
+
+	UE_LOG(LogResScanner, Display, TEXT("[CookValidator] Validating cooked packages with %d rule sets, report %s"),
+		Validator->RuleSets.Num(), *Validator->ReportPath);
+	return Validator;
+}
+
+FResScannerCookValidator::~FResScannerCookValidator()
+{
+	Finish();
+	UPackage::PreSavePackageWithContextEvent.Remove(PreSavePackageHandle);
+	UE::Cook::FDelegates::CookByTheBookFinished.Remove(CookFinishedHandle);
+	FCoreDelegates::OnEnginePreExit.Remove(PreExitHandle);
+	if (UObjectInitialized())
+	{
+		for (UResScannerRuleSet* LoadedRuleSet : RuleSets)
+		{
+			LoadedRuleSet->RemoveFromRoot();
+		}
+	}
+}
+
+void FResScannerCookValidator::OnPreSavePackage(UPackage* Package, FObjectPreSaveContext ObjectSaveContext)
+{
+	if (bFinished || !Package || !ObjectSaveContext.IsCooking())
+	{
+		return;
+	}
+	const FName PackageName = Package->GetFName();
+	const FString PackagePath = FPackageName::GetLongPackagePath(PackageName.ToString());
+	if (PackagePath != CookValidateRootPath && !PackagePath.StartsWith(CookValidateRootPath + TEXT("/")))
+	{
+		return;
+	}
+	bool bAlreadyValidated = false;
+	ValidatedPackages.Add(PackageName, &bAlreadyValidated);
+	if (bAlreadyValidated)
+	{
+		return;
+	}
+
+	// 直接从内存中的对象构造 FAssetData，规则中 GetAsset 取到的就是 Cook 已经加载的对象，不会再加载
+	TArray<FAssetData> PackageAssets;
+	FResScannerEngine::GatherResidentAssets(Package, PackageAssets);
+
+	const double StartTime = FPlatformTime::Seconds();
+	Engine.EvaluateAssets(PackageAssets);
+	EvaluateSeconds += FPlatformTime::Seconds() - StartTime;
+	ScannedAssetNum += PackageAssets.Num();
+}
+
+void FResScannerCookValidator::OnCookFinished(UE::Cook::ICookInfo& CookInfo)
+{
+	Finish();
+}
+
+void FResScannerCookValidator::Finish()
+{
+	if (bFinished)
+	{
+		return;
+	}
+	bFinished = true;
+
+	UE_LOG(LogResScanner, Display, TEXT("[CookValidator] Validated %d packages (%lld assets) in %.1f s, %lld results"),
+		ValidatedPackages.Num(), ScannedAssetNum, EvaluateSeconds, Engine.ResultNum);
+	Engine.WriteReport(ReportPath, CookValidateRootPath, false, ScannedAssetNum, EvaluateSeconds);
+
+	if (Engine.ResultNum > 0)
+	{
+		// 打包流程一般会把 Error 日志当作失败
+		if (bFailOnViolation)
+		{
+			UE_LOG(LogResScanner, Error, TEXT("[CookValidator] %lld rule violations in cooked content, see %s"), Engine.ResultNum, *ReportPath);
+		}
+		else
+		{
+			UE_LOG(LogResScanner, Warning, TEXT("[CookValidator] %lld rule violations in cooked content, see %s"), Engine.ResultNum, *ReportPath);
+		}
+	}
+}
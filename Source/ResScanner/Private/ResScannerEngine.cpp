@@ -0,0 +1,560 @@
+#include "ResScannerEngine.h"
+#include "ResScannerRuleBase.h"
+#include "ResScannerIoStore.h"
+#include "ResScannerHistory.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/AssetRegistryState.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Serialization/LargeMemoryReader.h"
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+DEFINE_LOG_CATEGORY(LogResScanner)
+
+void FResScannerEngine::Prepare(const TArray<UResScannerRuleSet*>& InRuleSets, bool bRegistryOnly)
+{
+	Prepare(InRuleSets, [bRegistryOnly](const UResScannerRuleBase* Rule) { return bRegistryOnly && !FResScannerCompiledRules::CanEvaluateRegistryOnly(Rule); });
+	for (const FResScannerSkippedRule& SkippedRule : CompiledRules.SkippedRules)
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[Prepare] %s#%d (%s) %s, skipped in registry-only scan"),
+			*SkippedRule.RuleSetName, SkippedRule.RuleSetPosition, *SkippedRule.Rule->GetClass()->GetName(), SkippedRule.GetReason());
+	}
+}
+
+void FResScannerEngine::Prepare(const TArray<UResScannerRuleSet*>& InRuleSets, TFunctionRef<bool(const UResScannerRuleBase*)> ShouldSkipRule)
+{
+	// 所有规则集合并成一个扁平的规则数组，一次遍历评估所有规则集
+	CompiledRules.Compile(InRuleSets, ShouldSkipRule);
+	RuleFingerprints.Reset(CompiledRules.Rules.Num());
+	TArray<FString> RuleSetNames;
+	RuleSetNames.Reserve(CompiledRules.Rules.Num());
+	for (int32 RuleIndex = 0; RuleIndex < CompiledRules.Rules.Num(); ++RuleIndex)
+	{
+		RuleFingerprints.Add(CompiledRules.Rules[RuleIndex]->GetRuleFingerprint());
+		RuleSetNames.Add(CompiledRules.GetRuleSetName(RuleIndex));
+	}
+	// 结果中的规则编号就是 CompiledRules.Rules 的下标，规则变化后旧结果没有意义
+	ResetResults();
+	Results.SetRules(CompiledRules.Rules, RuleSetNames, CompiledRules.RuleSetPositions, RuleFingerprints);
+	// 把规则编译成分发索引，评估时每个资源只需要测试相关的规则
+	RuleDispatchIndex.Build(CompiledRules.Rules);
+	// 根据历史统计数据生成执行计划
+	RuleScheduler.BuildPlan(CompiledRules, RuleFingerprints);
+}
+
+void FResScannerEngine::GatherPathAssets(FName PackagePath, const TSet<FName>* SkipPackages, TArray<FAssetData>& OutAssets)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter Filter;
+	Filter.PackagePaths.Add(PackagePath);
+	Filter.bRecursivePaths = false;			// 子目录由调用方单独扫描
+	Filter.bIncludeOnlyOnDiskAssets = true;
+
+	// 注意：EnumerateAssets 的回调是在持有注册表锁的情况下执行的，回调里不能加载资源（属性规则会加载资源）
+	// 所以回调里只做拷贝，枚举结束后再在回调外分批评估
+	OutAssets.Reset();
+	AssetRegistry.EnumerateAssets(Filter, [SkipPackages, &OutAssets](const FAssetData& AssetData)
+	{
+		if (!SkipPackages || !SkipPackages->Contains(AssetData.PackageName))
+		{
+			OutAssets.Add(AssetData);
+		}
+		return true;
+	});
+}
+
+void FResScannerEngine::GatherResidentAssets(UPackage* Package, TArray<FAssetData>& OutAssets)
+{
+	OutAssets.Reset();
+	ForEachObjectWithPackage(Package, [&OutAssets](UObject* Object)
+	{
+		if (Object->IsAsset())
+		{
+			OutAssets.Emplace(Object);
+		}
+		return true;
+	}, false);
+}
+
+void FResScannerEngine::EvaluateAssets(TArrayView<const FAssetData> Assets)
+{
+	for (int32 ChunkStart = 0; ChunkStart < Assets.Num(); ChunkStart += ChunkSize)
+	{
+		const int32 ChunkNum = FMath::Min(ChunkSize, Assets.Num() - ChunkStart);
+		EvaluateAssetChunk(Assets.Slice(ChunkStart, ChunkNum));
+	}
+}
+
+bool FResScannerEngine::LoadRegistryState(const FString& FilePath, FAssetRegistryState& OutState)
+{
+	// 几百 MB 的注册表文件不需要先完整读到一块内存中再解析，直接映射到地址空间，由系统按需分页
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (!MappedFile)
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[LoadRegistryState] Failed to map %s"), *FilePath);
+		return false;
+	}
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion)
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[LoadRegistryState] Failed to map region of %s"), *FilePath);
+		return false;
+	}
+
+	FLargeMemoryReader Reader(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+	if (!OutState.Load(Reader) || Reader.IsError())
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[LoadRegistryState] Failed to load asset registry state from %s"), *FilePath);
+		return false;
+	}
+	UE_LOG(LogResScanner, Display, TEXT("[LoadRegistryState] Loaded %d assets from %s"), OutState.GetNumAssets(), *FilePath);
+	return true;
+}
+
+int64 FResScannerEngine::ScanRegistryState(const FAssetRegistryState& State, FName RootPath)
+{
+	const FString RootPrefix = RootPath.ToString() + TEXT("/");
+	int64 ScannedAssetNum = 0;
+
+	// 注册表状态归我们自己所有，没有锁的问题，攒够一批就直接评估
+	TArray<FAssetData> AssetChunk;
+	AssetChunk.Reserve(ChunkSize);
+	State.EnumerateAllAssets(TSet<FName>(), [&](const FAssetData& AssetData)
+	{
+		if (AssetData.PackagePath != RootPath && !AssetData.PackagePath.ToString().StartsWith(RootPrefix))
+		{
+			return true;
+		}
+		AssetChunk.Add(AssetData);
+		if (AssetChunk.Num() >= ChunkSize)
+		{
+			EvaluateAssetChunk(AssetChunk);
+			ScannedAssetNum += AssetChunk.Num();
+			AssetChunk.Reset();
+		}
+		return true;
+	});
+	EvaluateAssetChunk(AssetChunk);
+	ScannedAssetNum += AssetChunk.Num();
+	return ScannedAssetNum;
+}
+
+bool FResScannerEngine::ScanIoStore(const FString& Path, FName RootPath, int64& OutScannedAssetNum)
+{
+	TArray<FString> TocPaths;
+	FResScannerIoStore::FindContainers(Path, TocPaths);
+	if (TocPaths.Num() == 0)
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[ScanIoStore] No .utoc found in %s"), *Path);
+		return false;
+	}
+
+	const FString RootPrefix = RootPath.ToString() + TEXT("/");
+	bool bAllRead = true;
+	TArray<FAssetData> ContainerAssets;
+	for (const FString& TocPath : TocPaths)
+	{
+		ContainerAssets.Reset();
+		if (!FResScannerIoStore::GatherContainerAssets(TocPath, ContainerAssets))
+		{
+			bAllRead = false;
+			continue;
+		}
+		ContainerAssets.RemoveAll([&RootPath, &RootPrefix](const FAssetData& AssetData)
+		{
+			return AssetData.PackagePath != RootPath && !AssetData.PackagePath.ToString().StartsWith(RootPrefix);
+		});
+		EvaluateAssets(ContainerAssets);
+		OutScannedAssetNum += ContainerAssets.Num();
+	}
+	return bAllRead;
+}
+
+bool FResScannerEngine::ReadReport(const FString& ReportPath, int64& OutScannedAssetNum)
+{
+	FString ReportString;
+	if (!FFileHelper::LoadFileToString(ReportString, *ReportPath))
+	{
+		return false;
+	}
+	TSharedPtr<FJsonObject> ReportJson;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ReportString);
+	if (!FJsonSerializer::Deserialize(Reader, ReportJson) || !ReportJson.IsValid())
+	{
+		return false;
+	}
+
+	double ScannedAssetNum = 0.0;
+	ReportJson->TryGetNumberField(TEXT("ScannedAssetNum"), ScannedAssetNum);
+	OutScannedAssetNum = static_cast<int64>(ScannedAssetNum);
+	for (const TSharedPtr<FJsonValue>& ResultValue : ReportJson->GetArrayField(TEXT("Results")))
+	{
+		const TSharedPtr<FJsonObject>& ResultJson = ResultValue->AsObject();
+		FScanResultItem Result;
+		Result.AssetPath = ResultJson->GetStringField(TEXT("AssetPath"));
+		Result.RuleName = ResultJson->GetStringField(TEXT("RuleName"));
+		Result.ErrorReason = ResultJson->GetStringField(TEXT("ErrorReason"));
+		Result.RuleSetName = ResultJson->GetStringField(TEXT("RuleSetName"));
+		// 分片工作进程和合并进程使用同一组规则集，规则下标和指纹都一致
+		if (!ResultJson->TryGetNumberField(TEXT("RuleIndex"), Result.RuleIndex))
+		{
+			Result.RuleIndex = INDEX_NONE;
+		}
+		ResultJson->TryGetStringField(TEXT("RuleFingerprint"), Result.RuleFingerprint);
+		FString ViolationKeyString;
+		if (ResultJson->TryGetStringField(TEXT("ViolationKey"), ViolationKeyString))
+		{
+			Result.ViolationKey = FParse::HexNumber64(*ViolationKeyString);
+		}
+		ResultJson->TryGetStringField(TEXT("AssetClass"), Result.AssetClass);
+		AddResult(Result);
+	}
+	return true;
+}
+
+bool FResScannerEngine::WriteReport(const FString& ReportPath, const FString& RootPathString, bool bOffline, int64 ScannedAssetNum, double ElapsedSeconds) const
+{
+	// 机器可读的报告
+	FString ReportString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("Root"), RootPathString);
+	Writer->WriteArrayStart(TEXT("RuleSets"));
+	for (const UResScannerRuleSet* ScanRuleSet : CompiledRules.RuleSets)
+	{
+		Writer->WriteValue(ScanRuleSet->RuleSetName);
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteValue(TEXT("Offline"), bOffline);
+	// 离线扫描时跳过的规则，CI 需要知道哪些规则没有检查；属性规则的类名都相同，用 RuleSet#N 和指纹区分
+	Writer->WriteArrayStart(TEXT("SkippedRules"));
+	for (const FResScannerSkippedRule& SkippedRule : CompiledRules.SkippedRules)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("Rule"), FString::Printf(TEXT("%s#%d"), *SkippedRule.RuleSetName, SkippedRule.RuleSetPosition));
+		Writer->WriteValue(TEXT("RuleName"), SkippedRule.Rule->GetClass()->GetName());
+		Writer->WriteValue(TEXT("RuleSetName"), SkippedRule.RuleSetName);
+		Writer->WriteValue(TEXT("RuleSetPosition"), SkippedRule.RuleSetPosition);
+		Writer->WriteValue(TEXT("RuleFingerprint"), SkippedRule.Rule->GetRuleFingerprint());
+		Writer->WriteValue(TEXT("Reason"), SkippedRule.GetReason());
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteValue(TEXT("ScannedAssetNum"), ScannedAssetNum);
+	Writer->WriteValue(TEXT("ElapsedSeconds"), ElapsedSeconds);
+	Writer->WriteValue(TEXT("ResultNum"), ResultNum);
+	if (Baseline.IsLoaded())
+	{
+		// 基线中已经存在的违规不在 Results 中，没有出现的违规已经修复或者不在扫描范围内
+		Writer->WriteValue(TEXT("BaselineMatchedNum"), Baseline.GetMatchedNum());
+		Writer->WriteValue(TEXT("BaselineUnseenNum"), Baseline.GetUnseenNum());
+	}
+	Writer->WriteArrayStart(TEXT("Results"));
+	FScanResultItem Result;
+	for (int32 ViolationIndex = 0; ViolationIndex < Results.Num(); ++ViolationIndex)
+	{
+		Results.MakeItem(ViolationIndex, Result);
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("AssetPath"), Result.AssetPath);
+		Writer->WriteValue(TEXT("RuleName"), Result.RuleName);
+		Writer->WriteValue(TEXT("ErrorReason"), Result.ErrorReason);
+		Writer->WriteValue(TEXT("RuleSetName"), Result.RuleSetName);
+		Writer->WriteValue(TEXT("RuleIndex"), Result.RuleIndex);
+		Writer->WriteValue(TEXT("RuleFingerprint"), Result.RuleFingerprint);
+		Writer->WriteValue(TEXT("ViolationKey"), FString::Printf(TEXT("%016llx"), Result.ViolationKey));
+		Writer->WriteValue(TEXT("AssetClass"), Result.AssetClass);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(ReportPath), true);
+	if (!FFileHelper::SaveStringToFile(ReportString, *ReportPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[WriteReport] Failed to write report %s"), *ReportPath);
+		return false;
+	}
+	UE_LOG(LogResScanner, Display, TEXT("[WriteReport] Report written to %s"), *ReportPath);
+	return true;
+}
+
+// 单个 (资源, 规则) 的评估状态
+enum class EResScanSlotState : uint8
+{
+	NotEvaluated,
+	Passed,
+	Violated
+};
+
+// 评估一批资源
+void FResScannerEngine::EvaluateAssetChunk(TArrayView<const FAssetData> AssetChunk, TArray<int32>* OutRuleReportedNum)
+{
+	const TArray<UResScannerRuleBase*>& Rules = CompiledRules.Rules;
+	const int32 RuleNum = Rules.Num();
+	const int32 RuleSetNum = CompiledRules.RuleSets.Num();
+	if (RuleNum == 0 || AssetChunk.Num() == 0)
+	{
+		return;
+	}
+
+	// 组合逻辑是按规则集计算的，出现这个状态就能确定资源在该规则集下的结果，该规则集剩下的规则不用再评估
+	auto IsDecisive = [this](int32 RuleIndex, EResScanSlotState State)
+	{
+		const ERuleSetLogic Logic = CompiledRules.GetRuleLogic(RuleIndex);
+		return (Logic == ERuleSetLogic::AnyViolation && State == EResScanSlotState::Violated)
+			|| (Logic == ERuleSetLogic::AllViolation && State == EResScanSlotState::Passed);
+	};
+
+	// 标记哪些规则可以并行
+	TBitArray<> ParallelRules(false, RuleNum);
+	for (int32 RuleIndex = 0; RuleIndex < RuleNum; ++RuleIndex)
+	{
+		ParallelRules[RuleIndex] = Rules[RuleIndex]->CanMatchOffGameThread();
+	}
+
+	// 通过分发索引获取每个资源需要测试的规则，并按执行计划排序，所有资源的规则下标连续存放
+	// 第 i 个资源的规则为 ApplicableRules[RuleOffsets[i], RuleOffsets[i + 1])
+	TArray<int32> ApplicableRules;
+	TArray<int32> RuleOffsets;
+	RuleOffsets.Reserve(AssetChunk.Num() + 1);
+	TArray<int32> AssetRules;
+	for (const FAssetData& AssetData : AssetChunk)
+	{
+		RuleOffsets.Add(ApplicableRules.Num());
+		RuleDispatchIndex.GatherApplicableRules(AssetData, AssetRules);
+		AssetRules.Sort([this](int32 A, int32 B)
+		{
+			return RuleScheduler.GetPlanRank(A) < RuleScheduler.GetPlanRank(B);
+		});
+		ApplicableRules.Append(AssetRules);
+	}
+	RuleOffsets.Add(ApplicableRules.Num());
+
+	// 每个 (资源, 相关规则) 的评估状态和耗时，和 ApplicableRules 一一对应
+	// 每个工作线程只写自己负责的资源对应的元素，不需要加锁
+	TArray<EResScanSlotState> SlotStates;
+	SlotStates.SetNumZeroed(ApplicableRules.Num());
+	TArray<uint64> SlotCycles;
+	SlotCycles.SetNumZeroed(ApplicableRules.Num());
+
+	auto EvaluateSlot = [&](int32 AssetIndex, int32 Slot, bool bOffGameThread)
+	{
+		UResScannerRuleBase* Rule = Rules[ApplicableRules[Slot]];
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		// 工作线程中直接调用 _Implementation，不走 ProcessEvent
+		bool bMatch = bOffGameThread ? Rule->Match_Implementation(AssetChunk[AssetIndex]) : Rule->Match(AssetChunk[AssetIndex]);
+		SlotCycles[Slot] = FPlatformTime::Cycles64() - StartCycles;
+		if (Rule->bReverseCheck) bMatch = !bMatch;
+		SlotStates[Slot] = bMatch ? EResScanSlotState::Violated : EResScanSlotState::Passed;
+	};
+
+	// 第一步：只依赖注册表数据的规则在工作线程中并行评估，规则集的结果确定后跳过该规则集的剩余规则
+	ParallelFor(AssetChunk.Num(), [&](int32 AssetIndex)
+	{
+		TArray<bool, TInlineAllocator<8>> RuleSetDetermined;
+		RuleSetDetermined.SetNumZeroed(RuleSetNum);
+		for (int32 Slot = RuleOffsets[AssetIndex]; Slot < RuleOffsets[AssetIndex + 1]; ++Slot)
+		{
+			const int32 RuleIndex = ApplicableRules[Slot];
+			const int32 RuleSetIndex = CompiledRules.GetRuleSetIndex(RuleIndex);
+			if (!ParallelRules[RuleIndex] || RuleSetDetermined[RuleSetIndex]) continue;
+			EvaluateSlot(AssetIndex, Slot, true);
+			RuleSetDetermined[RuleSetIndex] = IsDecisive(RuleIndex, SlotStates[Slot]);
+		}
+	});
+
+	// 第二步：需要加载资源或者被蓝图覆盖的规则按执行计划在 GameThread 中评估
+	// 同一个资源的所有规则集连续评估，资源只加载一次，后面的规则直接使用内存中的对象
+	// 如果第一步已经确定了某个规则集的结果，该规则集就不会再触发加载
+	TArray<bool, TInlineAllocator<8>> RuleSetDetermined;
+	for (int32 AssetIndex = 0; AssetIndex < AssetChunk.Num(); ++AssetIndex)
+	{
+		RuleSetDetermined.Reset();
+		RuleSetDetermined.SetNumZeroed(RuleSetNum);
+		for (int32 Slot = RuleOffsets[AssetIndex]; Slot < RuleOffsets[AssetIndex + 1]; ++Slot)
+		{
+			const int32 RuleIndex = ApplicableRules[Slot];
+			RuleSetDetermined[CompiledRules.GetRuleSetIndex(RuleIndex)] |= IsDecisive(RuleIndex, SlotStates[Slot]);
+		}
+		for (int32 Slot = RuleOffsets[AssetIndex]; Slot < RuleOffsets[AssetIndex + 1]; ++Slot)
+		{
+			const int32 RuleIndex = ApplicableRules[Slot];
+			const int32 RuleSetIndex = CompiledRules.GetRuleSetIndex(RuleIndex);
+			if (ParallelRules[RuleIndex] || RuleSetDetermined[RuleSetIndex] || SlotStates[Slot] != EResScanSlotState::NotEvaluated) continue;
+			EvaluateSlot(AssetIndex, Slot, false);
+			RuleSetDetermined[RuleSetIndex] = IsDecisive(RuleIndex, SlotStates[Slot]);
+		}
+	}
+
+	// 第三步：按 资源、执行计划 的顺序输出结果，同时统计每条规则的耗时和违规数
+	TArray<uint64> RuleCycles;
+	RuleCycles.SetNumZeroed(RuleNum);
+	TArray<int64> RuleEvaluatedNum;
+	RuleEvaluatedNum.SetNumZeroed(RuleNum);
+	TArray<int64> RuleViolationNum;
+	RuleViolationNum.SetNumZeroed(RuleNum);
+	for (int32 AssetIndex = 0; AssetIndex < AssetChunk.Num(); ++AssetIndex)
+	{
+		const FAssetData& AssetData = AssetChunk[AssetIndex];
+		const int32 SlotBegin = RuleOffsets[AssetIndex];
+		const int32 SlotEnd = RuleOffsets[AssetIndex + 1];
+
+		// AllViolation 的规则集只有所有相关规则都违规才报告
+		TArray<bool, TInlineAllocator<8>> ReportRuleSet;
+		ReportRuleSet.Init(true, RuleSetNum);
+		for (int32 Slot = SlotBegin; Slot < SlotEnd; ++Slot)
+		{
+			const int32 RuleIndex = ApplicableRules[Slot];
+			if (CompiledRules.GetRuleLogic(RuleIndex) == ERuleSetLogic::AllViolation)
+			{
+				ReportRuleSet[CompiledRules.GetRuleSetIndex(RuleIndex)] &= SlotStates[Slot] == EResScanSlotState::Violated;
+			}
+		}
+
+		for (int32 Slot = SlotBegin; Slot < SlotEnd; ++Slot)
+		{
+			if (SlotStates[Slot] == EResScanSlotState::NotEvaluated) continue;
+
+			const int32 RuleIndex = ApplicableRules[Slot];
+			const bool bViolated = SlotStates[Slot] == EResScanSlotState::Violated;
+			RuleCycles[RuleIndex] += SlotCycles[Slot];
+			RuleEvaluatedNum[RuleIndex]++;
+			RuleViolationNum[RuleIndex] += bViolated ? 1 : 0;
+
+			if (bViolated && ReportRuleSet[CompiledRules.GetRuleSetIndex(RuleIndex)])
+			{
+				AddViolation(AssetData, RuleIndex);
+				if (OutRuleReportedNum)
+				{
+					(*OutRuleReportedNum)[RuleIndex]++;
+				}
+			}
+		}
+	}
+
+	for (int32 RuleIndex = 0; RuleIndex < RuleNum; ++RuleIndex)
+	{
+		if (RuleEvaluatedNum[RuleIndex] > 0)
+		{
+			RuleScheduler.AccumulateStats(RuleIndex, FPlatformTime::ToSeconds64(RuleCycles[RuleIndex]),
+				RuleEvaluatedNum[RuleIndex], RuleViolationNum[RuleIndex]);
+		}
+	}
+
+	for (const TUniquePtr<FResScannerResultSink>& ResultSink : ResultSinks)
+	{
+		ResultSink->Flush();
+	}
+}
+
+void FResScannerEngine::AddViolation(const FAssetData& AssetData, int32 RuleIndex)
+{
+	// 同一个资源同一条规则重复评估（检查点恢复、重新扫描修改过的资源）时，历史和输出都不能重复记录
+	if (bRetainResults)
+	{
+		const int32 AssetId = Results.FindAsset(AssetData.PackageName, AssetData.AssetName);
+		if (AssetId != INDEX_NONE && Results.HasViolation(AssetId, RuleIndex))
+		{
+			return;
+		}
+	}
+
+	// 错误原因每条规则只取一次，缓存在结果存储的规则表中
+	const FString& ErrorReason = Results.GetRuleErrorReason(RuleIndex);
+	const FString AssetPath = AssetData.GetObjectPathString();
+	const uint64 ViolationKey = FResScannerBaseline::MakeViolationKey(AssetPath, RuleFingerprints[RuleIndex], ErrorReason);
+
+	// 只保存在内存中时不需要展开
+	FScanResultItem Result;
+	if (History || ResultSinks.Num() > 0)
+	{
+		Result.AssetPath = AssetPath;
+		Result.RuleName = Results.GetRuleName(RuleIndex);
+		Result.ErrorReason = ErrorReason;
+		Result.RuleSetName = Results.GetRuleSetName(RuleIndex);
+		Result.RuleIndex = RuleIndex;
+		Result.RuleFingerprint = RuleFingerprints[RuleIndex];
+		Result.ViolationKey = ViolationKey;
+		Result.AssetClass = AssetData.AssetClassPath.ToString();
+	}
+
+	// 和 AddResult 的顺序一致，历史按违规键去重，基线中的重复违规也只记录一次
+	if (History)
+	{
+		History->AddViolation(Result, RuleFingerprints[RuleIndex]);
+	}
+	if (Baseline.IsLoaded() && Baseline.MatchAndMark(ViolationKey))
+	{
+		return;
+	}
+	if (bRetainResults)
+	{
+		Results.Add(AssetData, RuleIndex, ViolationKey);
+	}
+	else if (IsStreamedDuplicate(ViolationKey))
+	{
+		return;
+	}
+	++ResultNum;
+	for (const TUniquePtr<FResScannerResultSink>& ResultSink : ResultSinks)
+	{
+		ResultSink->WriteResult(Result);
+	}
+}
+
+void FResScannerEngine::AddResult(const FScanResultItem& Result)
+{
+	// 历史记录的是内容的健康程度，基线中的违规也要记录；报告合并时的重复结果由历史按违规键去掉
+	if (History)
+	{
+		History->AddViolation(Result, Result.RuleFingerprint);
+	}
+	if (Baseline.IsLoaded() && Baseline.MatchAndMark(Result.ViolationKey))
+	{
+		return;
+	}
+	if (bRetainResults ? Results.Add(Result) == INDEX_NONE : IsStreamedDuplicate(Result.ViolationKey))
+	{
+		return;
+	}
+	++ResultNum;
+	for (const TUniquePtr<FResScannerResultSink>& ResultSink : ResultSinks)
+	{
+		ResultSink->WriteResult(Result);
+	}
+}
+
+bool FResScannerEngine::IsStreamedDuplicate(uint64 ViolationKey)
+{
+	bool bAlreadyStreamed = false;
+	StreamedViolationKeys.Add(ViolationKey, &bAlreadyStreamed);
+	return bAlreadyStreamed;
+}
+
+void FResScannerEngine::ResetResults()
+{
+	Results.Reset();
+	StreamedViolationKeys.Reset();
+	ResultNum = 0;
+	Baseline.ResetMarks();
+}
+
+void FResScannerEngine::CloseResultSinks()
+{
+	for (const TUniquePtr<FResScannerResultSink>& ResultSink : ResultSinks)
+	{
+		ResultSink->Close();
+		UE_LOG(LogResScanner, Display, TEXT("[CloseResultSinks] %lld results written to %s"), ResultSink->GetResultNum(), *ResultSink->GetFilePath());
+	}
+	ResultSinks.Empty();
+}
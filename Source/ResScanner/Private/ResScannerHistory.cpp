@@ -0,0 +1,348 @@
+#include "ResScannerHistory.h"
+#include "ResScannerEngine.h"
+#include "SQLiteDatabase.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+// 数据库结构版本，记录在 user_version 中，结构变化时在 Open 中升级
+static constexpr int32 HistorySchemaVersion = 1;
+
+// 挂载根下的一级目录：/Game/Characters/Hero -> /Game/Characters，/MyPlugin/Maps/Sub -> /MyPlugin/Maps
+static FString GetTopLevelFolder(const FString& PackagePath)
+{
+	const int32 RootEnd = PackagePath.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, 1);
+	if (RootEnd == INDEX_NONE)
+	{
+		return PackagePath;
+	}
+	const int32 FolderEnd = PackagePath.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, RootEnd + 1);
+	return FolderEnd == INDEX_NONE ? PackagePath : PackagePath.Left(FolderEnd);
+}
+
+FResScannerHistory::FResScannerHistory()
+	: Database(MakeUnique<FSQLiteDatabase>())
+	, InsertViolationStatement(MakeUnique<FSQLitePreparedStatement>())
+	, InsertFirstSeenStatement(MakeUnique<FSQLitePreparedStatement>())
+{
+}
+
+FResScannerHistory::~FResScannerHistory()
+{
+	Close();
+}
+
+FString FResScannerHistory::GetDefaultFilePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("ResScanner") / TEXT("ScanHistory.db");
+}
+
+bool FResScannerHistory::Open(const FString& FilePath)
+{
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), true);
+	if (!Database->Open(*FilePath, ESQLiteDatabaseOpenMode::ReadWriteCreate))
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[History] Failed to open %s: %s"), *FilePath, *Database->GetLastError());
+		return false;
+	}
+
+	// Execute 每次只执行一条语句
+	const TCHAR* SchemaStatements[] =
+	{
+		TEXT("PRAGMA journal_mode=WAL;"),
+		TEXT("CREATE TABLE IF NOT EXISTS Scans(Id INTEGER PRIMARY KEY, StartTime INTEGER NOT NULL, RootPath TEXT, RuleSets TEXT, Source TEXT,")
+			TEXT(" ScannedAssetNum INTEGER DEFAULT 0, ViolationNum INTEGER DEFAULT 0, Completed INTEGER DEFAULT 0);"),
+		TEXT("CREATE TABLE IF NOT EXISTS Rules(Id INTEGER PRIMARY KEY, Fingerprint TEXT UNIQUE NOT NULL, RuleName TEXT, RuleSetName TEXT);"),
+		TEXT("CREATE TABLE IF NOT EXISTS Violations(ScanId INTEGER NOT NULL, RuleId INTEGER NOT NULL, ViolationKey INTEGER NOT NULL,")
+			TEXT(" PackagePath TEXT NOT NULL, AssetPath TEXT NOT NULL, AssetClass TEXT, ErrorReason TEXT);"),
+		TEXT("CREATE INDEX IF NOT EXISTS ViolationsByScan ON Violations(ScanId);"),
+		TEXT("CREATE INDEX IF NOT EXISTS ViolationsByRule ON Violations(RuleId, ScanId);"),
+		TEXT("CREATE INDEX IF NOT EXISTS ViolationsByPath ON Violations(PackagePath, ScanId);"),
+		TEXT("CREATE INDEX IF NOT EXISTS ViolationsByClass ON Violations(AssetClass, ScanId);"),
+		TEXT("CREATE TABLE IF NOT EXISTS FirstSeen(ViolationKey INTEGER PRIMARY KEY, ScanId INTEGER NOT NULL, StartTime INTEGER NOT NULL);")
+	};
+	for (const TCHAR* SchemaStatement : SchemaStatements)
+	{
+		if (!Database->Execute(SchemaStatement))
+		{
+			UE_LOG(LogResScanner, Error, TEXT("[History] Failed to create tables: %s"), *Database->GetLastError());
+			Close();
+			return false;
+		}
+	}
+	Database->Execute(*FString::Printf(TEXT("PRAGMA user_version=%d;"), HistorySchemaVersion));
+
+	*InsertViolationStatement = Database->PrepareStatement(TEXT(
+		"INSERT INTO Violations(ScanId, RuleId, ViolationKey, PackagePath, AssetPath, AssetClass, ErrorReason) VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7);"),
+		ESQLitePreparedStatementFlags::Persistent);
+	*InsertFirstSeenStatement = Database->PrepareStatement(TEXT(
+		"INSERT OR IGNORE INTO FirstSeen(ViolationKey, ScanId, StartTime) SELECT ?1, Id, StartTime FROM Scans WHERE Id = ?2;"),
+		ESQLitePreparedStatementFlags::Persistent);
+	return InsertViolationStatement->IsValid() && InsertFirstSeenStatement->IsValid();
+}
+
+void FResScannerHistory::Close()
+{
+	if (!Database->IsValid())
+	{
+		return;
+	}
+	if (CurrentScanId != 0)
+	{
+		EndScan(0, false);
+	}
+	InsertViolationStatement->Destroy();
+	InsertFirstSeenStatement->Destroy();
+	RuleIds.Empty();
+	Database->Close();
+}
+
+int64 FResScannerHistory::BeginScan(const FString& RootPath, const FString& RuleSetNames, const FString& Source)
+{
+	if (!Database->IsValid())
+	{
+		return 0;
+	}
+	if (CurrentScanId != 0)
+	{
+		EndScan(0, false);
+	}
+
+	// 一次扫描的所有写入放在一个事务里
+	Database->Execute(TEXT("BEGIN TRANSACTION;"));
+	FSQLitePreparedStatement InsertScan = Database->PrepareStatement(TEXT("INSERT INTO Scans(StartTime, RootPath, RuleSets, Source) VALUES(?1, ?2, ?3, ?4);"));
+	InsertScan.SetBindingValueByIndex(1, FDateTime::UtcNow().ToUnixTimestamp());
+	InsertScan.SetBindingValueByIndex(2, RootPath);
+	InsertScan.SetBindingValueByIndex(3, RuleSetNames);
+	InsertScan.SetBindingValueByIndex(4, Source);
+	if (!InsertScan.Execute())
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[History] Failed to begin scan: %s"), *Database->GetLastError());
+		Database->Execute(TEXT("ROLLBACK;"));
+		return 0;
+	}
+	CurrentScanId = Database->GetLastInsertRowId();
+	CurrentViolationNum = 0;
+	RecordedViolationKeys.Reset();
+	return CurrentScanId;
+}
+
+void FResScannerHistory::AddViolation(const FScanResultItem& Result, const FString& RuleFingerprint)
+{
+	// 同一次扫描中重复的违规（重复评估、合并的报告有重叠）只记录一次
+	bool bAlreadyRecorded = false;
+	if (CurrentScanId == 0 || (RecordedViolationKeys.Add(Result.ViolationKey, &bAlreadyRecorded), bAlreadyRecorded))
+	{
+		return;
+	}
+	const int64 ViolationKey = static_cast<int64>(Result.ViolationKey);
+
+	InsertViolationStatement->Reset();
+	InsertViolationStatement->SetBindingValueByIndex(1, CurrentScanId);
+	InsertViolationStatement->SetBindingValueByIndex(2, FindOrAddRule(RuleFingerprint, Result));
+	InsertViolationStatement->SetBindingValueByIndex(3, ViolationKey);
+	InsertViolationStatement->SetBindingValueByIndex(4, FPackageName::GetLongPackagePath(FPackageName::ObjectPathToPackageName(Result.AssetPath)));
+	InsertViolationStatement->SetBindingValueByIndex(5, Result.AssetPath);
+	InsertViolationStatement->SetBindingValueByIndex(6, Result.AssetClass);
+	InsertViolationStatement->SetBindingValueByIndex(7, Result.ErrorReason);
+	InsertViolationStatement->Execute();
+
+	InsertFirstSeenStatement->Reset();
+	InsertFirstSeenStatement->SetBindingValueByIndex(1, ViolationKey);
+	InsertFirstSeenStatement->SetBindingValueByIndex(2, CurrentScanId);
+	InsertFirstSeenStatement->Execute();
+
+	++CurrentViolationNum;
+}
+
+void FResScannerHistory::EndScan(int64 ScannedAssetNum, bool bCompleted)
+{
+	if (CurrentScanId == 0)
+	{
+		return;
+	}
+	FSQLitePreparedStatement UpdateScan = Database->PrepareStatement(TEXT("UPDATE Scans SET ScannedAssetNum = ?1, ViolationNum = ?2, Completed = ?3 WHERE Id = ?4;"));
+	UpdateScan.SetBindingValueByIndex(1, ScannedAssetNum);
+	UpdateScan.SetBindingValueByIndex(2, CurrentViolationNum);
+	UpdateScan.SetBindingValueByIndex(3, bCompleted ? 1 : 0);
+	UpdateScan.SetBindingValueByIndex(4, CurrentScanId);
+	UpdateScan.Execute();
+	if (!Database->Execute(TEXT("COMMIT;")))
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[History] Failed to commit scan %lld: %s"), CurrentScanId, *Database->GetLastError());
+	}
+	UE_LOG(LogResScanner, Log, TEXT("[History] Recorded scan %lld: %lld violations%s"), CurrentScanId, CurrentViolationNum, bCompleted ? TEXT("") : TEXT(" (incomplete)"));
+	CurrentScanId = 0;
+	RecordedViolationKeys.Empty();
+}
+
+int64 FResScannerHistory::FindOrAddRule(const FString& RuleFingerprint, const FScanResultItem& Result)
+{
+	// 从报告中读取的结果没有规则指纹，用规则名 + 规则集代替
+	const FString RuleKey = RuleFingerprint.IsEmpty() ? Result.RuleName + TEXT("|") + Result.RuleSetName : RuleFingerprint;
+	if (const int64* RuleId = RuleIds.Find(RuleKey))
+	{
+		return *RuleId;
+	}
+
+	FSQLitePreparedStatement InsertRule = Database->PrepareStatement(TEXT("INSERT OR IGNORE INTO Rules(Fingerprint, RuleName, RuleSetName) VALUES(?1, ?2, ?3);"));
+	InsertRule.SetBindingValueByIndex(1, RuleKey);
+	InsertRule.SetBindingValueByIndex(2, Result.RuleName);
+	InsertRule.SetBindingValueByIndex(3, Result.RuleSetName);
+	InsertRule.Execute();
+
+	int64 RuleId = 0;
+	FSQLitePreparedStatement SelectRule = Database->PrepareStatement(TEXT("SELECT Id FROM Rules WHERE Fingerprint = ?1;"));
+	SelectRule.SetBindingValueByIndex(1, RuleKey);
+	if (SelectRule.Step() == ESQLitePreparedStatementStepResult::Row)
+	{
+		SelectRule.GetColumnValueByIndex(0, RuleId);
+	}
+	RuleIds.Add(RuleKey, RuleId);
+	return RuleId;
+}
+
+bool FResScannerHistory::QueryTrend(const TCHAR* Condition, TFunctionRef<void(FSQLitePreparedStatement&)> BindCondition, int32 MaxScanNum, TArray<FResScannerTrendPoint>& OutPoints)
+{
+	OutPoints.Reset();
+	if (!Database->IsValid())
+	{
+		return false;
+	}
+	// 最近 MaxScanNum 次完整扫描，没有违规的扫描也要有一个 0 的数据点
+	const FString Query = FString::Printf(TEXT(
+		"SELECT S.Id, S.StartTime, (SELECT COUNT(*) FROM Violations V WHERE V.ScanId = S.Id AND %s) FROM"
+		" (SELECT Id, StartTime FROM Scans WHERE Completed = 1 ORDER BY Id DESC LIMIT ?1) S ORDER BY S.Id;"), Condition);
+	FSQLitePreparedStatement Statement = Database->PrepareStatement(*Query);
+	if (!Statement.IsValid())
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[History] Invalid trend query: %s"), *Database->GetLastError());
+		return false;
+	}
+	Statement.SetBindingValueByIndex(1, MaxScanNum);
+	BindCondition(Statement);
+	while (Statement.Step() == ESQLitePreparedStatementStepResult::Row)
+	{
+		FResScannerTrendPoint& Point = OutPoints.AddDefaulted_GetRef();
+		int64 StartTime = 0;
+		Statement.GetColumnValueByIndex(0, Point.ScanId);
+		Statement.GetColumnValueByIndex(1, StartTime);
+		Statement.GetColumnValueByIndex(2, Point.ViolationNum);
+		Point.StartTime = FDateTime::FromUnixTimestamp(StartTime);
+	}
+	return true;
+}
+
+bool FResScannerHistory::QueryFolderTrend(const FString& PathPrefix, int32 MaxScanNum, TArray<FResScannerTrendPoint>& OutPoints)
+{
+	const FString Prefix = PathPrefix.EndsWith(TEXT("/")) ? PathPrefix.LeftChop(1) : PathPrefix;
+	return QueryTrend(TEXT("(V.PackagePath = ?2 OR (V.PackagePath >= ?3 AND V.PackagePath < ?4))"), [&Prefix](FSQLitePreparedStatement& Statement)
+	{
+		Statement.SetBindingValueByIndex(2, Prefix);
+		Statement.SetBindingValueByIndex(3, Prefix + TEXT("/"));
+		Statement.SetBindingValueByIndex(4, Prefix + TEXT("0"));
+	}, MaxScanNum, OutPoints);
+}
+
+bool FResScannerHistory::QueryRuleTrend(const FString& RuleFingerprint, int32 MaxScanNum, TArray<FResScannerTrendPoint>& OutPoints)
+{
+	return QueryTrend(TEXT("V.RuleId = (SELECT Id FROM Rules WHERE Fingerprint = ?2)"), [&RuleFingerprint](FSQLitePreparedStatement& Statement)
+	{
+		Statement.SetBindingValueByIndex(2, RuleFingerprint);
+	}, MaxScanNum, OutPoints);
+}
+
+bool FResScannerHistory::QueryFirstSeen(uint64 ViolationKey, FDateTime& OutFirstSeen)
+{
+	if (!Database->IsValid())
+	{
+		return false;
+	}
+	FSQLitePreparedStatement Statement = Database->PrepareStatement(TEXT("SELECT StartTime FROM FirstSeen WHERE ViolationKey = ?1;"));
+	Statement.SetBindingValueByIndex(1, static_cast<int64>(ViolationKey));
+	if (Statement.Step() != ESQLitePreparedStatementStepResult::Row)
+	{
+		return false;
+	}
+	int64 StartTime = 0;
+	Statement.GetColumnValueByIndex(0, StartTime);
+	OutFirstSeen = FDateTime::FromUnixTimestamp(StartTime);
+	return true;
+}
+
+FString FResScannerHistory::DescribeTrend(int32 MaxScanNum)
+{
+	if (!Database->IsValid())
+	{
+		return FString();
+	}
+
+	// 最近几次完整扫描的 Id
+	TArray<int64> ScanIds;
+	TArray<FString> ScanDates;
+	{
+		FSQLitePreparedStatement Statement = Database->PrepareStatement(TEXT("SELECT Id, StartTime FROM (SELECT Id, StartTime FROM Scans WHERE Completed = 1 ORDER BY Id DESC LIMIT ?1) ORDER BY Id;"));
+		Statement.SetBindingValueByIndex(1, MaxScanNum);
+		while (Statement.Step() == ESQLitePreparedStatementStepResult::Row)
+		{
+			int64 ScanId = 0;
+			int64 StartTime = 0;
+			Statement.GetColumnValueByIndex(0, ScanId);
+			Statement.GetColumnValueByIndex(1, StartTime);
+			ScanIds.Add(ScanId);
+			ScanDates.Add(FDateTime::FromUnixTimestamp(StartTime).ToString(TEXT("%m-%d %H:%M")));
+		}
+	}
+	if (ScanIds.Num() == 0)
+	{
+		return FString();
+	}
+
+	// 按 分组 -> 每次扫描的违规数量 汇总，分组是规则或者一级目录，GetGroup 把查询出的分组再合并一次
+	auto DescribeGroups = [this, &ScanIds](const TCHAR* GroupExpression, const TCHAR* JoinClause, TFunctionRef<FString(const FString&)> GetGroup)
+	{
+		TMap<FString, TArray<int64>> GroupCounts;
+		const FString Query = FString::Printf(TEXT("SELECT %s, V.ScanId, COUNT(*) FROM Violations V %s WHERE V.ScanId >= ?1 AND V.ScanId <= ?2 GROUP BY 1, 2;"),
+			GroupExpression, JoinClause);
+		FSQLitePreparedStatement Statement = Database->PrepareStatement(*Query);
+		Statement.SetBindingValueByIndex(1, ScanIds[0]);
+		Statement.SetBindingValueByIndex(2, ScanIds.Last());
+		while (Statement.Step() == ESQLitePreparedStatementStepResult::Row)
+		{
+			FString Group;
+			int64 ScanId = 0;
+			int64 Count = 0;
+			Statement.GetColumnValueByIndex(0, Group);
+			Statement.GetColumnValueByIndex(1, ScanId);
+			Statement.GetColumnValueByIndex(2, Count);
+			const int32 ScanIndex = ScanIds.Find(ScanId);
+			if (ScanIndex != INDEX_NONE)
+			{
+				TArray<int64>& Counts = GroupCounts.FindOrAdd(GetGroup(Group));
+				Counts.SetNumZeroed(ScanIds.Num());
+				Counts[ScanIndex] += Count;
+			}
+		}
+
+		FString Lines;
+		for (const TPair<FString, TArray<int64>>& Pair : GroupCounts)
+		{
+			FString CountsText;
+			for (const int64 Count : Pair.Value)
+			{
+				CountsText += FString::Printf(TEXT(" %lld"), Count);
+			}
+			const int64 Delta = Pair.Value.Last() - Pair.Value[0];
+			Lines += FString::Printf(TEXT("\n  %s:%s（%s%lld）"), *Pair.Key, *CountsText, Delta > 0 ? TEXT("+") : TEXT(""), Delta);
+		}
+		return Lines;
+	};
+
+	FString Description = FString::Printf(TEXT("最近 %d 次完整扫描（%s ~ %s）的违规数量"), ScanIds.Num(), *ScanDates[0], *ScanDates.Last());
+	Description += TEXT("\n按规则：");
+	Description += DescribeGroups(TEXT("R.RuleSetName || '/' || R.RuleName"), TEXT("JOIN Rules R ON R.Id = V.RuleId"), [](const FString& Group) { return Group; });
+	// 挂载根的长度不固定（/Game、插件名），在 SQL 中按目录分组后再合并到一级目录
+	Description += TEXT("\n按目录（挂载根下的一级目录）：");
+	Description += DescribeGroups(TEXT("V.PackagePath"), TEXT(""), &GetTopLevelFolder);
+	return Description;
+}
@@ -0,0 +1,134 @@
+#include "ResScannerIoStore.h"
+#include "ResScannerEngine.h"
+#include "HAL/FileManager.h"
+#include "IO/IoStore.h"
+#include "Misc/App.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+const FName FResScannerIoStore::ContainerTag(TEXT("IoStoreContainer"));
+const FName FResScannerIoStore::SizeTag(TEXT("IoStoreSize"));
+const FName FResScannerIoStore::CompressedSizeTag(TEXT("IoStoreCompressedSize"));
+const FName FResScannerIoStore::BulkDataSizeTag(TEXT("IoStoreBulkDataSize"));
+const FName FResScannerIoStore::ChunkNumTag(TEXT("IoStoreChunkNum"));
+
+void FResScannerIoStore::FindContainers(const FString& Path, TArray<FString>& OutTocPaths)
+{
+	const FString FullPath = FPaths::ConvertRelativePathToFull(Path);
+	if (FPaths::GetExtension(FullPath) == TEXT("utoc"))
+	{
+		OutTocPaths.Add(FullPath);
+		return;
+	}
+	IFileManager::Get().FindFilesRecursive(OutTocPaths, *FullPath, TEXT("*.utoc"), true, false, false);
+	OutTocPaths.Sort();
+}
+
+bool FResScannerIoStore::GatherContainerAssets(const FString& TocPath, TArray<FAssetData>& OutAssets)
+{
+	// Initialize 需要不带扩展名的容器路径，只读取 .utoc
+	FIoStoreReader Reader;
+	const FIoStatus Status = Reader.Initialize(*FPaths::GetBaseFilename(TocPath, false), TMap<FGuid, FAES::FAESKey>());
+	if (!Status.IsOk())
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[IoStore] Failed to read %s: %s"), *TocPath, *Status.ToString());
+		return false;
+	}
+	if (EnumHasAnyFlags(Reader.GetContainerFlags(), EIoContainerFlags::Encrypted))
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[IoStore] %s is encrypted, the directory index can not be read without keys"), *TocPath);
+		return false;
+	}
+
+	// 同一个资源包的 Chunk 文件名只有扩展名不同（.uasset/.umap、.ubulk、.uptnl、.m.ubulk），按去掉扩展名的路径合并
+	struct FPackageEntry
+	{
+		FString MainFilename;
+		uint64 Size = 0;
+		uint64 CompressedSize = 0;
+		uint64 BulkDataSize = 0;
+		int32 ChunkNum = 0;
+	};
+	TMap<FString, FPackageEntry> Packages;
+	int32 ChunkNum = 0;
+	int32 UnnamedChunkNum = 0;
+	Reader.EnumerateChunks([&Packages, &ChunkNum, &UnnamedChunkNum](const FIoStoreTocChunkInfo& ChunkInfo)
+	{
+		++ChunkNum;
+		if (!ChunkInfo.bHasValidFileName)
+		{
+			++UnnamedChunkNum;
+			return true;
+		}
+		const int32 NameStart = ChunkInfo.FileName.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromEnd) + 1;
+		const int32 ExtensionStart = ChunkInfo.FileName.Find(TEXT("."), ESearchCase::CaseSensitive, ESearchDir::FromStart, NameStart);
+		FPackageEntry& Entry = Packages.FindOrAdd(ExtensionStart != INDEX_NONE ? ChunkInfo.FileName.Left(ExtensionStart) : ChunkInfo.FileName);
+		Entry.Size += ChunkInfo.Size;
+		Entry.CompressedSize += ChunkInfo.CompressedSize;
+		Entry.ChunkNum++;
+		if (ChunkInfo.ChunkType == EIoChunkType::ExportBundleData)
+		{
+			Entry.MainFilename = ChunkInfo.FileName;
+		}
+		else if (ChunkInfo.ChunkType == EIoChunkType::BulkData || ChunkInfo.ChunkType == EIoChunkType::OptionalBulkData
+			|| ChunkInfo.ChunkType == EIoChunkType::MemoryMappedBulkData)
+		{
+			Entry.BulkDataSize += ChunkInfo.Size;
+		}
+		return true;
+	});
+	if (UnnamedChunkNum > 0 && Packages.Num() == 0)
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[IoStore] %s has no directory index, skipped"), *TocPath);
+		return false;
+	}
+
+	const FString ContainerName = FPaths::GetBaseFilename(TocPath);
+	static const FTopLevelAssetPath WorldClassPath(TEXT("/Script/Engine"), TEXT("World"));
+	for (const TPair<FString, FPackageEntry>& Pair : Packages)
+	{
+		// 只有 BulkData 的条目（导出数据在其它容器中）和着色器库等非资源包的文件不生成资源
+		const FPackageEntry& Entry = Pair.Value;
+		if (Entry.MainFilename.IsEmpty())
+		{
+			continue;
+		}
+		const FName PackageName = FilenameToPackageName(Entry.MainFilename);
+		if (PackageName.IsNone())
+		{
+			continue;
+		}
+
+		FAssetDataTagMap Tags;
+		Tags.Add(ContainerTag, ContainerName);
+		Tags.Add(SizeTag, LexToString(Entry.Size));
+		Tags.Add(CompressedSizeTag, LexToString(Entry.CompressedSize));
+		Tags.Add(BulkDataSizeTag, LexToString(Entry.BulkDataSize));
+		Tags.Add(ChunkNumTag, LexToString(Entry.ChunkNum));
+
+		// 容器中没有资源类型，只有关卡可以根据扩展名确定，其余资源的类型为空（只受没有作用类型的规则检查）
+		const FString PackageNameString = PackageName.ToString();
+		const bool bIsMap = Entry.MainFilename.EndsWith(FPackageName::GetMapPackageExtension());
+		OutAssets.Emplace(PackageName, FName(*FPackageName::GetLongPackagePath(PackageNameString)),
+			FName(*FPackageName::GetShortName(PackageNameString)), bIsMap ? WorldClassPath : FTopLevelAssetPath(), MoveTemp(Tags));
+	}
+	UE_LOG(LogResScanner, Display, TEXT("[IoStore] %s: %d chunks, %d packages"), *ContainerName, ChunkNum, Packages.Num());
+	return true;
+}
+
+FName FResScannerIoStore::FilenameToPackageName(const FString& Filename)
+{
+	// 文件名是相对于引擎目录的路径，如 ../../../Project/Content/Maps/Main.umap、../../../Project/Plugins/Foo/Content/Bar.uasset
+	// 不依赖当前编辑器中的挂载点，Content 前面一级目录是项目名时为 /Game，否则是插件或者引擎的挂载点
+	const int32 ContentIndex = Filename.Find(TEXT("/Content/"), ESearchCase::IgnoreCase);
+	if (ContentIndex == INDEX_NONE)
+	{
+		return NAME_None;
+	}
+	const int32 MountStart = Filename.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromEnd, ContentIndex) + 1;
+	const FString MountName = Filename.Mid(MountStart, ContentIndex - MountStart);
+	const FString MountRoot = MountName == FApp::GetProjectName() ? TEXT("/Game") : TEXT("/") + MountName;
+
+	const FString RelativePath = FPaths::GetBaseFilename(Filename.Mid(ContentIndex + 9), false);
+	return FName(*(MountRoot / RelativePath));
+}
@@ -0,0 +1,183 @@
+#include "ResScannerPlanner.h"
+#include "ResScannerRuleBase.h"
+#include "ResScannerRuleIndex.h"
+#include "ResScannerRuleScheduler.h"
+#include "ResScannerSettings.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/ScopedSlowTask.h"
+
+#define LOCTEXT_NAMESPACE "FResScannerModule"
+
+// 预估耗时超过这个值（秒）的规则会被标记为开销大的规则
+static constexpr double ExpensiveRuleSeconds = 10.0;
+
+void FResScannerScanExplain::Explain(const TArray<UResScannerRuleSet*>& InRuleSets, const FResScannerRuleScheduler& InScheduler, FName InRootPath)
+{
+	*this = FResScannerScanExplain();
+
+	// 使用独立的编译结果、索引和调度器，不影响正在进行的扫描
+	FResScannerCompiledRules ExplainRules;
+	ExplainRules.Compile(InRuleSets);
+	FResScannerRuleIndex ExplainIndex;
+	ExplainIndex.Build(ExplainRules.Rules);
+	FResScannerRuleScheduler ExplainScheduler = InScheduler;
+	ExplainScheduler.BuildPlan(ExplainRules);
+
+	const int32 RuleNum = ExplainRules.Rules.Num();
+	TArray<bool> ParallelRules;
+	TArray<bool> LoadRules;
+	// 规则的结果能确定整个规则集结果的概率
+	TArray<double> DecisiveProbabilities;
+	TArray<double> RuleCosts;
+	Rules.SetNum(RuleNum);
+	for (int32 RuleIndex = 0; RuleIndex < RuleNum; ++RuleIndex)
+	{
+		const UResScannerRuleBase* Rule = ExplainRules.Rules[RuleIndex];
+		ParallelRules.Add(Rule->CanMatchOffGameThread());
+		LoadRules.Add(Rule->RequiresAssetLoad());
+		RuleCosts.Add(ExplainScheduler.GetEstimatedCost(RuleIndex));
+
+		const double Selectivity = ExplainScheduler.GetEstimatedSelectivity(RuleIndex);
+		switch (ExplainRules.GetRuleLogic(RuleIndex))
+		{
+		case ERuleSetLogic::AnyViolation:
+			DecisiveProbabilities.Add(Selectivity);
+			break;
+		case ERuleSetLogic::AllViolation:
+			DecisiveProbabilities.Add(1.0 - Selectivity);
+			break;
+		default:
+			DecisiveProbabilities.Add(0.0);
+			break;
+		}
+
+		TArray<FTopLevelAssetPath> ScopeClassPaths;
+		Rule->GetScopeClasses(ScopeClassPaths);
+		FResScannerRuleExplain& RuleExplain = Rules[RuleIndex];
+		RuleExplain.RuleName = Rule->GetClass()->GetName();
+		RuleExplain.RuleSetName = ExplainRules.GetRuleSetName(RuleIndex);
+		RuleExplain.bRequiresLoad = LoadRules[RuleIndex];
+		RuleExplain.bHasStats = ExplainScheduler.FindStats(Rule->GetRuleFingerprint()) != nullptr;
+		RuleExplain.bUnscoped = Rule->ScopePaths.Num() == 0 && ScopeClassPaths.Num() == 0;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FName> ScanPaths;
+	ScanPaths.Add(InRootPath);
+	AssetRegistry.GetSubPaths(InRootPath, ScanPaths, true);
+	PathNum = ScanPaths.Num();
+
+	FScopedSlowTask SlowTask(ScanPaths.Num(), LOCTEXT("ExplainScan", "正在预估扫描开销..."));
+	SlowTask.MakeDialogDelayed(1.0f);
+
+	TArray<FAssetData> PathAssets;
+	TArray<int32> AssetRules;
+	TArray<double, TInlineAllocator<8>> RuleSetReachProbabilities;
+	for (const FName& ScanPath : ScanPaths)
+	{
+		SlowTask.EnterProgressFrame();
+
+		FARFilter Filter;
+		Filter.PackagePaths.Add(ScanPath);
+		Filter.bRecursivePaths = false;
+		Filter.bIncludeOnlyOnDiskAssets = true;
+		// 和扫描一样，EnumerateAssets 回调中持有注册表锁，先拷贝出来再查询索引
+		PathAssets.Reset();
+		AssetRegistry.EnumerateAssets(Filter, [&PathAssets](const FAssetData& AssetData)
+		{
+			PathAssets.Add(AssetData);
+			return true;
+		});
+		AssetNum += PathAssets.Num();
+
+		for (const FAssetData& AssetData : PathAssets)
+		{
+			ExplainIndex.GatherApplicableRules(AssetData, AssetRules);
+			if (AssetRules.Num() == 0)
+			{
+				continue;
+			}
+			InScopeAssetNum++;
+
+			// 和 EvaluateAssetChunk 的顺序一致：先在工作线程中评估并行规则，再在 GameThread 中评估其余规则，各自按执行计划排序
+			AssetRules.Sort([&](int32 A, int32 B)
+			{
+				if (ParallelRules[A] != ParallelRules[B])
+				{
+					return ParallelRules[A];
+				}
+				return ExplainScheduler.GetPlanRank(A) < ExplainScheduler.GetPlanRank(B);
+			});
+
+			// 假设各规则的违规相互独立，规则被执行的概率 = 同一规则集中前面的规则都没有确定结果的概率
+			RuleSetReachProbabilities.Init(1.0, ExplainRules.RuleSets.Num());
+			double NotLoadedProbability = 1.0;
+			for (const int32 RuleIndex : AssetRules)
+			{
+				double& ReachProbability = RuleSetReachProbabilities[ExplainRules.GetRuleSetIndex(RuleIndex)];
+				Rules[RuleIndex].InScopeNum++;
+				Rules[RuleIndex].ExpectedEvaluatedNum += ReachProbability;
+				if (LoadRules[RuleIndex])
+				{
+					NotLoadedProbability *= 1.0 - ReachProbability;
+				}
+				ReachProbability *= 1.0 - DecisiveProbabilities[RuleIndex];
+			}
+
+			// 同一个资源只加载一次
+			const double LoadProbability = 1.0 - NotLoadedProbability;
+			if (LoadProbability > 0.0)
+			{
+				ExpectedLoadNum += LoadProbability;
+				if (const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(AssetData.PackageName))
+				{
+					ExpectedLoadBytes += LoadProbability * PackageData->DiskSize;
+				}
+			}
+		}
+	}
+
+	const double WorkerNum = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	for (int32 RuleIndex = 0; RuleIndex < RuleNum; ++RuleIndex)
+	{
+		FResScannerRuleExplain& RuleExplain = Rules[RuleIndex];
+		RuleExplain.EstimatedSeconds = RuleExplain.ExpectedEvaluatedNum * RuleCosts[RuleIndex];
+		EstimatedSeconds += ParallelRules[RuleIndex] ? RuleExplain.EstimatedSeconds / WorkerNum : RuleExplain.EstimatedSeconds;
+		// 耗时长的规则，以及需要加载资源却没有限定范围的规则（会加载所有资源）
+		RuleExplain.bExpensive = RuleExplain.EstimatedSeconds >= ExpensiveRuleSeconds
+			|| (RuleExplain.bRequiresLoad && RuleExplain.bUnscoped && RuleExplain.InScopeNum > 0);
+	}
+}
+
+FString FResScannerScanExplain::Describe() const
+{
+	FString Description = FString::Printf(TEXT("扫描预估：%d 个目录，%lld 个资源，其中 %lld 个在规则作用范围内；预计加载 %.0f 个资源（约 %.1f MB），耗时约 %.1f 秒"),
+		PathNum, AssetNum, InScopeAssetNum, ExpectedLoadNum, ExpectedLoadBytes / (1024.0 * 1024.0), EstimatedSeconds);
+
+	const float MaxScanSeconds = GetDefault<UResScannerSettings>()->MaxScanSeconds;
+	if (MaxScanSeconds > 0.0f && EstimatedSeconds > MaxScanSeconds)
+	{
+		Description += FString::Printf(TEXT("（超过扫描预算 %.0f 秒）"), MaxScanSeconds);
+	}
+
+	for (const FResScannerRuleExplain& RuleExplain : Rules)
+	{
+		Description += FString::Printf(TEXT("\n\t%s[%s] %s：作用 %lld 个资源，预计评估 %.0f 次，%s，约 %.2f 秒%s"),
+			RuleExplain.bExpensive ? TEXT("【开销大】") : TEXT(""),
+			*RuleExplain.RuleSetName,
+			*RuleExplain.RuleName,
+			RuleExplain.InScopeNum,
+			RuleExplain.ExpectedEvaluatedNum,
+			RuleExplain.bRequiresLoad ? TEXT("需加载资源") : TEXT("只读注册表"),
+			RuleExplain.EstimatedSeconds,
+			RuleExplain.bHasStats ? TEXT("") : TEXT("（无历史数据，按默认值估计）"));
+		if (RuleExplain.bRequiresLoad && RuleExplain.bUnscoped)
+		{
+			Description += TEXT("，没有限定作用目录或类型，会加载范围内所有资源");
+		}
+	}
+	return Description;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,332 @@
+#include "ResScannerResultSearch.h"
+#include "ResScannerResultStore.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+	// 模糊匹配时资源至少要包含词中这个比例的三元组
+	constexpr float FuzzyMatchRatio = 0.6f;
+
+	int32 GetFuzzyMinHits(int32 TrigramNum)
+	{
+		return FMath::Max(1, FMath::CeilToInt(TrigramNum * FuzzyMatchRatio));
+	}
+
+	bool ContainsIgnoreCase(FStringView Text, const FString& Term)
+	{
+		return FString(Text).Contains(Term, ESearchCase::IgnoreCase);
+	}
+}
+
+FResScannerResultSearch::FResScannerResultSearch(const FResScannerResultStore& InResults)
+	: Results(InResults)
+{
+}
+
+void FResScannerResultSearch::Reset()
+{
+	Postings.Reset();
+	IndexedAssetNum = 0;
+	IndexedViolationNum = 0;
+	// 规则表可能被 SetRules 替换，规则匹配重新计算
+	for (FTerm& Term : Terms)
+	{
+		Term.MatchedRules.Reset();
+	}
+	MatchedAssets.Reset();
+	MatchedAssetNum = 0;
+}
+
+void FResScannerResultSearch::Update()
+{
+	// 结果存储被清空过（调用方没有调用 Reset）
+	if (Results.GetAssetNum() < IndexedAssetNum || Results.Num() < IndexedViolationNum)
+	{
+		Reset();
+	}
+	if (Results.GetAssetNum() == IndexedAssetNum && Results.Num() == IndexedViolationNum)
+	{
+		return;
+	}
+
+	const int32 FirstNewAsset = IndexedAssetNum;
+	for (int32 AssetId = IndexedAssetNum; AssetId < Results.GetAssetNum(); ++AssetId)
+	{
+		IndexText(Results.GetAssetPackageName(AssetId).ToString(), AssetId);
+	}
+	const int32 FirstNewViolation = IndexedViolationNum;
+	for (int32 ViolationIndex = IndexedViolationNum; ViolationIndex < Results.Num(); ++ViolationIndex)
+	{
+		// 使用规则默认错误原因的违规按规则匹配，不进索引
+		if (Results.HasErrorDetail(ViolationIndex))
+		{
+			IndexText(Results.GetErrorReason(ViolationIndex), Results.GetViolationAsset(ViolationIndex));
+		}
+	}
+	IndexedAssetNum = Results.GetAssetNum();
+	IndexedViolationNum = Results.Num();
+
+	if (!HasQuery())
+	{
+		return;
+	}
+	// 之前没有任何匹配结果（Reset 之后），直接用索引重新求
+	if (MatchedAssets.Num() == 0)
+	{
+		EvaluateQuery();
+		return;
+	}
+
+	for (FTerm& Term : Terms)
+	{
+		UpdateMatchedRules(Term);
+	}
+	// 已有的资源新增了违规，只重新判断还没有匹配的这些资源
+	for (int32 ViolationIndex = FirstNewViolation; ViolationIndex < IndexedViolationNum; ++ViolationIndex)
+	{
+		const int32 AssetId = Results.GetViolationAsset(ViolationIndex);
+		if (AssetId < FirstNewAsset && !MatchedAssets[AssetId] && MatchesAllTerms(AssetId))
+		{
+			MatchedAssets[AssetId] = true;
+			++MatchedAssetNum;
+		}
+	}
+	// 新增的资源数量等于两次刷新之间扫描到的违规资源，直接判断
+	for (int32 AssetId = FirstNewAsset; AssetId < IndexedAssetNum; ++AssetId)
+	{
+		const bool bMatched = MatchesAllTerms(AssetId);
+		MatchedAssets.Add(bMatched);
+		MatchedAssetNum += bMatched ? 1 : 0;
+	}
+}
+
+bool FResScannerResultSearch::SetQuery(const FString& InQuery)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	Terms.Reset();
+	TArray<FString> Words;
+	InQuery.ParseIntoArrayWS(Words);
+	for (const FString& Word : Words)
+	{
+		FTerm Term;
+		Term.bFuzzy = Word.StartsWith(TEXT("~"));
+		Term.Text = (Term.bFuzzy ? Word.RightChop(1) : Word).ToLower();
+		// 少于 3 个字符的词没有三元组，只能遍历所有字符串，直接忽略
+		if (Term.Text.Len() < 3)
+		{
+			continue;
+		}
+		GatherTrigrams(Term.Text, Term.Trigrams);
+		Terms.Add(MoveTemp(Term));
+	}
+	EvaluateQuery();
+
+	LastQuerySeconds = FPlatformTime::Seconds() - StartTime;
+	return HasQuery();
+}
+
+void FResScannerResultSearch::GatherTrigrams(FStringView Text, TArray<uint64>& OutTrigrams)
+{
+	OutTrigrams.Reset();
+	// 每个字符 21 位（Unicode 码位范围），三个字符放进一个 uint64
+	auto CharBits = [](TCHAR Char) { return uint64(FChar::ToLower(Char)) & 0x1FFFFF; };
+	for (int32 Index = 0; Index + 3 <= Text.Len(); ++Index)
+	{
+		OutTrigrams.Add((CharBits(Text[Index]) << 42) | (CharBits(Text[Index + 1]) << 21) | CharBits(Text[Index + 2]));
+	}
+	Algo::Sort(OutTrigrams);
+	OutTrigrams.SetNum(Algo::Unique(OutTrigrams));
+}
+
+void FResScannerResultSearch::AddPosting(uint64 Trigram, int32 AssetId)
+{
+	TArray<int32>& AssetIds = Postings.FindOrAdd(Trigram);
+	// 资源按编号顺序加入，只有已有资源的细节才需要插入到中间
+	if (AssetIds.Num() == 0 || AssetIds.Last() < AssetId)
+	{
+		AssetIds.Add(AssetId);
+		return;
+	}
+	const int32 Index = Algo::LowerBound(AssetIds, AssetId);
+	if (AssetIds[Index] != AssetId)
+	{
+		AssetIds.Insert(AssetId, Index);
+	}
+}
+
+void FResScannerResultSearch::IndexText(FStringView Text, int32 AssetId)
+{
+	TArray<uint64> Trigrams;
+	GatherTrigrams(Text, Trigrams);
+	for (const uint64 Trigram : Trigrams)
+	{
+		AddPosting(Trigram, AssetId);
+	}
+}
+
+void FResScannerResultSearch::UpdateMatchedRules(FTerm& Term) const
+{
+	for (int32 RuleId = Term.MatchedRules.Num(); RuleId < Results.GetRuleNum(); ++RuleId)
+	{
+		Term.MatchedRules.Add(Results.GetRuleName(RuleId).Contains(Term.Text) || Results.GetRuleErrorReason(RuleId).Contains(Term.Text));
+	}
+}
+
+void FResScannerResultSearch::EvaluateQuery()
+{
+	MatchedAssets.Reset();
+	MatchedAssetNum = 0;
+	if (!HasQuery())
+	{
+		return;
+	}
+
+	MatchedAssets.Init(true, IndexedAssetNum);
+	TBitArray<> TermAssets;
+	for (FTerm& Term : Terms)
+	{
+		UpdateMatchedRules(Term);
+		EvaluateTerm(Term, TermAssets);
+		MatchedAssets.CombineWithBitwiseAND(TermAssets, EBitwiseOperatorFlags::MaintainSize);
+	}
+	MatchedAssetNum = MatchedAssets.CountSetBits();
+}
+
+void FResScannerResultSearch::EvaluateTerm(FTerm& Term, TBitArray<>& OutAssets) const
+{
+	OutAssets.Init(false, IndexedAssetNum);
+
+	// 规则名或者规则错误原因匹配：规则的所有违规都匹配，只遍历违规表中的整数
+	if (Term.MatchedRules.Contains(true))
+	{
+		for (int32 ViolationIndex = 0; ViolationIndex < IndexedViolationNum; ++ViolationIndex)
+		{
+			if (Term.MatchedRules[Results.GetViolationRule(ViolationIndex)])
+			{
+				OutAssets[Results.GetViolationAsset(ViolationIndex)] = true;
+			}
+		}
+	}
+
+	// 资源包名和细节：用三元组倒排表求候选
+	TArray<const TArray<int32>*, TInlineAllocator<32>> AssetLists;
+	for (const uint64 Trigram : Term.Trigrams)
+	{
+		if (const TArray<int32>* AssetIds = Postings.Find(Trigram))
+		{
+			AssetLists.Add(AssetIds);
+		}
+		else if (!Term.bFuzzy)
+		{
+			// 有一个三元组没有出现过，不可能有子串匹配
+			return;
+		}
+	}
+	if (AssetLists.Num() == 0)
+	{
+		return;
+	}
+
+	if (Term.bFuzzy)
+	{
+		// 统计每个资源包含词中的几个三元组
+		const int32 MinHits = GetFuzzyMinHits(Term.Trigrams.Num());
+		TArray<uint16> Hits;
+		Hits.SetNumZeroed(IndexedAssetNum);
+		for (const TArray<int32>* AssetIds : AssetLists)
+		{
+			for (const int32 AssetId : *AssetIds)
+			{
+				if (++Hits[AssetId] == MinHits)
+				{
+					OutAssets[AssetId] = true;
+				}
+			}
+		}
+		return;
+	}
+
+	// 从最短的倒排表开始求交集
+	Algo::SortBy(AssetLists, [](const TArray<int32>* AssetIds) { return AssetIds->Num(); });
+	TArray<int32> Candidates = *AssetLists[0];
+	for (int32 ListIndex = 1; ListIndex < AssetLists.Num() && Candidates.Num() > 0; ++ListIndex)
+	{
+		const TArray<int32>& AssetIds = *AssetLists[ListIndex];
+		Candidates.RemoveAll([&AssetIds](int32 AssetId) { return Algo::BinarySearch(AssetIds, AssetId) == INDEX_NONE; });
+	}
+	// 所有三元组都出现不代表是子串，候选资源再用字符串校验
+	for (const int32 AssetId : Candidates)
+	{
+		if (!OutAssets[AssetId] && MatchesTerm(Term, AssetId))
+		{
+			OutAssets[AssetId] = true;
+		}
+	}
+}
+
+bool FResScannerResultSearch::MatchesTerm(const FTerm& Term, int32 AssetId) const
+{
+	TArray<int32> AssetViolations;
+	Results.GetAssetViolations(AssetId, AssetViolations);
+	for (const int32 ViolationIndex : AssetViolations)
+	{
+		const int32 RuleId = Results.GetViolationRule(ViolationIndex);
+		if (Term.MatchedRules.IsValidIndex(RuleId) && Term.MatchedRules[RuleId])
+		{
+			return true;
+		}
+	}
+
+	const FString PackageName = Results.GetAssetPackageName(AssetId).ToString();
+	if (!Term.bFuzzy)
+	{
+		if (PackageName.Contains(Term.Text, ESearchCase::IgnoreCase))
+		{
+			return true;
+		}
+		for (const int32 ViolationIndex : AssetViolations)
+		{
+			if (Results.HasErrorDetail(ViolationIndex) && ContainsIgnoreCase(Results.GetErrorReason(ViolationIndex), Term.Text))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// 模糊匹配：和建立索引时一样取包名和细节的三元组
+	TArray<uint64> AssetTrigrams;
+	GatherTrigrams(PackageName, AssetTrigrams);
+	TArray<uint64> DetailTrigrams;
+	for (const int32 ViolationIndex : AssetViolations)
+	{
+		if (Results.HasErrorDetail(ViolationIndex))
+		{
+			GatherTrigrams(Results.GetErrorReason(ViolationIndex), DetailTrigrams);
+			AssetTrigrams.Append(DetailTrigrams);
+		}
+	}
+	Algo::Sort(AssetTrigrams);
+	int32 Hits = 0;
+	for (const uint64 Trigram : Term.Trigrams)
+	{
+		Hits += Algo::BinarySearch(AssetTrigrams, Trigram) != INDEX_NONE ? 1 : 0;
+	}
+	return Hits >= GetFuzzyMinHits(Term.Trigrams.Num());
+}
+
+bool FResScannerResultSearch::MatchesAllTerms(int32 AssetId) const
+{
+	for (const FTerm& Term : Terms)
+	{
+		if (!MatchesTerm(Term, AssetId))
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,237 @@
+#include "ResScannerResultSink.h"
+#include "ResScannerEngine.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+namespace ResScannerResultSink
+{
+	// 把字符串写成 Json 字符串值（含引号），用于手写的 SARIF 片段
+	FString QuoteJson(const FString& Value)
+	{
+		FString Quoted;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Quoted);
+		Writer->WriteArrayStart();
+		Writer->WriteValue(Value);
+		Writer->WriteArrayEnd();
+		Writer->Close();
+		// 去掉外面的 [ ]
+		return Quoted.Mid(1, Quoted.Len() - 2);
+	}
+
+	// CSV 字段：包含逗号、引号、换行时加引号，引号写两次
+	FString QuoteCsv(const FString& Value)
+	{
+		if (!Value.Contains(TEXT(",")) && !Value.Contains(TEXT("\"")) && !Value.Contains(TEXT("\n")) && !Value.Contains(TEXT("\r")))
+		{
+			return Value;
+		}
+		return TEXT("\"") + Value.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+	}
+
+	FString EscapeXml(const FString& Value)
+	{
+		return Value.Replace(TEXT("&"), TEXT("&amp;")).Replace(TEXT("<"), TEXT("&lt;")).Replace(TEXT(">"), TEXT("&gt;"))
+			.Replace(TEXT("\""), TEXT("&quot;")).Replace(TEXT("'"), TEXT("&apos;"));
+	}
+
+	// 资源路径（/Game/Foo/Bar.Bar）转换成相对于项目目录的文件路径，代码评审工具按文件显示注释
+	FString AssetPathToProjectFile(const FString& AssetPath)
+	{
+		const FString PackageName = FPackageName::ObjectPathToPackageName(AssetPath);
+		FString Filename;
+		if (!FPackageName::TryConvertLongPackageNameToFilename(PackageName, Filename, FPackageName::GetAssetPackageExtension()))
+		{
+			return PackageName;
+		}
+		Filename = FPaths::ConvertRelativePathToFull(Filename);
+		FPaths::MakePathRelativeTo(Filename, *FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()));
+		return Filename;
+	}
+}
+
+class FResScannerNdjsonSink : public FResScannerResultSink
+{
+protected:
+	virtual void WriteResultText(const FScanResultItem& Result, FString& OutText) override
+	{
+		FormatJsonLine(Result, OutText);
+		OutText += TEXT("\n");
+	}
+};
+
+class FResScannerCsvSink : public FResScannerResultSink
+{
+protected:
+	virtual void WriteHeader() override
+	{
+		WriteText(TEXT("AssetPath,RuleName,ErrorReason,RuleSetName\n"));
+	}
+
+	virtual void WriteResultText(const FScanResultItem& Result, FString& OutText) override
+	{
+		using namespace ResScannerResultSink;
+		OutText = FString::Printf(TEXT("%s,%s,%s,%s\n"), *QuoteCsv(Result.AssetPath), *QuoteCsv(Result.RuleName),
+			*QuoteCsv(Result.ErrorReason), *QuoteCsv(Result.RuleSetName));
+	}
+};
+
+// SARIF 的 rules 列表需要在 results 之前，流式输出时不知道有哪些规则，只输出 results，ruleId 直接使用规则名
+class FResScannerSarifSink : public FResScannerResultSink
+{
+public:
+	virtual ~FResScannerSarifSink() override
+	{
+		Close();
+	}
+
+protected:
+	virtual void WriteHeader() override
+	{
+		WriteText(TEXT("{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"version\":\"2.1.0\",")
+			TEXT("\"runs\":[{\"tool\":{\"driver\":{\"name\":\"ResScanner\"}},\"results\":[\n"));
+	}
+
+	virtual void WriteResultText(const FScanResultItem& Result, FString& OutText) override
+	{
+		using namespace ResScannerResultSink;
+		OutText = FString::Printf(TEXT("%s{\"ruleId\":%s,\"level\":\"error\",\"message\":{\"text\":%s},")
+			TEXT("\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":%s}},\"logicalLocations\":[{\"fullyQualifiedName\":%s}]}],")
+			TEXT("\"properties\":{\"ruleSet\":%s}}\n"),
+			ResultNum > 0 ? TEXT(",") : TEXT(""), *QuoteJson(Result.RuleName), *QuoteJson(Result.ErrorReason),
+			*QuoteJson(AssetPathToProjectFile(Result.AssetPath)), *QuoteJson(Result.AssetPath), *QuoteJson(Result.RuleSetName));
+	}
+
+	virtual void WriteFooter() override
+	{
+		WriteText(TEXT("]}]}\n"));
+	}
+};
+
+// testsuite 的 tests、failures 属性要写在开头，流式输出时还不知道数量，省略这两个属性（Jenkins、GitLab 都能识别）
+class FResScannerJUnitSink : public FResScannerResultSink
+{
+public:
+	virtual ~FResScannerJUnitSink() override
+	{
+		Close();
+	}
+
+protected:
+	virtual void WriteHeader() override
+	{
+		WriteText(TEXT("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n<testsuite name=\"ResScanner\">\n"));
+	}
+
+	virtual void WriteResultText(const FScanResultItem& Result, FString& OutText) override
+	{
+		using namespace ResScannerResultSink;
+		OutText = FString::Printf(TEXT("<testcase classname=\"%s.%s\" name=\"%s\"><failure message=\"%s\"/></testcase>\n"),
+			*EscapeXml(Result.RuleSetName), *EscapeXml(Result.RuleName), *EscapeXml(Result.AssetPath), *EscapeXml(Result.ErrorReason));
+	}
+
+	virtual void WriteFooter() override
+	{
+		WriteText(TEXT("</testsuite>\n</testsuites>\n"));
+	}
+};
+
+TUniquePtr<FResScannerResultSink> FResScannerResultSink::Create(const FString& InFilePath)
+{
+	const FString Extension = FPaths::GetExtension(InFilePath).ToLower();
+	TUniquePtr<FResScannerResultSink> Sink;
+	if (Extension == TEXT("ndjson") || Extension == TEXT("jsonl"))
+	{
+		Sink = MakeUnique<FResScannerNdjsonSink>();
+	}
+	else if (Extension == TEXT("csv"))
+	{
+		Sink = MakeUnique<FResScannerCsvSink>();
+	}
+	else if (Extension == TEXT("sarif"))
+	{
+		Sink = MakeUnique<FResScannerSarifSink>();
+	}
+	else if (Extension == TEXT("xml"))
+	{
+		Sink = MakeUnique<FResScannerJUnitSink>();
+	}
+	else
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[ResultSink] Unsupported result format: %s"), *InFilePath);
+		return nullptr;
+	}
+
+	// FILEWRITE_AllowRead：扫描过程中其它进程可以读取文件
+	Sink->FilePath = InFilePath;
+	Sink->Writer.Reset(IFileManager::Get().CreateFileWriter(*InFilePath, FILEWRITE_AllowRead));
+	if (!Sink->Writer)
+	{
+		UE_LOG(LogResScanner, Error, TEXT("[ResultSink] Failed to create %s"), *InFilePath);
+		return nullptr;
+	}
+	Sink->WriteHeader();
+	return Sink;
+}
+
+void FResScannerResultSink::FormatJsonLine(const FScanResultItem& Result, FString& OutLine, bool bWithRuleIndex)
+{
+	OutLine.Reset();
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutLine);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("AssetPath"), Result.AssetPath);
+	Writer->WriteValue(TEXT("RuleName"), Result.RuleName);
+	Writer->WriteValue(TEXT("ErrorReason"), Result.ErrorReason);
+	Writer->WriteValue(TEXT("RuleSetName"), Result.RuleSetName);
+	Writer->WriteValue(TEXT("ViolationKey"), FString::Printf(TEXT("%016llx"), Result.ViolationKey));
+	Writer->WriteValue(TEXT("AssetClass"), Result.AssetClass);
+	if (bWithRuleIndex)
+	{
+		Writer->WriteValue(TEXT("RuleIndex"), Result.RuleIndex);
+		Writer->WriteValue(TEXT("RuleFingerprint"), Result.RuleFingerprint);
+	}
+	Writer->WriteObjectEnd();
+	Writer->Close();
+}
+
+FResScannerResultSink::~FResScannerResultSink()
+{
+	Close();
+}
+
+void FResScannerResultSink::Close()
+{
+	if (Writer)
+	{
+		WriteFooter();
+		Writer->Close();
+		Writer.Reset();
+	}
+}
+
+void FResScannerResultSink::WriteResult(const FScanResultItem& Result)
+{
+	FString Text;
+	WriteResultText(Result, Text);
+	WriteText(Text);
+	++ResultNum;
+}
+
+void FResScannerResultSink::Flush()
+{
+	if (Writer)
+	{
+		Writer->Flush();
+	}
+}
+
+void FResScannerResultSink::WriteText(const FString& Text)
+{
+	if (Writer)
+	{
+		FTCHARToUTF8 Utf8Text(*Text);
+		Writer->Serialize(const_cast<ANSICHAR*>(Utf8Text.Get()), Utf8Text.Length());
+	}
+}
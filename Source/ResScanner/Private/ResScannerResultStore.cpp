@@ -0,0 +1,286 @@
+#include "ResScannerResultStore.h"
+#include "ResScannerEngine.h"
+#include "AssetRegistry/AssetData.h"
+#include "Algo/Reverse.h"
+
+void FResScannerResultStore::Reset()
+{
+	AssetPackageNames.Reset();
+	AssetNames.Reset();
+	AssetClassIds.Reset();
+	AssetLastViolations.Reset();
+	RuleMasks.Reset();
+	AssetIds.Reset();
+	ViolationAssets.Reset();
+	ViolationRules.Reset();
+	ViolationKeys.Reset();
+	ViolationPrevInAsset.Reset();
+	ViolationDetails.Reset();
+	DetailArena.Reset();
+	for (FRuleEntry& RuleEntry : RuleEntries)
+	{
+		RuleEntry.Assets.Reset();
+	}
+}
+
+void FResScannerResultStore::SetRules(TArrayView<UResScannerRuleBase* const> Rules, TArrayView<const FString> RuleSetNames,
+	TArrayView<const int32> RuleSetPositions, TArrayView<const FString> RuleFingerprints)
+{
+	check(Rules.Num() == RuleSetNames.Num() && Rules.Num() == RuleSetPositions.Num() && Rules.Num() == RuleFingerprints.Num());
+	Reset();
+	RuleEntries.Reset(Rules.Num());
+	for (int32 RuleId = 0; RuleId < Rules.Num(); ++RuleId)
+	{
+		FRuleEntry& RuleEntry = AddRuleEntry(Rules[RuleId]->GetClass()->GetName(), RuleSetNames[RuleId], RuleSetPositions[RuleId]);
+		RuleEntry.RuleFingerprint = RuleFingerprints[RuleId];
+		RuleEntry.Rule = Rules[RuleId];
+	}
+	RuleMaskWordNum = FMath::Max(1, FMath::DivideAndRoundUp(RuleEntries.Num(), 64));
+}
+
+int32 FResScannerResultStore::Add(const FAssetData& AssetData, int32 RuleId, uint64 ViolationKey)
+{
+	check(RuleEntries.IsValidIndex(RuleId));
+	const int32 AssetId = FindOrAddAsset(AssetData.PackageName, AssetData.AssetName, AssetData.AssetClassPath);
+	return AddViolation(AssetId, RuleId, ViolationKey);
+}
+
+int32 FResScannerResultStore::Add(const FScanResultItem& Result)
+{
+	// 检查点、报告中的结果带有规则下标，规则表和保存时一致时（分片合并、从检查点继续）直接使用
+	int32 RuleId = Result.RuleIndex;
+	const bool bSameRule = RuleEntries.IsValidIndex(RuleId) && RuleEntries[RuleId].RuleSetName == Result.RuleSetName
+		&& (Result.RuleFingerprint.IsEmpty() ? RuleEntries[RuleId].RuleName == Result.RuleName : RuleEntries[RuleId].RuleFingerprint == Result.RuleFingerprint);
+	if (!bSameRule)
+	{
+		RuleId = FindOrAddRule(Result);
+	}
+
+	const FSoftObjectPath AssetPath(Result.AssetPath);
+	FTopLevelAssetPath ClassPath;
+	ClassPath.TrySetPath(Result.AssetClass);
+	const int32 AssetId = FindOrAddAsset(AssetPath.GetLongPackageFName(), AssetPath.GetAssetFName(), ClassPath);
+	const int32 ViolationIndex = AddViolation(AssetId, RuleId, Result.ViolationKey);
+	if (ViolationIndex != INDEX_NONE && GetRuleErrorReason(RuleId) != Result.ErrorReason)
+	{
+		ViolationDetails.Add(ViolationIndex, DetailArena.Num());
+		DetailArena.Append(*Result.ErrorReason, Result.ErrorReason.Len() + 1);
+	}
+	return ViolationIndex;
+}
+
+FStringView FResScannerResultStore::GetErrorReason(int32 ViolationIndex) const
+{
+	if (const int32* DetailOffset = ViolationDetails.Find(ViolationIndex))
+	{
+		return FStringView(&DetailArena[*DetailOffset]);
+	}
+	return GetRuleErrorReason(ViolationRules[ViolationIndex]);
+}
+
+void FResScannerResultStore::MakeItem(int32 ViolationIndex, FScanResultItem& OutItem) const
+{
+	const int32 AssetId = ViolationAssets[ViolationIndex];
+	const int32 RuleId = ViolationRules[ViolationIndex];
+	OutItem.AssetPath = GetAssetPath(AssetId);
+	OutItem.RuleName = GetRuleName(RuleId);
+	OutItem.ErrorReason = FString(GetErrorReason(ViolationIndex));
+	OutItem.RuleSetName = GetRuleSetName(RuleId);
+	OutItem.RuleIndex = RuleEntries[RuleId].Rule.IsExplicitlyNull() ? INDEX_NONE : RuleId;
+	OutItem.RuleFingerprint = RuleEntries[RuleId].RuleFingerprint;
+	OutItem.ViolationKey = ViolationKeys[ViolationIndex];
+	OutItem.AssetClass = GetAssetClass(AssetId).ToString();
+}
+
+int32 FResScannerResultStore::FindAsset(FName PackageName, FName AssetName) const
+{
+	const int32* AssetId = AssetIds.Find(TPair<FName, FName>(PackageName, AssetName));
+	return AssetId ? *AssetId : INDEX_NONE;
+}
+
+bool FResScannerResultStore::HasViolation(int32 AssetId, int32 RuleId) const
+{
+	if (RuleId >= RuleMaskWordNum * 64)
+	{
+		return false;
+	}
+	return (RuleMasks[AssetId * RuleMaskWordNum + RuleId / 64] & (1ull << (RuleId % 64))) != 0;
+}
+
+void FResScannerResultStore::GetAssetViolations(int32 AssetId, TArray<int32>& OutViolationIndices) const
+{
+	const int32 FirstIndex = OutViolationIndices.Num();
+	for (int32 ViolationIndex = AssetLastViolations[AssetId]; ViolationIndex != INDEX_NONE; ViolationIndex = ViolationPrevInAsset[ViolationIndex])
+	{
+		OutViolationIndices.Add(ViolationIndex);
+	}
+	// 链表是从后往前的
+	Algo::Reverse(MakeArrayView(OutViolationIndices).Slice(FirstIndex, OutViolationIndices.Num() - FirstIndex));
+}
+
+int32 FResScannerResultStore::GetAssetRuleNum(int32 AssetId) const
+{
+	int32 RuleNum = 0;
+	for (int32 WordIndex = 0; WordIndex < RuleMaskWordNum; ++WordIndex)
+	{
+		RuleNum += FMath::CountBits(RuleMasks[AssetId * RuleMaskWordNum + WordIndex]);
+	}
+	return RuleNum;
+}
+
+int32 FResScannerResultStore::GetAssetViolationNum(int32 AssetId) const
+{
+	int32 ViolationNum = 0;
+	for (int32 ViolationIndex = AssetLastViolations[AssetId]; ViolationIndex != INDEX_NONE; ViolationIndex = ViolationPrevInAsset[ViolationIndex])
+	{
+		++ViolationNum;
+	}
+	return ViolationNum;
+}
+
+const FString& FResScannerResultStore::GetRuleErrorReason(int32 RuleId) const
+{
+	const FRuleEntry& RuleEntry = RuleEntries[RuleId];
+	if (!RuleEntry.bErrorReasonFormatted)
+	{
+		// GetErrorReason 可能被蓝图覆盖，只能在 GameThread 中调用
+		check(IsInGameThread());
+		if (const UResScannerRuleBase* Rule = RuleEntry.Rule.Get())
+		{
+			RuleEntry.ErrorReason = Rule->GetErrorReason();
+			RuleEntry.bErrorReasonFormatted = true;
+		}
+	}
+	return RuleEntry.ErrorReason;
+}
+
+SIZE_T FResScannerResultStore::GetAllocatedSize() const
+{
+	SIZE_T Size = RuleEntries.GetAllocatedSize();
+	for (const FRuleEntry& RuleEntry : RuleEntries)
+	{
+		Size += RuleEntry.RuleName.GetAllocatedSize() + RuleEntry.RuleSetName.GetAllocatedSize() + RuleEntry.RuleFingerprint.GetAllocatedSize()
+			+ RuleEntry.ErrorReason.GetAllocatedSize()
+			+ RuleEntry.Assets.GetAllocatedSize();
+	}
+	Size += AssetPackageNames.GetAllocatedSize() + AssetNames.GetAllocatedSize() + AssetClassIds.GetAllocatedSize()
+		+ AssetLastViolations.GetAllocatedSize() + RuleMasks.GetAllocatedSize() + AssetIds.GetAllocatedSize();
+	Size += Classes.GetAllocatedSize() + ClassIds.GetAllocatedSize();
+	Size += ViolationAssets.GetAllocatedSize() + ViolationRules.GetAllocatedSize() + ViolationKeys.GetAllocatedSize()
+		+ ViolationPrevInAsset.GetAllocatedSize();
+	Size += ViolationDetails.GetAllocatedSize() + DetailArena.GetAllocatedSize();
+	return Size;
+}
+
+int32 FResScannerResultStore::FindOrAddAsset(FName PackageName, FName AssetName, const FTopLevelAssetPath& ClassPath)
+{
+	const TPair<FName, FName> AssetKey(PackageName, AssetName);
+	if (const int32* AssetId = AssetIds.Find(AssetKey))
+	{
+		return *AssetId;
+	}
+
+	int32 ClassId;
+	if (const int32* ExistingClassId = ClassIds.Find(ClassPath))
+	{
+		ClassId = *ExistingClassId;
+	}
+	else
+	{
+		ClassId = Classes.Add(ClassPath);
+		ClassIds.Add(ClassPath, ClassId);
+	}
+
+	const int32 AssetId = AssetPackageNames.Add(PackageName);
+	AssetNames.Add(AssetName);
+	AssetClassIds.Add(ClassId);
+	AssetLastViolations.Add(INDEX_NONE);
+	RuleMasks.AddZeroed(RuleMaskWordNum);
+	AssetIds.Add(AssetKey, AssetId);
+	return AssetId;
+}
+
+FResScannerResultStore::FRuleEntry& FResScannerResultStore::AddRuleEntry(const FString& RuleName, const FString& RuleSetName, int32 RuleSetPosition)
+{
+	// 报告中才有的规则排在规则集已有规则的后面，序号不会和已有的规则重复
+	if (RuleSetPosition == INDEX_NONE)
+	{
+		RuleSetPosition = 1;
+		for (const FRuleEntry& RuleEntry : RuleEntries)
+		{
+			if (RuleEntry.RuleSetName == RuleSetName)
+			{
+				RuleSetPosition = FMath::Max(RuleSetPosition, RuleEntry.RuleSetPosition + 1);
+			}
+		}
+	}
+	FRuleEntry& RuleEntry = RuleEntries.AddDefaulted_GetRef();
+	RuleEntry.RuleName = RuleName;
+	RuleEntry.RuleSetName = RuleSetName;
+	RuleEntry.RuleSetPosition = RuleSetPosition;
+	return RuleEntry;
+}
+
+int32 FResScannerResultStore::FindOrAddRule(const FScanResultItem& Result)
+{
+	// 规则名是规则类名，同一个规则集中的多条属性规则类名相同，只靠指纹区分
+	// 没有指纹的旧报告只能再加上错误原因区分
+	for (int32 RuleId = 0; RuleId < RuleEntries.Num(); ++RuleId)
+	{
+		const FRuleEntry& RuleEntry = RuleEntries[RuleId];
+		if (RuleEntry.RuleSetName != Result.RuleSetName || RuleEntry.RuleName != Result.RuleName)
+		{
+			continue;
+		}
+		if (Result.RuleFingerprint.IsEmpty() ? RuleEntry.RuleFingerprint.IsEmpty() && GetRuleErrorReason(RuleId) == Result.ErrorReason
+			: RuleEntry.RuleFingerprint == Result.RuleFingerprint)
+		{
+			return RuleId;
+		}
+	}
+
+	// 报告中的规则没有规则对象，错误原因取第一条结果的
+	FRuleEntry& RuleEntry = AddRuleEntry(Result.RuleName, Result.RuleSetName);
+	RuleEntry.RuleFingerprint = Result.RuleFingerprint;
+	RuleEntry.ErrorReason = Result.ErrorReason;
+	RuleEntry.bErrorReasonFormatted = true;
+	GrowRuleMasks(RuleEntries.Num());
+	return RuleEntries.Num() - 1;
+}
+
+int32 FResScannerResultStore::AddViolation(int32 AssetId, int32 RuleId, uint64 ViolationKey)
+{
+	uint64& MaskWord = RuleMasks[AssetId * RuleMaskWordNum + RuleId / 64];
+	const uint64 RuleBit = 1ull << (RuleId % 64);
+	if (MaskWord & RuleBit)
+	{
+		return INDEX_NONE;
+	}
+	MaskWord |= RuleBit;
+
+	const int32 ViolationIndex = ViolationAssets.Add(AssetId);
+	ViolationRules.Add(RuleId);
+	ViolationKeys.Add(ViolationKey);
+	ViolationPrevInAsset.Add(AssetLastViolations[AssetId]);
+	AssetLastViolations[AssetId] = ViolationIndex;
+	RuleEntries[RuleId].Assets.Add(AssetId);
+	return ViolationIndex;
+}
+
+void FResScannerResultStore::GrowRuleMasks(int32 RuleNum)
+{
+	const int32 NewWordNum = FMath::Max(1, FMath::DivideAndRoundUp(RuleNum, 64));
+	if (NewWordNum <= RuleMaskWordNum)
+	{
+		return;
+	}
+
+	TArray<uint64> NewRuleMasks;
+	NewRuleMasks.SetNumZeroed(AssetPackageNames.Num() * NewWordNum);
+	for (int32 AssetId = 0; AssetId < AssetPackageNames.Num(); ++AssetId)
+	{
+		FMemory::Memcpy(&NewRuleMasks[AssetId * NewWordNum], &RuleMasks[AssetId * RuleMaskWordNum], RuleMaskWordNum * sizeof(uint64));
+	}
+	RuleMasks = MoveTemp(NewRuleMasks);
+	RuleMaskWordNum = NewWordNum;
+}
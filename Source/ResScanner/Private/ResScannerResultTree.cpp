@@ -0,0 +1,390 @@
+#include "ResScannerResultTree.h"
+#include "ResScannerResultStore.h"
+#include "Algo/Sort.h"
+#include "Misc/PackageName.h"
+
+FResScannerResultTree::FResScannerResultTree(const FResScannerResultStore& InResults)
+	: Results(InResults)
+{
+}
+
+void FResScannerResultTree::Reset()
+{
+	RootNodes.Reset();
+	RuleGroups.Reset();
+	ClassGroups.Reset();
+	FolderGroups.Reset();
+	DirtyLists.Reset();
+	ResortNodes.Reset();
+	AssetGroups.Reset();
+	VisibleAssets.Reset();
+	HiddenAssetNum = 0;
+	IndexedAssetNum = 0;
+	IndexedViolationNum = 0;
+}
+
+void FResScannerResultTree::SetGrouping(EResScannerResultGrouping InGrouping)
+{
+	if (Grouping != InGrouping)
+	{
+		Grouping = InGrouping;
+		Reset();
+	}
+}
+
+bool FResScannerResultTree::Update()
+{
+	// 结果存储被清空过（调用方没有调用 Reset）
+	if (Results.GetAssetNum() < IndexedAssetNum || Results.Num() < IndexedViolationNum)
+	{
+		Reset();
+	}
+	if (Results.GetAssetNum() == IndexedAssetNum && Results.Num() == IndexedViolationNum)
+	{
+		return false;
+	}
+
+	// 被过滤掉的资源有了新的违规后可能变成匹配（rules>=2、搜索规则名），连同已有的违规一起加入树中
+	if (HiddenAssetNum > 0)
+	{
+		TArray<int32> ViolationIndices;
+		for (int32 AssetId = 0; AssetId < IndexedAssetNum; ++AssetId)
+		{
+			if (VisibleAssets[AssetId] || !AssetFilter(AssetId))
+			{
+				continue;
+			}
+			VisibleAssets[AssetId] = true;
+			--HiddenAssetNum;
+			AddVisibleAsset(AssetId);
+			ViolationIndices.Reset();
+			Results.GetAssetViolations(AssetId, ViolationIndices);
+			for (const int32 ViolationIndex : ViolationIndices)
+			{
+				// 新增的违规在下面统一加入
+				if (ViolationIndex < IndexedViolationNum)
+				{
+					AddVisibleViolation(ViolationIndex);
+				}
+			}
+		}
+	}
+
+	// 新增的资源
+	AssetGroups.Reserve(Results.GetAssetNum());
+	for (int32 AssetId = IndexedAssetNum; AssetId < Results.GetAssetNum(); ++AssetId)
+	{
+		const bool bVisible = !AssetFilter || AssetFilter(AssetId);
+		VisibleAssets.Add(bVisible);
+		AssetGroups.Add(nullptr);
+		if (bVisible)
+		{
+			AddVisibleAsset(AssetId);
+		}
+		else
+		{
+			++HiddenAssetNum;
+		}
+	}
+
+	// 新增的违规
+	for (int32 ViolationIndex = IndexedViolationNum; ViolationIndex < Results.Num(); ++ViolationIndex)
+	{
+		if (VisibleAssets[Results.GetViolationAsset(ViolationIndex)])
+		{
+			AddVisibleViolation(ViolationIndex);
+		}
+	}
+
+	IndexedAssetNum = Results.GetAssetNum();
+	IndexedViolationNum = Results.Num();
+
+	// 只处理有变化的列表：新节点单独排序后归并到原来的有序部分中，不重排整个列表
+	for (const TPair<FResScannerResultTreeNode*, int32>& DirtyList : DirtyLists)
+	{
+		if (!DirtyList.Key)
+		{
+			MergeNewNodes(RootNodes, DirtyList.Value);
+		}
+		else if (DirtyList.Key->bMaterialized)
+		{
+			MergeNewNodes(DirtyList.Key->Children, DirtyList.Value);
+		}
+	}
+	DirtyLists.Reset();
+	ResortNodes.Reset();
+	return true;
+}
+
+void FResScannerResultTree::AddVisibleAsset(int32 AssetId)
+{
+	// 按目录、类型分组时每个资源只属于一个分组，按规则分组时在加入违规时才确定分组
+	FResScannerResultTreeNode* Group = nullptr;
+	if (Grouping == EResScannerResultGrouping::Folder)
+	{
+		Group = &FindOrAddFolderGroup(FName(*FPackageName::GetLongPackagePath(Results.GetAssetPackageName(AssetId).ToString())));
+	}
+	else if (Grouping == EResScannerResultGrouping::Class)
+	{
+		Group = &FindOrAddClassGroup(Results.GetAssetClass(AssetId));
+	}
+	AssetGroups[AssetId] = Group;
+	if (Group)
+	{
+		AddAssetToGroup(*Group, AssetId);
+		for (FResScannerResultTreeNode* Node = Group; Node; Node = Node->Parent)
+		{
+			Node->AssetNum++;
+			MarkCountChanged(*Node);
+		}
+	}
+}
+
+void FResScannerResultTree::AddVisibleViolation(int32 ViolationIndex)
+{
+	// 按规则分组时每条违规是一个资源节点
+	const int32 AssetId = Results.GetViolationAsset(ViolationIndex);
+	FResScannerResultTreeNode* Group = AssetGroups[AssetId];
+	if (Grouping == EResScannerResultGrouping::Rule)
+	{
+		Group = &FindOrAddRuleGroup(Results.GetViolationRule(ViolationIndex));
+		AddAssetToGroup(*Group, AssetId);
+		Group->AssetNum++;
+	}
+	for (FResScannerResultTreeNode* Node = Group; Node; Node = Node->Parent)
+	{
+		Node->ViolationNum++;
+		MarkCountChanged(*Node);
+	}
+}
+
+void FResScannerResultTree::Materialize(FResScannerResultTreeNode& Node)
+{
+	if (Node.bMaterialized || !Node.IsGroup())
+	{
+		return;
+	}
+	Node.Children.Reset(Node.SubGroups.Num() + Node.AssetIds.Num());
+	Node.Children.Append(Node.SubGroups);
+	for (const int32 AssetId : Node.AssetIds)
+	{
+		Node.Children.Add(MakeAssetNode(Node, AssetId));
+	}
+	SortNodes(Node.Children);
+	Node.bMaterialized = true;
+}
+
+void FResScannerResultTree::SetSortOrder(EResScannerResultSortColumn InSortColumn, bool bInAscending)
+{
+	SortColumn = InSortColumn;
+	bAscending = bInAscending;
+	SortRecursive(RootNodes);
+}
+
+TSharedPtr<FResScannerResultTreeNode> FResScannerResultTree::MakeGroupNode(FString Label, FResScannerResultTreeNode* Parent, int32 RuleId)
+{
+	TSharedPtr<FResScannerResultTreeNode> Node = MakeShared<FResScannerResultTreeNode>();
+	Node->Label = MoveTemp(Label);
+	Node->RuleId = RuleId;
+	Node->Parent = Parent;
+	if (!Parent)
+	{
+		MarkListChanged(nullptr);
+		RootNodes.Add(Node);
+	}
+	else
+	{
+		Parent->SubGroups.Add(Node);
+		if (Parent->bMaterialized)
+		{
+			MarkListChanged(Parent);
+			Parent->Children.Add(Node);
+		}
+	}
+	return Node;
+}
+
+FResScannerResultTreeNode& FResScannerResultTree::FindOrAddRuleGroup(int32 RuleId)
+{
+	if (RuleGroups.Num() <= RuleId)
+	{
+		RuleGroups.SetNum(RuleId + 1);
+	}
+	if (!RuleGroups[RuleId])
+	{
+		// 规则标识和规则集合查询的写法一致，错误原因用来区分同类型的规则
+		RuleGroups[RuleId] = MakeGroupNode(FString::Printf(TEXT("%s %s: %s"), *Results.GetRuleLabel(RuleId), *Results.GetRuleName(RuleId),
+			*Results.GetRuleErrorReason(RuleId)), nullptr, RuleId);
+	}
+	return *RuleGroups[RuleId];
+}
+
+FResScannerResultTreeNode& FResScannerResultTree::FindOrAddClassGroup(const FTopLevelAssetPath& ClassPath)
+{
+	if (const TSharedPtr<FResScannerResultTreeNode>* Group = ClassGroups.Find(ClassPath))
+	{
+		return **Group;
+	}
+	const FString Label = ClassPath.IsValid() ? ClassPath.GetAssetName().ToString() : TEXT("未知类型");
+	return *ClassGroups.Add(ClassPath, MakeGroupNode(Label, nullptr));
+}
+
+FResScannerResultTreeNode& FResScannerResultTree::FindOrAddFolderGroup(FName FolderPath)
+{
+	if (const TSharedPtr<FResScannerResultTreeNode>* Group = FolderGroups.Find(FolderPath))
+	{
+		return **Group;
+	}
+	// 先建立父目录，/Game 这样的顶层目录显示完整路径，子目录只显示目录名
+	const FString FolderPathString = FolderPath.ToString();
+	const FString ParentPath = FPackageName::GetLongPackagePath(FolderPathString);
+	FResScannerResultTreeNode* Parent = ParentPath.IsEmpty() || ParentPath == FolderPathString ? nullptr : &FindOrAddFolderGroup(FName(*ParentPath));
+	const FString Label = Parent ? FolderPathString.RightChop(ParentPath.Len() + 1) : FolderPathString;
+	return *FolderGroups.Add(FolderPath, MakeGroupNode(Label, Parent));
+}
+
+void FResScannerResultTree::AddAssetToGroup(FResScannerResultTreeNode& Group, int32 AssetId)
+{
+	Group.AssetIds.Add(AssetId);
+	if (Group.bMaterialized)
+	{
+		MarkListChanged(&Group);
+		Group.Children.Add(MakeAssetNode(Group, AssetId));
+	}
+}
+
+TSharedPtr<FResScannerResultTreeNode> FResScannerResultTree::MakeAssetNode(FResScannerResultTreeNode& Group, int32 AssetId) const
+{
+	TSharedPtr<FResScannerResultTreeNode> Node = MakeShared<FResScannerResultTreeNode>();
+	Node->AssetId = AssetId;
+	Node->RuleId = Group.RuleId;
+	Node->Parent = &Group;
+	// 生成之后资源又有新的违规时数量不会更新，资源通常只评估一次
+	Node->ViolationNum = Group.RuleId != INDEX_NONE ? 1 : Results.GetAssetViolationNum(AssetId);
+	Node->AssetNum = 1;
+	return Node;
+}
+
+void FResScannerResultTree::MarkCountChanged(FResScannerResultTreeNode& Node)
+{
+	// 按名称排序时计数变化不影响顺序；父分组没有展开时没有子节点列表
+	if (SortColumn != EResScannerResultSortColumn::Name && (!Node.Parent || Node.Parent->bMaterialized))
+	{
+		MarkListChanged(Node.Parent);
+		ResortNodes.Add(&Node);
+	}
+}
+
+void FResScannerResultTree::MarkListChanged(FResScannerResultTreeNode* Owner)
+{
+	// 只记录本次 Update 第一次修改前的长度，之前的节点是有序的
+	if (!DirtyLists.Contains(Owner))
+	{
+		DirtyLists.Add(Owner, Owner ? Owner->Children.Num() : RootNodes.Num());
+	}
+}
+
+bool FResScannerResultTree::IsNodeLess(const FResScannerResultTreeNode& A, const FResScannerResultTreeNode& B) const
+{
+	// 分组总是排在资源前面
+	if (A.IsGroup() != B.IsGroup())
+	{
+		return A.IsGroup();
+	}
+	int32 Order = 0;
+	if (SortColumn == EResScannerResultSortColumn::ViolationNum)
+	{
+		Order = A.ViolationNum - B.ViolationNum;
+	}
+	else if (SortColumn == EResScannerResultSortColumn::AssetNum)
+	{
+		Order = A.AssetNum - B.AssetNum;
+	}
+	if (Order != 0)
+	{
+		return bAscending ? Order < 0 : Order > 0;
+	}
+
+	// 按名称排序，或者计数相同时按名称升序
+	// 资源直接比较 FName，不生成路径字符串
+	Order = A.IsGroup() ? A.Label.Compare(B.Label, ESearchCase::IgnoreCase)
+		: Results.GetAssetPackageName(A.AssetId).Compare(Results.GetAssetPackageName(B.AssetId));
+	return SortColumn == EResScannerResultSortColumn::Name && !bAscending ? Order > 0 : Order < 0;
+}
+
+void FResScannerResultTree::SortNodes(TArray<TSharedPtr<FResScannerResultTreeNode>>& Nodes) const
+{
+	Algo::Sort(Nodes, [this](const TSharedPtr<FResScannerResultTreeNode>& A, const TSharedPtr<FResScannerResultTreeNode>& B)
+	{
+		return IsNodeLess(*A, *B);
+	});
+}
+
+void FResScannerResultTree::MergeNewNodes(TArray<TSharedPtr<FResScannerResultTreeNode>>& Nodes, int32 SortedNum) const
+{
+	// 有序部分中计数变化的分组取出来，和末尾的新节点一起排序
+	// 分组排在资源前面，资源节点生成后计数不再变化，遇到第一个资源节点就可以停止查找
+	TArray<TSharedPtr<FResScannerResultTreeNode>> NewNodes;
+	int32 KeptNum = SortedNum;
+	if (ResortNodes.Num() > 0)
+	{
+		KeptNum = 0;
+		for (int32 Index = 0; Index < SortedNum; ++Index)
+		{
+			if (NewNodes.Num() == 0 && !Nodes[Index]->IsGroup())
+			{
+				KeptNum = SortedNum;
+				break;
+			}
+			if (Nodes[Index]->IsGroup() && ResortNodes.Contains(Nodes[Index].Get()))
+			{
+				NewNodes.Add(MoveTemp(Nodes[Index]));
+			}
+			else
+			{
+				if (KeptNum != Index)
+				{
+					Nodes[KeptNum] = MoveTemp(Nodes[Index]);
+				}
+				++KeptNum;
+			}
+		}
+	}
+	for (int32 Index = SortedNum; Index < Nodes.Num(); ++Index)
+	{
+		NewNodes.Add(MoveTemp(Nodes[Index]));
+	}
+	if (NewNodes.Num() == 0)
+	{
+		return;
+	}
+	SortNodes(NewNodes);
+
+	// 从后往前归并，有序部分中只有插入位置之后的节点需要移动
+	Nodes.SetNum(KeptNum + NewNodes.Num(), false);
+	int32 OldIndex = KeptNum - 1;
+	int32 NewIndex = NewNodes.Num() - 1;
+	for (int32 WriteIndex = Nodes.Num() - 1; NewIndex >= 0; --WriteIndex)
+	{
+		if (OldIndex >= 0 && IsNodeLess(*NewNodes[NewIndex], *Nodes[OldIndex]))
+		{
+			Nodes[WriteIndex] = MoveTemp(Nodes[OldIndex--]);
+		}
+		else
+		{
+			Nodes[WriteIndex] = MoveTemp(NewNodes[NewIndex--]);
+		}
+	}
+}
+
+void FResScannerResultTree::SortRecursive(TArray<TSharedPtr<FResScannerResultTreeNode>>& Nodes) const
+{
+	SortNodes(Nodes);
+	for (const TSharedPtr<FResScannerResultTreeNode>& Node : Nodes)
+	{
+		if (Node->bMaterialized)
+		{
+			SortRecursive(Node->Children);
+		}
+	}
+}
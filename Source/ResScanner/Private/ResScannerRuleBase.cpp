@@ -0,0 +1,27 @@
+#include "ResScannerRuleBase.h"
+#include "Hash/CityHash.h"
+#include "UObject/UnrealType.h"
+
+FString UResScannerRuleBase::GetRuleFingerprint() const
+{
+	// 把规则类型和所有可编辑属性导出成文本再做哈希
+	// 只取 CPF_Edit 的属性，运行时数据（如属性下拉选项）不影响指纹
+	FString FingerprintSource = GetClass()->GetPathName();
+	for (TFieldIterator<FProperty> It(GetClass()); It; ++It)
+	{
+		const FProperty* Prop = *It;
+		// 保存时的处理方式不影响评估结果，修改它不应该丢掉统计数据
+		if (!Prop->HasAnyPropertyFlags(CPF_Edit) || Prop->GetFName() == GET_MEMBER_NAME_CHECKED(UResScannerRuleBase, SaveAction))
+		{
+			continue;
+		}
+		FString ValueText;
+		Prop->ExportTextItem_Direct(ValueText, Prop->ContainerPtrToValuePtr<void>(this), nullptr, nullptr, PPF_None);
+		FingerprintSource += FString::Printf(TEXT("|%s=%s"), *Prop->GetName(), *ValueText);
+	}
+
+	// 按 UTF-8 哈希，TCHAR 的大小和平台有关（Windows 2 字节、Linux/Mac 4 字节）
+	const FTCHARToUTF8 Utf8Source(*FingerprintSource);
+	const uint64 Hash = CityHash64(Utf8Source.Get(), Utf8Source.Length());
+	return FString::Printf(TEXT("%016llx"), Hash);
+}
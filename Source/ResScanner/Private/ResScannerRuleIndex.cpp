@@ -0,0 +1,158 @@
+#include "ResScannerRuleIndex.h"
+#include "ResScannerRuleBase.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+
+void FResScannerRuleIndex::Build(const TArray<UResScannerRuleBase*>& InRules)
+{
+	RuleNum = InRules.Num();
+	PathNodes.Reset();
+	PathNodes.AddDefaulted();		// 根节点
+	RuleScopeClasses.Reset();
+	RuleScopeClasses.SetNum(RuleNum);
+	ClassRuleMaskCache.Reset();
+	CachedPackagePath = NAME_None;
+	CachedPathRules.Reset();
+
+	for (int32 RuleIndex = 0; RuleIndex < RuleNum; ++RuleIndex)
+	{
+		const UResScannerRuleBase* Rule = InRules[RuleIndex];
+		if (!Rule) continue;
+
+		Rule->GetScopeClasses(RuleScopeClasses[RuleIndex]);
+
+		if (Rule->ScopePaths.Num() == 0)
+		{
+			PathNodes[0].RuleIndices.Add(RuleIndex);
+			continue;
+		}
+
+		for (const FDirectoryPath& ScopePath : Rule->ScopePaths)
+		{
+			TArray<FName> Segments;
+			SplitPath(ScopePath.Path, Segments);
+
+			// 沿着目录一级一级往下走，不存在的节点就新建
+			int32 NodeIndex = 0;
+			for (const FName& Segment : Segments)
+			{
+				if (const int32* ChildIndex = PathNodes[NodeIndex].Children.Find(Segment))
+				{
+					NodeIndex = *ChildIndex;
+				}
+				else
+				{
+					// 注意：Add 可能导致 PathNodes 重新分配，不能先取引用再 Add
+					const int32 NewIndex = PathNodes.AddDefaulted();
+					PathNodes[NodeIndex].Children.Add(Segment, NewIndex);
+					NodeIndex = NewIndex;
+				}
+			}
+			PathNodes[NodeIndex].RuleIndices.AddUnique(RuleIndex);
+		}
+	}
+}
+
+void FResScannerRuleIndex::GatherApplicableRules(const FAssetData& AssetData, TArray<int32>& OutRuleIndices)
+{
+	OutRuleIndices.Reset();
+
+	const TArray<int32>& PathRules = GetPathRules(AssetData.PackagePath);
+	if (PathRules.Num() == 0)
+	{
+		return;
+	}
+
+	const TBitArray<>& ClassRuleMask = GetClassRuleMask(AssetData.AssetClassPath);
+	for (int32 RuleIndex : PathRules)
+	{
+		if (ClassRuleMask[RuleIndex])
+		{
+			OutRuleIndices.Add(RuleIndex);
+		}
+	}
+}
+
+void FResScannerRuleIndex::PrecacheClasses(TConstArrayView<FTopLevelAssetPath> ClassPaths)
+{
+	for (const FTopLevelAssetPath& ClassPath : ClassPaths)
+	{
+		GetClassRuleMask(ClassPath);
+	}
+}
+
+const TArray<int32>& FResScannerRuleIndex::GetPathRules(FName PackagePath)
+{
+	if (PackagePath == CachedPackagePath && !CachedPackagePath.IsNone())
+	{
+		return CachedPathRules;
+	}
+	CachedPackagePath = PackagePath;
+	CachedPathRules = PathNodes[0].RuleIndices;
+
+	TArray<FName> Segments;
+	SplitPath(PackagePath.ToString(), Segments);
+	int32 NodeIndex = 0;
+	for (const FName& Segment : Segments)
+	{
+		const int32* ChildIndex = PathNodes[NodeIndex].Children.Find(Segment);
+		if (!ChildIndex)
+		{
+			break;
+		}
+		NodeIndex = *ChildIndex;
+		CachedPathRules.Append(PathNodes[NodeIndex].RuleIndices);
+	}
+
+	// 一条规则可能挂在同一条路径的多个节点上（如 /Game 和 /Game/Textures），去重并恢复规则顺序
+	CachedPathRules.Sort();
+	for (int32 Index = CachedPathRules.Num() - 1; Index > 0; --Index)
+	{
+		if (CachedPathRules[Index] == CachedPathRules[Index - 1])
+		{
+			CachedPathRules.RemoveAt(Index, 1, false);
+		}
+	}
+	return CachedPathRules;
+}
+
+const TBitArray<>& FResScannerRuleIndex::GetClassRuleMask(const FTopLevelAssetPath& ClassPath)
+{
+	if (const TBitArray<>* CachedMask = ClassRuleMaskCache.Find(ClassPath))
+	{
+		return *CachedMask;
+	}
+
+	// 资源类型本身加上它所有的父类（包括蓝图类），从资源注册表中获取，不需要加载类
+	TArray<FTopLevelAssetPath> AncestorClassPaths;
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.GetAncestorClassNames(ClassPath, AncestorClassPaths);
+	AncestorClassPaths.Add(ClassPath);
+
+	TBitArray<> ClassRuleMask(false, RuleNum);
+	for (int32 RuleIndex = 0; RuleIndex < RuleNum; ++RuleIndex)
+	{
+		const TArray<FTopLevelAssetPath>& ScopeClasses = RuleScopeClasses[RuleIndex];
+		bool bApplicable = ScopeClasses.Num() == 0;
+		for (const FTopLevelAssetPath& ScopeClass : ScopeClasses)
+		{
+			if (AncestorClassPaths.Contains(ScopeClass))
+			{
+				bApplicable = true;
+				break;
+			}
+		}
+		ClassRuleMask[RuleIndex] = bApplicable;
+	}
+	return ClassRuleMaskCache.Add(ClassPath, MoveTemp(ClassRuleMask));
+}
+
+void FResScannerRuleIndex::SplitPath(const FString& InPath, TArray<FName>& OutSegments)
+{
+	TArray<FString> Parts;
+	InPath.ParseIntoArray(Parts, TEXT("/"), true);
+	OutSegments.Reset(Parts.Num());
+	for (const FString& Part : Parts)
+	{
+		OutSegments.Add(FName(*Part));
+	}
+}
@@ -0,0 +1,205 @@
+#include "ResScannerRulePreview.h"
+#include "ResScannerRuleBase.h"
+#include "ResScannerEngine.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopedSlowTask.h"
+
+#define LOCTEXT_NAMESPACE "FResScannerModule"
+
+FResScannerRulePreview::FResScannerRulePreview(FName InRootPath)
+	: RootPath(InRootPath)
+{
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FResScannerRulePreview::Tick));
+}
+
+FResScannerRulePreview::~FResScannerRulePreview()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	// 任务线程还在读取快照和规则副本，等它结束
+	bCancelRunning = true;
+	RunningTask.Wait();
+}
+
+void FResScannerRulePreview::RequestUpdate(UResScannerRuleBase* InRule)
+{
+	PendingRule = InRule;
+	LastRequestTime = FPlatformTime::Seconds();
+	bRequestPending = true;
+	// 正在评估的是旧规则，结果已经没有用了
+	bCancelRunning = true;
+}
+
+FText FResScannerRulePreview::GetStatusText() const
+{
+	if (bUnsupported)
+	{
+		return LOCTEXT("RulePreviewUnsupported", "这条规则需要加载资源或者在 GameThread 中评估，不支持实时预览");
+	}
+	if (!bHasResult)
+	{
+		return LOCTEXT("RulePreviewPending", "正在预览...");
+	}
+	const FText ResultText = FText::Format(LOCTEXT("RulePreviewResult", "预览：作用范围内 {0} 个资源中有 {1} 个违反规则（快照共 {2} 个资源，{3} ms）"),
+		FText::AsNumber(Result.InScopeAssetNum), FText::AsNumber(Result.ViolationNum), FText::AsNumber(Result.SnapshotAssetNum),
+		FText::AsNumber(FMath::RoundToInt(Result.Seconds * 1000.0)));
+	return IsUpdating() ? FText::Format(LOCTEXT("RulePreviewUpdating", "{0}，更新中..."), ResultText) : ResultText;
+}
+
+bool FResScannerRulePreview::Tick(float DeltaTime)
+{
+	if (RunningTask.IsValid())
+	{
+		if (!RunningTask.IsCompleted())
+		{
+			return true;
+		}
+		RunningTask = UE::Tasks::FTask();
+		RunningRule.Reset();
+		// 被取消的评估只完成了一部分
+		if (!bCancelRunning)
+		{
+			Result = MoveTemp(RunningResult);
+			bHasResult = true;
+			OnResultUpdated.Broadcast();
+		}
+	}
+
+	if (bRequestPending && FPlatformTime::Seconds() - LastRequestTime >= DebounceSeconds)
+	{
+		bRequestPending = false;
+		Launch();
+	}
+	return true;
+}
+
+void FResScannerRulePreview::BuildSnapshot()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FName> ScanPaths;
+	ScanPaths.Add(RootPath);
+	AssetRegistry.GetSubPaths(RootPath, ScanPaths, true);
+
+	FScopedSlowTask SlowTask(ScanPaths.Num(), LOCTEXT("RulePreviewSnapshot", "正在建立资源注册表快照..."));
+	SlowTask.MakeDialogDelayed(1.0f);
+
+	// 按目录枚举，同一目录的资源连续存放，评估时分发索引的目录缓存命中率高
+	TSet<FTopLevelAssetPath> ClassPaths;
+	for (const FName& ScanPath : ScanPaths)
+	{
+		SlowTask.EnterProgressFrame();
+
+		FARFilter Filter;
+		Filter.PackagePaths.Add(ScanPath);
+		Filter.bRecursivePaths = false;
+		Filter.bIncludeOnlyOnDiskAssets = true;
+		AssetRegistry.EnumerateAssets(Filter, [this, &ClassPaths](const FAssetData& AssetData)
+		{
+			SnapshotAssets.Add(AssetData);
+			ClassPaths.Add(AssetData.AssetClassPath);
+			return true;
+		});
+	}
+	SnapshotClasses = ClassPaths.Array();
+	bSnapshotBuilt = true;
+	UE_LOG(LogResScanner, Log, TEXT("[FResScannerRulePreview] Snapshot of %s: %d assets, %d classes"), *RootPath.ToString(), SnapshotAssets.Num(), SnapshotClasses.Num());
+}
+
+void FResScannerRulePreview::Launch()
+{
+	UResScannerRuleBase* Rule = PendingRule.Get();
+	if (!Rule)
+	{
+		return;
+	}
+	bUnsupported = !Rule->CanMatchOffGameThread();
+	if (bUnsupported)
+	{
+		OnResultUpdated.Broadcast();
+		return;
+	}
+	if (!bSnapshotBuilt)
+	{
+		BuildSnapshot();
+	}
+
+	// 规则副本和分发索引在 GameThread 中准备好，任务线程只读取
+	RunningRule.Reset(DuplicateObject<UResScannerRuleBase>(Rule, GetTransientPackage()));
+	RunningRuleIndex.Build({ RunningRule.Get() });
+	RunningRuleIndex.PrecacheClasses(SnapshotClasses);
+	RunningResult = FResScannerRulePreviewResult();
+	bCancelRunning = false;
+	RunningTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this]() { Evaluate(); });
+}
+
+void FResScannerRulePreview::Evaluate()
+{
+	const double StartTime = FPlatformTime::Seconds();
+	const UResScannerRuleBase* Rule = RunningRule.Get();
+
+	struct FChunkResult
+	{
+		int32 InScopeAssetNum = 0;
+		int32 ViolationNum = 0;
+		TArray<int32, TInlineAllocator<MaxSampleNum>> SampleIndices;
+	};
+	const int32 ChunkNum = FMath::DivideAndRoundUp(SnapshotAssets.Num(), ChunkSize);
+	TArray<FChunkResult> ChunkResults;
+	ChunkResults.SetNum(ChunkNum);
+
+	ParallelFor(ChunkNum, [&](int32 ChunkIndex)
+	{
+		if (bCancelRunning)
+		{
+			return;
+		}
+		// 分发索引内部有目录缓存，每块使用自己的副本（类型缓存已经建立好，不会访问资源注册表）
+		FResScannerRuleIndex ChunkRuleIndex = RunningRuleIndex;
+		TArray<int32> ApplicableRules;
+		FChunkResult& ChunkResult = ChunkResults[ChunkIndex];
+		const int32 AssetEnd = FMath::Min((ChunkIndex + 1) * ChunkSize, SnapshotAssets.Num());
+		for (int32 AssetIndex = ChunkIndex * ChunkSize; AssetIndex < AssetEnd; ++AssetIndex)
+		{
+			const FAssetData& AssetData = SnapshotAssets[AssetIndex];
+			ChunkRuleIndex.GatherApplicableRules(AssetData, ApplicableRules);
+			if (ApplicableRules.Num() == 0)
+			{
+				continue;
+			}
+			++ChunkResult.InScopeAssetNum;
+			// 和扫描一样，工作线程中直接调用 _Implementation
+			bool bMatch = Rule->Match_Implementation(AssetData);
+			if (Rule->bReverseCheck) bMatch = !bMatch;
+			if (bMatch)
+			{
+				++ChunkResult.ViolationNum;
+				if (ChunkResult.SampleIndices.Num() < MaxSampleNum)
+				{
+					ChunkResult.SampleIndices.Add(AssetIndex);
+				}
+			}
+		}
+	});
+	if (bCancelRunning)
+	{
+		return;
+	}
+
+	// 按块的顺序合并，示例资源就是快照顺序中的前几个
+	RunningResult.SnapshotAssetNum = SnapshotAssets.Num();
+	for (const FChunkResult& ChunkResult : ChunkResults)
+	{
+		RunningResult.InScopeAssetNum += ChunkResult.InScopeAssetNum;
+		RunningResult.ViolationNum += ChunkResult.ViolationNum;
+		for (const int32 AssetIndex : ChunkResult.SampleIndices)
+		{
+			if (RunningResult.SampleAssets.Num() < MaxSampleNum)
+			{
+				RunningResult.SampleAssets.Add(SnapshotAssets[AssetIndex].GetSoftObjectPath());
+			}
+		}
+	}
+	RunningResult.Seconds = FPlatformTime::Seconds() - StartTime;
+}
+
+#undef LOCTEXT_NAMESPACE
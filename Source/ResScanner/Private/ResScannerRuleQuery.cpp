@@ -0,0 +1,260 @@
+#include "ResScannerRuleQuery.h"
+#include "ResScannerResultStore.h"
+
+bool FResScannerRuleQuery::Evaluate(const FResScannerResultStore& Results, const FString& Expression, FResScannerBitmap& OutAssets, FString& OutError)
+{
+	FResScannerRuleQuery Query(Results, Expression);
+	OutAssets.Reset();
+	if (!Query.ParseOr(OutAssets))
+	{
+		OutError = Query.Error;
+		return false;
+	}
+	Query.SkipWhitespace();
+	if (Query.Position < Expression.Len())
+	{
+		OutError = FString::Printf(TEXT("第 %d 个字符处多余的内容：%s"), Query.Position + 1, *Expression.RightChop(Query.Position));
+		return false;
+	}
+	return true;
+}
+
+FResScannerRuleQuery::FResScannerRuleQuery(const FResScannerResultStore& InResults, const FString& InExpression)
+	: Results(InResults)
+	, Expression(InExpression)
+{
+}
+
+bool FResScannerRuleQuery::ParseOr(FResScannerBitmap& OutAssets)
+{
+	if (!ParseAnd(OutAssets))
+	{
+		return false;
+	}
+	while (Consume(TEXT('|')))
+	{
+		FResScannerBitmap Right;
+		if (!ParseAnd(Right))
+		{
+			return false;
+		}
+		OutAssets = FResScannerBitmap::Or(OutAssets, Right);
+	}
+	return true;
+}
+
+bool FResScannerRuleQuery::ParseAnd(FResScannerBitmap& OutAssets)
+{
+	if (!ParseUnary(OutAssets))
+	{
+		return false;
+	}
+	while (true)
+	{
+		const bool bAnd = Consume(TEXT('&'));
+		if (!bAnd && !Consume(TEXT('-')))
+		{
+			return true;
+		}
+		FResScannerBitmap Right;
+		if (!ParseUnary(Right))
+		{
+			return false;
+		}
+		OutAssets = bAnd ? FResScannerBitmap::And(OutAssets, Right) : FResScannerBitmap::AndNot(OutAssets, Right);
+	}
+}
+
+bool FResScannerRuleQuery::ParseUnary(FResScannerBitmap& OutAssets)
+{
+	if (Consume(TEXT('!')))
+	{
+		FResScannerBitmap Operand;
+		if (!ParseUnary(Operand))
+		{
+			return false;
+		}
+		// 全集是结果存储中所有有违规的资源
+		OutAssets = FResScannerBitmap::AndNot(FResScannerBitmap::Range(Results.GetAssetNum()), Operand);
+		return true;
+	}
+	if (Consume(TEXT('(')))
+	{
+		if (!ParseOr(OutAssets))
+		{
+			return false;
+		}
+		return Consume(TEXT(')')) || SetError(FString::Printf(TEXT("第 %d 个字符处缺少 )"), Position + 1));
+	}
+	if (Consume(TEXT('#')))
+	{
+		int32 RuleId = 0;
+		if (!ReadNumber(RuleId) || RuleId < 0 || RuleId >= Results.GetRuleNum())
+		{
+			return SetError(FString::Printf(TEXT("第 %d 个字符处的规则编号无效，共有 %d 条规则"), Position + 1, Results.GetRuleNum()));
+		}
+		OutAssets = Results.GetRuleAssets(RuleId);
+		return true;
+	}
+
+	if (Consume(TEXT('"')))
+	{
+		return ParseErrorReason(OutAssets);
+	}
+
+	SkipWhitespace();
+	const int32 NamePosition = Position;
+	const FString Name = ReadIdentifier();
+	if (Name.IsEmpty())
+	{
+		return SetError(Position < Expression.Len()
+			? FString::Printf(TEXT("第 %d 个字符处需要规则：%c"), Position + 1, Expression[Position])
+			: FString(TEXT("表达式不完整，缺少规则")));
+	}
+	if (Name.Equals(TEXT("rules"), ESearchCase::IgnoreCase))
+	{
+		SkipWhitespace();
+		if (Position < Expression.Len() && FCString::Strchr(TEXT("<>=!"), Expression[Position]))
+		{
+			return ParseRuleNum(OutAssets);
+		}
+	}
+
+	// 规则集名#序号 是规则集中的一条规则，只有规则集名时是规则集中的所有规则
+	int32 RuleSetPosition = INDEX_NONE;
+	if (Consume(TEXT('#')) && !ReadNumber(RuleSetPosition))
+	{
+		return SetError(FString::Printf(TEXT("第 %d 个字符处需要规则在规则集中的序号，如 %s#1"), Position + 1, *Name));
+	}
+	bool bFound = false;
+	for (int32 RuleId = 0; RuleId < Results.GetRuleNum(); ++RuleId)
+	{
+		if (Results.GetRuleSetName(RuleId).Equals(Name, ESearchCase::IgnoreCase)
+			&& (RuleSetPosition == INDEX_NONE || Results.GetRuleSetPosition(RuleId) == RuleSetPosition))
+		{
+			OutAssets = bFound ? FResScannerBitmap::Or(OutAssets, Results.GetRuleAssets(RuleId)) : Results.GetRuleAssets(RuleId);
+			bFound = true;
+		}
+	}
+	if (!bFound)
+	{
+		return SetError(RuleSetPosition == INDEX_NONE
+			? FString::Printf(TEXT("第 %d 个字符处的规则集不存在：%s"), NamePosition + 1, *Name)
+			: FString::Printf(TEXT("第 %d 个字符处的规则不存在：规则集 %s 中没有第 %d 条规则"), NamePosition + 1, *Name, RuleSetPosition));
+	}
+	return true;
+}
+
+bool FResScannerRuleQuery::ParseErrorReason(FResScannerBitmap& OutAssets)
+{
+	const int32 TextPosition = Position;
+	const int32 TextEnd = Expression.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, TextPosition);
+	if (TextEnd == INDEX_NONE || TextEnd == TextPosition)
+	{
+		return SetError(FString::Printf(TEXT("第 %d 个字符处需要以 \" 结尾的错误原因"), TextPosition));
+	}
+	const FString Text = Expression.Mid(TextPosition, TextEnd - TextPosition);
+	Position = TextEnd + 1;
+
+	// 错误原因是规则显示给用户的描述，包含这段文字的规则都算
+	bool bFound = false;
+	for (int32 RuleId = 0; RuleId < Results.GetRuleNum(); ++RuleId)
+	{
+		if (Results.GetRuleErrorReason(RuleId).Contains(Text, ESearchCase::IgnoreCase))
+		{
+			OutAssets = bFound ? FResScannerBitmap::Or(OutAssets, Results.GetRuleAssets(RuleId)) : Results.GetRuleAssets(RuleId);
+			bFound = true;
+		}
+	}
+	return bFound || SetError(FString::Printf(TEXT("第 %d 个字符处没有错误原因包含 \"%s\" 的规则"), TextPosition, *Text));
+}
+
+bool FResScannerRuleQuery::ParseRuleNum(FResScannerBitmap& OutAssets)
+{
+	// 比较运算符：两个字符的先匹配
+	static const TCHAR* const Operators[] = { TEXT(">="), TEXT("<="), TEXT("!="), TEXT(">"), TEXT("<"), TEXT("=") };
+	int32 OperatorIndex = 0;
+	for (; OperatorIndex < UE_ARRAY_COUNT(Operators); ++OperatorIndex)
+	{
+		if (FCString::Strncmp(*Expression + Position, Operators[OperatorIndex], FCString::Strlen(Operators[OperatorIndex])) == 0)
+		{
+			Position += FCString::Strlen(Operators[OperatorIndex]);
+			break;
+		}
+	}
+	int32 Number = 0;
+	if (OperatorIndex == UE_ARRAY_COUNT(Operators) || !ReadNumber(Number))
+	{
+		return SetError(FString::Printf(TEXT("第 %d 个字符处需要比较运算符和数字，如 rules>=3"), Position + 1));
+	}
+
+	// 资源编号按升序添加，位图只追加
+	for (int32 AssetId = 0; AssetId < Results.GetAssetNum(); ++AssetId)
+	{
+		const int32 RuleNum = Results.GetAssetRuleNum(AssetId);
+		const bool bMatched = OperatorIndex == 0 ? RuleNum >= Number
+			: OperatorIndex == 1 ? RuleNum <= Number
+			: OperatorIndex == 2 ? RuleNum != Number
+			: OperatorIndex == 3 ? RuleNum > Number
+			: OperatorIndex == 4 ? RuleNum < Number
+			: RuleNum == Number;
+		if (bMatched)
+		{
+			OutAssets.Add(AssetId);
+		}
+	}
+	return true;
+}
+
+void FResScannerRuleQuery::SkipWhitespace()
+{
+	while (Position < Expression.Len() && FChar::IsWhitespace(Expression[Position]))
+	{
+		++Position;
+	}
+}
+
+bool FResScannerRuleQuery::Consume(TCHAR Char)
+{
+	SkipWhitespace();
+	if (Position < Expression.Len() && Expression[Position] == Char)
+	{
+		++Position;
+		return true;
+	}
+	return false;
+}
+
+FString FResScannerRuleQuery::ReadIdentifier()
+{
+	SkipWhitespace();
+	const int32 Start = Position;
+	// 规则集名可能是中文
+	while (Position < Expression.Len() && (FChar::IsAlnum(Expression[Position]) || Expression[Position] == TEXT('_') || Expression[Position] > 127))
+	{
+		++Position;
+	}
+	return Expression.Mid(Start, Position - Start);
+}
+
+bool FResScannerRuleQuery::ReadNumber(int32& OutNumber)
+{
+	SkipWhitespace();
+	const int32 Start = Position;
+	while (Position < Expression.Len() && FChar::IsDigit(Expression[Position]))
+	{
+		++Position;
+	}
+	if (Position == Start)
+	{
+		return false;
+	}
+	LexFromString(OutNumber, *Expression.Mid(Start, Position - Start));
+	return true;
+}
+
+bool FResScannerRuleQuery::SetError(const FString& InError)
+{
+	Error = InError;
+	return false;
+}
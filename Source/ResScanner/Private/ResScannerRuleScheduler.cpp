@@ -0,0 +1,193 @@
+#include "ResScannerRuleScheduler.h"
+#include "ResScannerEngine.h"
+#include "ResScannerRuleBase.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+// 没有历史数据时的默认单次耗时：只读注册表数据的规则约 10 微秒，需要加载资源的规则约 5 毫秒
+static constexpr double DefaultRegistryRuleCost = 0.00001;
+static constexpr double DefaultLoadRuleCost = 0.005;
+
+void FResScannerRuleScheduler::BuildPlan(const FResScannerCompiledRules& InCompiledRules, TArrayView<const FString> RuleFingerprints)
+{
+	const int32 RuleNum = InCompiledRules.Rules.Num();
+	check(RuleFingerprints.Num() == 0 || RuleFingerprints.Num() == RuleNum);
+	PlanFingerprints.Reset();
+	PlanRuleNames.Reset();
+	PlanRequiresLoad.Reset();
+	PlanLogics.Reset();
+
+	for (int32 RuleIndex = 0; RuleIndex < RuleNum; ++RuleIndex)
+	{
+		const UResScannerRuleBase* Rule = InCompiledRules.Rules[RuleIndex];
+		// 指纹要导出所有属性再做哈希，已经算过时直接使用
+		PlanFingerprints.Add(RuleFingerprints.Num() > 0 ? RuleFingerprints[RuleIndex] : Rule->GetRuleFingerprint());
+		PlanRuleNames.Add(FString::Printf(TEXT("[%s] #%d %s"), *InCompiledRules.GetRuleSetName(RuleIndex), RuleIndex, *Rule->GetClass()->GetName()));
+		PlanRequiresLoad.Add(Rule->RequiresAssetLoad());
+		PlanLogics.Add(InCompiledRules.GetRuleLogic(RuleIndex));
+	}
+	Replan();
+}
+
+void FResScannerRuleScheduler::Replan()
+{
+	const int32 RuleNum = PlanFingerprints.Num();
+	PlanOrder.Reset(RuleNum);
+	PlanRanks.Init(MAX_int32, RuleNum);
+	for (int32 RuleIndex = 0; RuleIndex < RuleNum; ++RuleIndex)
+	{
+		PlanOrder.Add(RuleIndex);
+	}
+
+	// 执行一条规则后能确定（它所属规则集）结果的概率
+	auto GetDecisiveProbability = [this](int32 RuleIndex)
+	{
+		const double Selectivity = GetEstimatedSelectivity(RuleIndex);
+		switch (PlanLogics[RuleIndex])
+		{
+		case ERuleSetLogic::AnyViolation:
+			return Selectivity;
+		case ERuleSetLogic::AllViolation:
+			return 1.0 - Selectivity;
+		default:
+			return 1.0;
+		}
+	};
+
+	// 期望开销最小的顺序：按 单次耗时 / 确定结果的概率 从小到大排列
+	// 相同时保持原来的顺序，避免结果顺序无故变化
+	PlanOrder.StableSort([this, &GetDecisiveProbability](int32 A, int32 B)
+	{
+		const double RankA = GetEstimatedCost(A) / FMath::Max(GetDecisiveProbability(A), KINDA_SMALL_NUMBER);
+		const double RankB = GetEstimatedCost(B) / FMath::Max(GetDecisiveProbability(B), KINDA_SMALL_NUMBER);
+		return RankA < RankB;
+	});
+
+	for (int32 Rank = 0; Rank < PlanOrder.Num(); ++Rank)
+	{
+		PlanRanks[PlanOrder[Rank]] = Rank;
+	}
+	UpdatePlanDescription();
+}
+
+void FResScannerRuleScheduler::AccumulateStats(int32 RuleIndex, double Seconds, int64 EvaluatedNum, int64 ViolationNum)
+{
+	if (!PlanFingerprints.IsValidIndex(RuleIndex) || PlanFingerprints[RuleIndex].IsEmpty())
+	{
+		return;
+	}
+	FResScannerRuleStats& Stats = StatsByFingerprint.FindOrAdd(PlanFingerprints[RuleIndex]);
+	Stats.TotalSeconds += Seconds;
+	Stats.EvaluatedNum += EvaluatedNum;
+	Stats.ViolationNum += ViolationNum;
+}
+
+double FResScannerRuleScheduler::GetEstimatedCost(int32 RuleIndex) const
+{
+	const FResScannerRuleStats* Stats = PlanFingerprints.IsValidIndex(RuleIndex) ? FindStats(PlanFingerprints[RuleIndex]) : nullptr;
+	if (Stats && Stats->EvaluatedNum > 0)
+	{
+		return Stats->TotalSeconds / Stats->EvaluatedNum;
+	}
+	return PlanRequiresLoad.IsValidIndex(RuleIndex) && PlanRequiresLoad[RuleIndex] ? DefaultLoadRuleCost : DefaultRegistryRuleCost;
+}
+
+double FResScannerRuleScheduler::GetEstimatedSelectivity(int32 RuleIndex) const
+{
+	const FResScannerRuleStats* Stats = PlanFingerprints.IsValidIndex(RuleIndex) ? FindStats(PlanFingerprints[RuleIndex]) : nullptr;
+	// 拉普拉斯平滑，样本少的时候不会得到 0 或 1 这种极端值
+	const int64 ViolationNum = Stats ? Stats->ViolationNum : 0;
+	const int64 EvaluatedNum = Stats ? Stats->EvaluatedNum : 0;
+	return (ViolationNum + 1.0) / (EvaluatedNum + 2.0);
+}
+
+void FResScannerRuleScheduler::UpdatePlanDescription()
+{
+	if (PlanOrder.Num() == 0)
+	{
+		PlanDescription = TEXT("执行计划：没有可执行的规则");
+		return;
+	}
+
+	FString& Description = PlanDescription;
+	Description = TEXT("执行计划：");
+	for (int32 Rank = 0; Rank < PlanOrder.Num(); ++Rank)
+	{
+		const int32 RuleIndex = PlanOrder[Rank];
+		Description += FString::Printf(TEXT("%s%d. %s [%s, %s%.3f ms, 违规率 %.1f%%]"),
+			Rank == 0 ? TEXT("") : TEXT(" → "),
+			Rank + 1,
+			*PlanRuleNames[RuleIndex],
+			*StaticEnum<ERuleSetLogic>()->GetNameStringByValue(static_cast<int64>(PlanLogics[RuleIndex])),
+			PlanRequiresLoad[RuleIndex] ? TEXT("需加载, ") : TEXT(""),
+			GetEstimatedCost(RuleIndex) * 1000.0,
+			GetEstimatedSelectivity(RuleIndex) * 100.0);
+	}
+}
+
+FString FResScannerRuleScheduler::GetStatsFilePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("ResScanner") / TEXT("RuleStats.json");
+}
+
+void FResScannerRuleScheduler::LoadStats()
+{
+	StatsByFingerprint.Empty();
+
+	FString JsonString;
+	if (!FFileHelper::LoadFileToString(JsonString, *GetStatsFilePath()))
+	{
+		// 第一次使用时没有统计文件，使用默认值即可
+		return;
+	}
+
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[LoadStats] Failed to parse %s"), *GetStatsFilePath());
+		return;
+	}
+
+	const TSharedPtr<FJsonObject>* RulesObject;
+	if (!JsonObject->TryGetObjectField(TEXT("Rules"), RulesObject))
+	{
+		return;
+	}
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : (*RulesObject)->Values)
+	{
+		const TSharedPtr<FJsonObject> StatsJson = Pair.Value->AsObject();
+		if (!StatsJson.IsValid()) continue;
+
+		FResScannerRuleStats& Stats = StatsByFingerprint.Add(Pair.Key);
+		Stats.TotalSeconds = StatsJson->GetNumberField(TEXT("TotalSeconds"));
+		Stats.EvaluatedNum = static_cast<int64>(StatsJson->GetNumberField(TEXT("EvaluatedNum")));
+		Stats.ViolationNum = static_cast<int64>(StatsJson->GetNumberField(TEXT("ViolationNum")));
+	}
+}
+
+void FResScannerRuleScheduler::SaveStats() const
+{
+	TSharedRef<FJsonObject> RulesObject = MakeShareable(new FJsonObject);
+	for (const TPair<FString, FResScannerRuleStats>& Pair : StatsByFingerprint)
+	{
+		TSharedRef<FJsonObject> StatsJson = MakeShareable(new FJsonObject);
+		StatsJson->SetNumberField(TEXT("TotalSeconds"), Pair.Value.TotalSeconds);
+		StatsJson->SetNumberField(TEXT("EvaluatedNum"), static_cast<double>(Pair.Value.EvaluatedNum));
+		StatsJson->SetNumberField(TEXT("ViolationNum"), static_cast<double>(Pair.Value.ViolationNum));
+		RulesObject->SetObjectField(Pair.Key, StatsJson);
+	}
+	TSharedRef<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
+	JsonObject->SetObjectField(TEXT("Rules"), RulesObject);
+
+	FString JsonString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+	FJsonSerializer::Serialize(JsonObject, Writer);
+	if (!FFileHelper::SaveStringToFile(JsonString, *GetStatsFilePath()))
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[SaveStats] Failed to save %s"), *GetStatsFilePath());
+	}
+}
@@ -0,0 +1,88 @@
+#include "ResScannerRuleSet.h"
+#include "ResScannerRuleBase.h"
+#include "Hash/CityHash.h"
+
+void FResScannerCompiledRules::Compile(const TArray<UResScannerRuleSet*>& InRuleSets, bool bRegistryOnly)
+{
+	Compile(InRuleSets, [bRegistryOnly](const UResScannerRuleBase* Rule) { return bRegistryOnly && !CanEvaluateRegistryOnly(Rule); });
+}
+
+const TCHAR* FResScannerSkippedRule::GetReason() const
+{
+	if (bSkippedWithRuleSet)
+	{
+		return TEXT("belongs to an AllViolation rule set with skipped rules");
+	}
+	if (Rule->RequiresAssetLoad())
+	{
+		return TEXT("requires loading assets");
+	}
+	if (!Rule->CanMatchOffGameThread())
+	{
+		return TEXT("must be evaluated on the game thread");
+	}
+	// 调用方按自己的条件跳过（如保存时检查超出耗时预算）
+	return TEXT("excluded by the scan mode");
+}
+
+bool FResScannerCompiledRules::CanEvaluateRegistryOnly(const UResScannerRuleBase* Rule)
+{
+	// 离线扫描在工作线程中并行评估，需要 GameThread 的规则同样不能参与
+	return !Rule->RequiresAssetLoad() && Rule->CanMatchOffGameThread();
+}
+
+void FResScannerCompiledRules::Compile(const TArray<UResScannerRuleSet*>& InRuleSets, TFunctionRef<bool(const UResScannerRuleBase*)> ShouldSkipRule)
+{
+	Rules.Reset();
+	RuleSetIndices.Reset();
+	RuleSetPositions.Reset();
+	RuleSets.Reset();
+	SkippedRules.Reset();
+
+	for (UResScannerRuleSet* InRuleSet : InRuleSets)
+	{
+		if (!InRuleSet || InRuleSet->Rules.Num() == 0)
+		{
+			continue;
+		}
+
+		// AllViolation 要求所有规则都违规，去掉其中的规则会多报，这种规则集只要有被跳过的规则就整个跳过
+		// AnyViolation、Independent 去掉规则只会少报，保留其余规则
+		const bool bSkipRuleSet = InRuleSet->CompositeLogic == ERuleSetLogic::AllViolation
+			&& InRuleSet->Rules.ContainsByPredicate([&ShouldSkipRule](const UResScannerRuleBase* Rule) { return Rule && ShouldSkipRule(Rule); });
+		const int32 RuleSetIndex = bSkipRuleSet ? INDEX_NONE : RuleSets.Add(InRuleSet);
+		int32 RuleSetPosition = 0;
+		for (UResScannerRuleBase* Rule : InRuleSet->Rules)
+		{
+			if (!Rule) continue;
+			++RuleSetPosition;
+			const bool bSkipRule = ShouldSkipRule(Rule);
+			if (bSkipRuleSet || bSkipRule)
+			{
+				FResScannerSkippedRule& SkippedRule = SkippedRules.AddDefaulted_GetRef();
+				SkippedRule.Rule = Rule;
+				SkippedRule.RuleSetName = InRuleSet->RuleSetName;
+				SkippedRule.RuleSetPosition = RuleSetPosition;
+				SkippedRule.bSkippedWithRuleSet = !bSkipRule;
+				continue;
+			}
+			Rules.Add(Rule);
+			RuleSetIndices.Add(RuleSetIndex);
+			RuleSetPositions.Add(RuleSetPosition);
+		}
+	}
+}
+
+FString FResScannerCompiledRules::GetFingerprint() const
+{
+	FString FingerprintSource;
+	for (int32 RuleIndex = 0; RuleIndex < Rules.Num(); ++RuleIndex)
+	{
+		FingerprintSource += FString::Printf(TEXT("%s|%d|%s;"), *GetRuleSetName(RuleIndex),
+			static_cast<int32>(GetRuleLogic(RuleIndex)), *Rules[RuleIndex]->GetRuleFingerprint());
+	}
+	// 按 UTF-8 哈希，TCHAR 的大小和平台有关（Windows 2 字节、Linux/Mac 4 字节）
+	const FTCHARToUTF8 Utf8Source(*FingerprintSource);
+	const uint64 Hash = CityHash64(Utf8Source.Get(), Utf8Source.Length());
+	return FString::Printf(TEXT("%016llx"), Hash);
+}
@@ -0,0 +1,96 @@
+#include "ResScannerSampling.h"
+#include "ResScannerRuleBase.h"
+
+// 95% 置信区间对应的正态分布分位数
+static constexpr double ConfidenceZ = 1.96;
+
+void FResScannerSampleEstimator::Reset(int32 InRuleNum, int32 InSampleSize, int32 InRandomSeed)
+{
+	SampleSize = FMath::Max(1, InSampleSize);
+	RandomStream.Initialize(InRandomSeed);
+	PopulationNum = 0;
+	SampleNum = 0;
+	EstimatedViolations.Reset();
+	EstimatedViolations.SetNumZeroed(InRuleNum);
+	EstimatedVariances.Reset();
+	EstimatedVariances.SetNumZeroed(InRuleNum);
+	SampledViolations.Reset();
+	SampledViolations.SetNumZeroed(InRuleNum);
+}
+
+void FResScannerSampleEstimator::DrawSample(int32 StratumNum, TArray<int32>& OutSampleIndices)
+{
+	OutSampleIndices.Reset(StratumNum);
+	for (int32 Index = 0; Index < StratumNum; ++Index)
+	{
+		OutSampleIndices.Add(Index);
+	}
+	if (StratumNum <= SampleSize)
+	{
+		return;
+	}
+	// 只需要洗前 SampleSize 个位置
+	for (int32 Index = 0; Index < SampleSize; ++Index)
+	{
+		OutSampleIndices.Swap(Index, RandomStream.RandRange(Index, StratumNum - 1));
+	}
+	OutSampleIndices.SetNum(SampleSize, false);
+}
+
+void FResScannerSampleEstimator::AddStratum(int32 StratumNum, int32 InSampleNum, TConstArrayView<int32> RuleViolationNum)
+{
+	if (StratumNum <= 0 || InSampleNum <= 0)
+	{
+		return;
+	}
+	PopulationNum += StratumNum;
+	SampleNum += InSampleNum;
+
+	const double N = StratumNum;
+	const double n = InSampleNum;
+	const double FiniteCorrection = 1.0 - n / N;
+	for (int32 RuleIndex = 0; RuleIndex < EstimatedViolations.Num(); ++RuleIndex)
+	{
+		const double p = RuleViolationNum[RuleIndex] / n;
+		SampledViolations[RuleIndex] += RuleViolationNum[RuleIndex];
+		EstimatedViolations[RuleIndex] += N * p;
+		if (FiniteCorrection <= 0.0)
+		{
+			// 整层都评估了，没有抽样误差
+			continue;
+		}
+		// 只有一个样本时无法估计层内方差，按 p(1-p) 的最大值 0.25 保守估计
+		const double StratumVariance = InSampleNum > 1 ? p * (1.0 - p) * n / (n - 1.0) : 0.25;
+		EstimatedVariances[RuleIndex] += N * N * FiniteCorrection * StratumVariance / n;
+	}
+}
+
+void FResScannerSampleEstimator::GetConfidenceInterval(int32 RuleIndex, double& OutLow, double& OutHigh) const
+{
+	const double HalfWidth = ConfidenceZ * FMath::Sqrt(EstimatedVariances[RuleIndex]);
+	OutLow = FMath::Max(static_cast<double>(SampledViolations[RuleIndex]), EstimatedViolations[RuleIndex] - HalfWidth);
+	OutHigh = FMath::Min(static_cast<double>(PopulationNum), EstimatedViolations[RuleIndex] + HalfWidth);
+}
+
+FString FResScannerSampleEstimator::Describe(const FResScannerCompiledRules& InCompiledRules) const
+{
+	if (!HasEstimates())
+	{
+		return FString();
+	}
+
+	FString Description = FString::Printf(TEXT("抽样估计：共 %lld 个资源，抽取 %lld 个（%.1f%%）"),
+		PopulationNum, SampleNum, PopulationNum > 0 ? 100.0 * SampleNum / PopulationNum : 0.0);
+	for (int32 RuleIndex = 0; RuleIndex < EstimatedViolations.Num() && RuleIndex < InCompiledRules.Rules.Num(); ++RuleIndex)
+	{
+		double Low = 0.0;
+		double High = 0.0;
+		GetConfidenceInterval(RuleIndex, Low, High);
+		Description += FString::Printf(TEXT("\n\t[%s] %s：样本中 %lld 个违规，估计共 %.0f 个（95%% 置信区间 %.0f ~ %.0f）"),
+			*InCompiledRules.GetRuleSetName(RuleIndex),
+			*InCompiledRules.Rules[RuleIndex]->GetClass()->GetName(),
+			SampledViolations[RuleIndex],
+			EstimatedViolations[RuleIndex], Low, High);
+	}
+	return Description;
+}
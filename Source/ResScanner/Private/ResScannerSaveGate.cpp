@@ -0,0 +1,187 @@
+#include "ResScannerSaveGate.h"
+#include "ResScannerSettings.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Misc/Paths.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+#define LOCTEXT_NAMESPACE "FResScannerSaveGate"
+
+FResScannerSaveGate::FResScannerSaveGate(TFunction<void(TArray<UResScannerRuleSet*>&)> InGatherRuleSets)
+	: GatherRuleSets(MoveTemp(InGatherRuleSets))
+{
+	Engine.RuleScheduler.LoadStats();
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FResScannerSaveGate::OnObjectPropertyChanged);
+
+	if (!FCoreUObjectDelegates::IsPackageOKToSaveDelegate.IsBound())
+	{
+		FCoreUObjectDelegates::IsPackageOKToSaveDelegate.BindRaw(this, &FResScannerSaveGate::IsPackageOKToSave);
+		bOwnsSaveDelegate = true;
+	}
+	else
+	{
+		UE_LOG(LogResScanner, Warning, TEXT("[SaveGate] IsPackageOKToSaveDelegate is already bound, rules with SaveAction Block will only warn"));
+		PreSavePackageHandle = UPackage::PreSavePackageWithContextEvent.AddRaw(this, &FResScannerSaveGate::OnPreSavePackage);
+	}
+}
+
+FResScannerSaveGate::~FResScannerSaveGate()
+{
+	if (bOwnsSaveDelegate)
+	{
+		FCoreUObjectDelegates::IsPackageOKToSaveDelegate.Unbind();
+	}
+	UPackage::PreSavePackageWithContextEvent.Remove(PreSavePackageHandle);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(NotificationTickerHandle);
+}
+
+bool FResScannerSaveGate::IsPackageOKToSave(UPackage* Package, const FString& Filename, FOutputDevice* ErrorDevice)
+{
+	// 自动保存写到 Saved/Autosaves 中，不是真正的保存，不检查
+	if (FPaths::IsUnderDirectory(FPaths::ConvertRelativePathToFull(Filename), FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir())))
+	{
+		return true;
+	}
+	return ValidatePackage(Package, true, ErrorDevice);
+}
+
+void FResScannerSaveGate::OnPreSavePackage(UPackage* Package, FObjectPreSaveContext ObjectSaveContext)
+{
+	if (ObjectSaveContext.IsCooking() || ObjectSaveContext.IsProceduralSave())
+	{
+		return;
+	}
+	ValidatePackage(Package, false, nullptr);
+}
+
+bool FResScannerSaveGate::ValidatePackage(UPackage* Package, bool bCanBlock, FOutputDevice* ErrorDevice)
+{
+	const UResScannerSettings* Settings = GetDefault<UResScannerSettings>();
+	if (!Settings->bValidateOnSave || !Package || !Package->GetName().StartsWith(TEXT("/Game/")))
+	{
+		return true;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	PrepareIfRuleSetsChanged();
+	if (Engine.CompiledRules.Rules.Num() == 0)
+	{
+		return true;
+	}
+
+	TArray<FAssetData> PackageAssets;
+	FResScannerEngine::GatherResidentAssets(Package, PackageAssets);
+	Engine.ResetResults();
+	Engine.EvaluateAssets(PackageAssets);
+
+	const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	if (ElapsedMs > Settings->SaveGateBudgetMs)
+	{
+		// 统计数据已经更新，下次保存时重新编译，超过预算的规则会被去掉
+		UE_LOG(LogResScanner, Warning, TEXT("[SaveGate] Validating %s took %.2f ms (budget %.2f ms)"), *Package->GetName(), ElapsedMs, Settings->SaveGateBudgetMs);
+		bRulesChanged = true;
+	}
+	if (Engine.Results.Num() == 0)
+	{
+		return true;
+	}
+
+	bool bBlocked = false;
+	FString Message;
+	const FResScannerResultStore& Results = Engine.Results;
+	for (int32 ViolationIndex = 0; ViolationIndex < Results.Num(); ++ViolationIndex)
+	{
+		const int32 RuleIndex = Results.GetViolationRule(ViolationIndex);
+		const FString AssetPath = Results.GetAssetPath(Results.GetViolationAsset(ViolationIndex));
+		const FString ErrorReason(Results.GetErrorReason(ViolationIndex));
+		const bool bBlockResult = bCanBlock && Engine.CompiledRules.Rules[RuleIndex]->SaveAction == EResScannerSaveAction::Block;
+		bBlocked |= bBlockResult;
+		Message += FString::Printf(TEXT("\n%s %s: %s (%s)"), bBlockResult ? TEXT("[阻止]") : TEXT("[提示]"),
+			*AssetPath, *ErrorReason, *Results.GetRuleSetName(RuleIndex));
+		UE_LOG(LogResScanner, Warning, TEXT("[SaveGate] %s violates %s: %s"), *AssetPath, *Results.GetRuleName(RuleIndex), *ErrorReason);
+	}
+
+	if (bBlocked && ErrorDevice)
+	{
+		ErrorDevice->Logf(ELogVerbosity::Error, TEXT("%s 违反了资源规则，已阻止保存%s"), *Package->GetName(), *Message);
+	}
+
+	// 全部保存时每个资源包都会调用一次，违规先记下来，同一帧中保存的资源包合并成一条通知
+	++PendingPackageNum;
+	PendingBlockedNum += bBlocked ? 1 : 0;
+	PendingMessage += Message;
+	if (!NotificationTickerHandle.IsValid())
+	{
+		NotificationTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FResScannerSaveGate::FlushNotification));
+	}
+	return !bBlocked;
+}
+
+bool FResScannerSaveGate::FlushNotification(float DeltaTime)
+{
+	NotificationTickerHandle.Reset();
+	const bool bBlocked = PendingBlockedNum > 0;
+	FNotificationInfo Info(bBlocked
+		? FText::Format(LOCTEXT("SaveBlocked", "{0} 个资源包违反了资源规则，其中 {1} 个已阻止保存"), FText::AsNumber(PendingPackageNum), FText::AsNumber(PendingBlockedNum))
+		: FText::Format(LOCTEXT("SaveWarned", "{0} 个资源包违反了资源规则"), FText::AsNumber(PendingPackageNum)));
+	Info.SubText = FText::FromString(PendingMessage.TrimStart());
+	Info.ExpireDuration = bBlocked ? 8.0f : 5.0f;
+	Info.bUseSuccessFailIcons = true;
+	if (TSharedPtr<SNotificationItem> Notification = FSlateNotificationManager::Get().AddNotification(Info))
+	{
+		Notification->SetCompletionState(bBlocked ? SNotificationItem::CS_Fail : SNotificationItem::CS_None);
+	}
+	PendingPackageNum = 0;
+	PendingBlockedNum = 0;
+	PendingMessage.Reset();
+	return false;
+}
+
+void FResScannerSaveGate::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// 规则是规则集的 Instanced 子对象，修改规则时收到的可能是规则，也可能是规则集
+	if (Object && (Object->IsA<UResScannerRuleSet>() || Object->IsA<UResScannerRuleBase>()))
+	{
+		bRulesChanged = true;
+	}
+}
+
+void FResScannerSaveGate::PrepareIfRuleSetsChanged()
+{
+	TArray<UResScannerRuleSet*> RuleSets;
+	GatherRuleSets(RuleSets);
+
+	// 每次保存只比较规则集指针，不再计算所有规则的指纹
+	bool bRuleSetsChanged = bRulesChanged || RuleSets.Num() != PreparedRuleSets.Num();
+	for (int32 RuleSetIndex = 0; !bRuleSetsChanged && RuleSetIndex < RuleSets.Num(); ++RuleSetIndex)
+	{
+		bRuleSetsChanged = PreparedRuleSets[RuleSetIndex] != RuleSets[RuleSetIndex];
+	}
+	if (!bRuleSetsChanged)
+	{
+		return;
+	}
+	PreparedRuleSets.Reset(RuleSets.Num());
+	for (UResScannerRuleSet* PreparedRuleSet : RuleSets)
+	{
+		PreparedRuleSets.Add(PreparedRuleSet);
+	}
+	bRulesChanged = false;
+
+	const double BudgetSeconds = GetDefault<UResScannerSettings>()->SaveGateBudgetMs / 1000.0;
+	Engine.Prepare(RuleSets, [this, BudgetSeconds](const UResScannerRuleBase* Rule)
+	{
+		if (Rule->SaveAction == EResScannerSaveAction::Ignore)
+		{
+			return true;
+		}
+		const FResScannerRuleStats* Stats = Engine.RuleScheduler.FindStats(Rule->GetRuleFingerprint());
+		return Stats && Stats->EvaluatedNum > 0 && Stats->TotalSeconds / Stats->EvaluatedNum > BudgetSeconds;
+	});
+	UE_LOG(LogResScanner, Log, TEXT("[SaveGate] Prepared %d rules, %d skipped (SaveAction Ignore or over budget)"),
+		Engine.CompiledRules.Rules.Num(), Engine.CompiledRules.SkippedRules.Num());
+}
+
+#undef LOCTEXT_NAMESPACE
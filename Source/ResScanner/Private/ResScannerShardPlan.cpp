@@ -0,0 +1,107 @@
+#include "ResScannerShardPlan.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+
+// 每个分片最多被拆成多少组，用来计算组的大小上限，越大分片越均匀，但共享依赖的资源包越容易被分开
+static constexpr int32 GroupsPerShard = 4;
+
+void FResScannerShardPlan::Build(const TArray<FName>& InPackageNames, int32 ShardNum)
+{
+	Shards.Reset();
+	ShardNum = FMath::Max(1, ShardNum);
+	Shards.SetNum(ShardNum);
+	if (InPackageNames.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 PackageNum = InPackageNames.Num();
+	const int32 MaxGroupSize = FMath::Max(1, PackageNum / (ShardNum * GroupsPerShard));
+
+	// 并查集
+	TArray<int32> Parents;
+	TArray<int32> GroupSizes;
+	Parents.SetNumUninitialized(PackageNum);
+	GroupSizes.Init(1, PackageNum);
+	for (int32 Index = 0; Index < PackageNum; ++Index)
+	{
+		Parents[Index] = Index;
+	}
+	auto FindRoot = [&Parents](int32 Index)
+	{
+		while (Parents[Index] != Index)
+		{
+			Parents[Index] = Parents[Parents[Index]];
+			Index = Parents[Index];
+		}
+		return Index;
+	};
+	auto TryUnion = [&](int32 A, int32 B)
+	{
+		A = FindRoot(A);
+		B = FindRoot(B);
+		if (A == B || GroupSizes[A] + GroupSizes[B] > MaxGroupSize)
+		{
+			return;
+		}
+		if (GroupSizes[A] < GroupSizes[B])
+		{
+			Swap(A, B);
+		}
+		Parents[B] = A;
+		GroupSizes[A] += GroupSizes[B];
+	};
+
+	// 依赖 -> 第一个引用它的资源包（依赖本身在列表中时就是它自己）
+	TMap<FName, int32> DependencyOwners;
+	DependencyOwners.Reserve(PackageNum);
+	for (int32 Index = 0; Index < PackageNum; ++Index)
+	{
+		DependencyOwners.Add(InPackageNames[Index], Index);
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FName> Dependencies;
+	for (int32 Index = 0; Index < PackageNum; ++Index)
+	{
+		Dependencies.Reset();
+		// 只看硬依赖，软引用加载资源时不会一起加载
+		AssetRegistry.GetDependencies(InPackageNames[Index], Dependencies,
+			UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+		for (const FName& Dependency : Dependencies)
+		{
+			if (const int32* Owner = DependencyOwners.Find(Dependency))
+			{
+				TryUnion(Index, *Owner);
+			}
+			else
+			{
+				DependencyOwners.Add(Dependency, Index);
+			}
+		}
+	}
+
+	TMap<int32, TArray<FName>> Groups;
+	for (int32 Index = 0; Index < PackageNum; ++Index)
+	{
+		Groups.FindOrAdd(FindRoot(Index)).Add(InPackageNames[Index]);
+	}
+	TArray<TArray<FName>> SortedGroups;
+	Groups.GenerateValueArray(SortedGroups);
+	SortedGroups.Sort([](const TArray<FName>& A, const TArray<FName>& B)
+	{
+		return A.Num() > B.Num();
+	});
+
+	for (TArray<FName>& Group : SortedGroups)
+	{
+		int32 SmallestShard = 0;
+		for (int32 ShardIndex = 1; ShardIndex < ShardNum; ++ShardIndex)
+		{
+			if (Shards[ShardIndex].Num() < Shards[SmallestShard].Num())
+			{
+				SmallestShard = ShardIndex;
+			}
+		}
+		Shards[SmallestShard].Append(MoveTemp(Group));
+	}
+}
@@ -0,0 +1,65 @@
+#include "TagMatchRuleExecutor.h"
+
+bool UTagMatchRuleExecutor::Match_Implementation(const FAssetData& AssetData) const
+{
+	if (RuleData.TagRules.Num() == 0)
+	{
+		return false;
+	}
+	for (const FTagRule& TagRule : RuleData.TagRules)
+	{
+		if (!EvaluateSingleRule(AssetData, TagRule))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FString UTagMatchRuleExecutor::GetErrorReason_Implementation() const
+{
+	static const TCHAR* MatchModeTexts[] = { TEXT("=="), TEXT("!="), TEXT("包含"), TEXT(">"), TEXT("<") };
+	FString Reason = TEXT("标签");
+	for (const FTagRule& TagRule : RuleData.TagRules)
+	{
+		Reason += FString::Printf(TEXT(" %s %s %s;"), *TagRule.TagName.ToString(), MatchModeTexts[static_cast<int32>(TagRule.MatchMode)], *TagRule.Value);
+	}
+	return Reason;
+}
+
+bool UTagMatchRuleExecutor::CanMatchOffGameThread() const
+{
+	// 如果是蓝图子类，Match 可能被蓝图覆盖，蓝图只能在 GameThread 中执行
+	return GetClass()->HasAnyClassFlags(CLASS_Native);
+}
+
+bool UTagMatchRuleExecutor::EvaluateSingleRule(const FAssetData& AssetData, const FTagRule& TagRule)
+{
+	FString TagValue;
+	if (!AssetData.GetTagValue(TagRule.TagName, TagValue))
+	{
+		return false;
+	}
+
+	switch (TagRule.MatchMode)
+	{
+	case ETagMatchMode::Equal:
+		return TagValue == TagRule.Value;
+	case ETagMatchMode::NotEqual:
+		return TagValue != TagRule.Value;
+	case ETagMatchMode::Contain:
+		return TagValue.Contains(TagRule.Value);
+	case ETagMatchMode::Greater:
+	case ETagMatchMode::Less:
+		{
+			double TagNumber = 0.0;
+			double RuleNumber = 0.0;
+			if (!LexTryParseString(TagNumber, *TagValue) || !LexTryParseString(RuleNumber, *TagRule.Value))
+			{
+				return false;
+			}
+			return TagRule.MatchMode == ETagMatchMode::Greater ? TagNumber > RuleNumber : TagNumber < RuleNumber;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,122 @@
+#include "ResScannerBitmap.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ResScannerBitmapTests
+{
+	TArray<uint32> ToArray(const FResScannerBitmap& Bitmap)
+	{
+		TArray<uint32> Values;
+		Bitmap.ForEach([&Values](uint32 Value) { Values.Add(Value); });
+		return Values;
+	}
+
+	TArray<uint32> ToSortedArray(const TSet<uint32>& Set)
+	{
+		TArray<uint32> Values = Set.Array();
+		Values.Sort();
+		return Values;
+	}
+
+	// 按概率生成集合，Probability 高时得到位图块，低时得到数组块
+	void MakeRandomSet(FRandomStream& Random, uint32 Count, float Probability, FResScannerBitmap& OutBitmap, TSet<uint32>& OutSet)
+	{
+		for (uint32 Value = 0; Value < Count; ++Value)
+		{
+			if (Random.FRand() < Probability)
+			{
+				OutBitmap.Add(Value);
+				OutSet.Add(Value);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResScannerBitmapAddTest, "ResScanner.Bitmap.Add",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FResScannerBitmapAddTest::RunTest(const FString& Parameters)
+{
+	using namespace ResScannerBitmapTests;
+
+	FResScannerBitmap Empty;
+	TestTrue(TEXT("Empty bitmap"), Empty.IsEmpty());
+	TestEqual(TEXT("Empty bitmap num"), Empty.Num(), int64(0));
+	TestFalse(TEXT("Empty bitmap contains"), Empty.Contains(0));
+
+	// 乱序、重复添加，遍历仍然是升序且没有重复
+	FResScannerBitmap Unordered;
+	for (const uint32 Value : { 70000u, 7u, 3u, 65536u, 7u, 0u })
+	{
+		Unordered.Add(Value);
+	}
+	TestEqual(TEXT("Unordered values"), ToArray(Unordered), TArray<uint32>({ 0u, 3u, 7u, 65536u, 70000u }));
+	TestEqual(TEXT("Unordered num"), Unordered.Num(), int64(5));
+
+	// 同一块超过 4096 个元素时转换为位图块
+	FResScannerBitmap Dense;
+	for (uint32 Value = 0; Value < 20000; Value += 2)
+	{
+		Dense.Add(Value);
+	}
+	TestEqual(TEXT("Dense num"), Dense.Num(), int64(10000));
+	TestTrue(TEXT("Dense contains even"), Dense.Contains(19998));
+	TestFalse(TEXT("Dense does not contain odd"), Dense.Contains(19999));
+	Dense.Add(19998);
+	TestEqual(TEXT("Dense duplicate add"), Dense.Num(), int64(10000));
+
+	FResScannerBitmap Range = FResScannerBitmap::Range(70000);
+	TestEqual(TEXT("Range num"), Range.Num(), int64(70000));
+	TestTrue(TEXT("Range contains last"), Range.Contains(69999));
+	TestFalse(TEXT("Range does not contain end"), Range.Contains(70000));
+	TestTrue(TEXT("Empty range"), FResScannerBitmap::Range(0).IsEmpty());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResScannerBitmapSetOperationsTest, "ResScanner.Bitmap.SetOperations",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FResScannerBitmapSetOperationsTest::RunTest(const FString& Parameters)
+{
+	using namespace ResScannerBitmapTests;
+
+	// 稠密和稀疏的集合两两组合，覆盖位图块和数组块之间的所有运算，结果和 TSet 比较
+	static const float Probabilities[] = { 0.6f, 0.01f, 0.3f };
+	FRandomStream Random(1234);
+	FResScannerBitmap Bitmaps[UE_ARRAY_COUNT(Probabilities)];
+	TSet<uint32> Sets[UE_ARRAY_COUNT(Probabilities)];
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Probabilities); ++Index)
+	{
+		MakeRandomSet(Random, 200000, Probabilities[Index], Bitmaps[Index], Sets[Index]);
+	}
+
+	for (int32 AIndex = 0; AIndex < UE_ARRAY_COUNT(Probabilities); ++AIndex)
+	{
+		for (int32 BIndex = 0; BIndex < UE_ARRAY_COUNT(Probabilities); ++BIndex)
+		{
+			const TSet<uint32>& A = Sets[AIndex];
+			const TSet<uint32>& B = Sets[BIndex];
+			const FString Context = FString::Printf(TEXT("%.2f/%.2f"), Probabilities[AIndex], Probabilities[BIndex]);
+
+			const FResScannerBitmap And = FResScannerBitmap::And(Bitmaps[AIndex], Bitmaps[BIndex]);
+			TestEqual(*(Context + TEXT(" And")), ToArray(And), ToSortedArray(A.Intersect(B)));
+			TestEqual(*(Context + TEXT(" And num")), And.Num(), int64(A.Intersect(B).Num()));
+
+			const FResScannerBitmap Or = FResScannerBitmap::Or(Bitmaps[AIndex], Bitmaps[BIndex]);
+			TestEqual(*(Context + TEXT(" Or")), ToArray(Or), ToSortedArray(A.Union(B)));
+			TestEqual(*(Context + TEXT(" Or num")), Or.Num(), int64(A.Union(B).Num()));
+
+			const FResScannerBitmap AndNot = FResScannerBitmap::AndNot(Bitmaps[AIndex], Bitmaps[BIndex]);
+			TestEqual(*(Context + TEXT(" AndNot")), ToArray(AndNot), ToSortedArray(A.Difference(B)));
+			TestEqual(*(Context + TEXT(" AndNot num")), AndNot.Num(), int64(A.Difference(B).Num()));
+		}
+	}
+
+	// 结果为空的运算不留下空块
+	TestTrue(TEXT("AndNot self is empty"), FResScannerBitmap::AndNot(Bitmaps[0], Bitmaps[0]).IsEmpty());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
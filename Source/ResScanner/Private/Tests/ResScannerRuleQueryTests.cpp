@@ -0,0 +1,161 @@
+#include "ResScannerRuleQuery.h"
+#include "ResScannerEngine.h"
+#include "ResScannerResultStore.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ResScannerRuleQueryTests
+{
+	struct FTestRule
+	{
+		const TCHAR* RuleSetName;
+		const TCHAR* Fingerprint;
+		const TCHAR* ErrorReason;
+	};
+
+	// #0 Art#1、#1 Art#2 是同一个类型的两条属性规则，类名相同，只能按规则集序号或错误原因区分
+	const FTestRule TestRules[] =
+	{
+		{ TEXT("Art"), TEXT("a1"), TEXT("Texture is too large") },
+		{ TEXT("Art"), TEXT("a2"), TEXT("Texture compression is missing") },
+		{ TEXT("TechArt"), TEXT("t1"), TEXT("Asset name does not follow the convention") },
+	};
+
+	// 每个资源违反的规则编号，资源编号就是下标
+	const TArray<TArray<int32>> TestAssetRules =
+	{
+		{ 0, 1 },
+		{ 0 },
+		{ 1, 2 },
+		{ 2 },
+		{ 0, 1, 2 },
+	};
+
+	void BuildResults(FResScannerResultStore& OutResults)
+	{
+		for (int32 AssetId = 0; AssetId < TestAssetRules.Num(); ++AssetId)
+		{
+			for (const int32 RuleId : TestAssetRules[AssetId])
+			{
+				FScanResultItem Result;
+				Result.AssetPath = FString::Printf(TEXT("/Game/Test/Asset%d.Asset%d"), AssetId, AssetId);
+				Result.AssetClass = TEXT("/Script/Engine.Texture2D");
+				Result.RuleName = TEXT("PropertyMatchRule");
+				Result.RuleSetName = TestRules[RuleId].RuleSetName;
+				Result.RuleFingerprint = TestRules[RuleId].Fingerprint;
+				Result.ErrorReason = TestRules[RuleId].ErrorReason;
+				Result.ViolationKey = (uint64(AssetId) << 32) | uint64(RuleId);
+				OutResults.Add(Result);
+			}
+		}
+	}
+
+	TArray<uint32> ToArray(const FResScannerBitmap& Bitmap)
+	{
+		TArray<uint32> Values;
+		Bitmap.ForEach([&Values](uint32 Value) { Values.Add(Value); });
+		return Values;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResScannerRuleQueryEvaluateTest, "ResScanner.RuleQuery.Evaluate",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FResScannerRuleQueryEvaluateTest::RunTest(const FString& Parameters)
+{
+	using namespace ResScannerRuleQueryTests;
+
+	FResScannerResultStore Results;
+	BuildResults(Results);
+	if (!TestEqual(TEXT("Rule num"), Results.GetRuleNum(), int32(UE_ARRAY_COUNT(TestRules)))
+		|| !TestEqual(TEXT("Asset num"), Results.GetAssetNum(), TestAssetRules.Num()))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Rule label"), Results.GetRuleLabel(1), FString(TEXT("#1 Art#2")));
+	TestEqual(TEXT("Rule label in another rule set"), Results.GetRuleLabel(2), FString(TEXT("#2 TechArt#1")));
+
+	struct FQueryCase
+	{
+		const TCHAR* Expression;
+		TArray<uint32> ExpectedAssets;
+	};
+	const FQueryCase Cases[] =
+	{
+		{ TEXT("#2"), { 2, 3, 4 } },
+		{ TEXT("Art#1"), { 0, 1, 4 } },
+		{ TEXT("art#2"), { 0, 2, 4 } },
+		{ TEXT("Art"), { 0, 1, 2, 4 } },
+		{ TEXT("\"compression\""), { 0, 2, 4 } },
+		{ TEXT("\"Texture\""), { 0, 1, 2, 4 } },
+		{ TEXT("Art#1 - Art#2"), { 1 } },
+		{ TEXT("Art#1 & Art#2"), { 0, 4 } },
+		{ TEXT("Art#1 | #2"), { 0, 1, 2, 3, 4 } },
+		{ TEXT("!Art#1"), { 2, 3 } },
+		{ TEXT("!!Art#1"), { 0, 1, 4 } },
+		{ TEXT("rules>=2"), { 0, 2, 4 } },
+		{ TEXT("rules = 3"), { 4 } },
+		{ TEXT("rules<2"), { 1, 3 } },
+		{ TEXT("rules!=1"), { 0, 2, 4 } },
+		// & - 的优先级高于 |
+		{ TEXT("Art#1 | TechArt - Art#2"), { 0, 1, 3, 4 } },
+		{ TEXT("(Art#1 | TechArt) - Art#2"), { 1, 3 } },
+		{ TEXT("  ( #0 & #1 )&!#2 "), { 0 } },
+	};
+	for (const FQueryCase& Case : Cases)
+	{
+		FResScannerBitmap Assets;
+		FString Error;
+		if (TestTrue(*FString::Printf(TEXT("Parse \"%s\""), Case.Expression), FResScannerRuleQuery::Evaluate(Results, Case.Expression, Assets, Error)))
+		{
+			TestEqual(*FString::Printf(TEXT("Assets of \"%s\""), Case.Expression), ToArray(Assets), Case.ExpectedAssets);
+		}
+		else
+		{
+			AddInfo(Error);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResScannerRuleQueryErrorTest, "ResScanner.RuleQuery.Errors",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FResScannerRuleQueryErrorTest::RunTest(const FString& Parameters)
+{
+	using namespace ResScannerRuleQueryTests;
+
+	FResScannerResultStore Results;
+	BuildResults(Results);
+
+	// 规则类名不是规则标识，多条属性规则不能靠它区分
+	const TCHAR* const InvalidExpressions[] =
+	{
+		TEXT(""),
+		TEXT("PropertyMatchRule"),
+		TEXT("Art#3"),
+		TEXT("Art#"),
+		TEXT("Build"),
+		TEXT("#3"),
+		TEXT("#"),
+		TEXT("\"not found\""),
+		TEXT("\"unterminated"),
+		TEXT("Art#1 &"),
+		TEXT("(Art#1"),
+		TEXT("Art#1 )"),
+		TEXT("Art#1 Art#2"),
+		TEXT("rules>"),
+		TEXT("rules=>2"),
+	};
+	for (const TCHAR* Expression : InvalidExpressions)
+	{
+		FResScannerBitmap Assets;
+		FString Error;
+		TestFalse(*FString::Printf(TEXT("Reject \"%s\""), Expression), FResScannerRuleQuery::Evaluate(Results, Expression, Assets, Error));
+		TestFalse(*FString::Printf(TEXT("Error message of \"%s\""), Expression), Error.IsEmpty());
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
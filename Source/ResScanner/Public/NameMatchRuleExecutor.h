@@ -21,6 +21,9 @@ public:
 
 	virtual EScanRuleType GetRuleType() const override;
 
+	// 名字规则只读取 AssetName，可以在工作线程中并行评估
+	virtual bool CanMatchOffGameThread() const override;
+
 public:
 	// 规则数据
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResScanner")
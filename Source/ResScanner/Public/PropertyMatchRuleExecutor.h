@@ -16,6 +16,12 @@ public:
 	// 注意这里只需要实现基类中的 虚函数  Match_Implementation
 	virtual bool Match_Implementation(const FAssetData& AssetData) const override;
 	virtual FString GetErrorReason_Implementation() const override;
+
+	// 属性规则需要加载资源才能读取属性值
+	virtual bool RequiresAssetLoad() const override { return true; }
+
+	// 资源不是 TargetClass 时属性规则一定不匹配，所以 TargetClass 就是隐含的作用类型
+	virtual void GetScopeClasses(TArray<FTopLevelAssetPath>& OutClassPaths) const override;
 	
 public:
 	// 属性规则数据
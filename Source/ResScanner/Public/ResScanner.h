@@ -2,20 +2,31 @@
 
 #pragma once
 
-#include "ResScannerRuleSet.h"
+#include "ResScannerEngine.h"
+#include "Containers/Ticker.h"
+#include "Tasks/Task.h"
+#include "ResScannerSampling.h"
+#include "ResScannerResultTree.h"
+#include "ResScannerResultSearch.h"
+#include "ResScannerBitmap.h"
+#include "Widgets/Views/STreeView.h"
+
+class FResScannerCookValidator;
+class FResScannerSaveGate;
 
 class FToolBarBuilder;
 class FMenuBuilder;
+class FJsonObject;
 
-struct FScanResultItem
+// 扫描模式
+enum class EResScanMode : uint8
 {
-	FString AssetPath;
-	FString RuleName;
-	FString ErrorReason;
+	// 评估所有资源
+	Full,
+	// 分层抽样评估，估计每条规则的违规数量
+	Sampled
 };
 
-DECLARE_LOG_CATEGORY_EXTERN(LogResScanner, Log, All)
-
 class FResScannerModule : public IModuleInterface
 {
 public:
@@ -31,6 +42,11 @@ public:
 public:
 	// 模块共享指针引用
 	//TSharedPtr<FResScannerModule> SharedThis;
+
+	// 读取 SerializeRuleSetToJson 导出的规则集，命令行（UResScannerCommandlet）也使用
+	// LoadRuleSetFromFile 返回的规则集已经 AddToRoot，不用时需要 RemoveFromRoot
+	static bool DeserializeRuleSetFromJson(const FString& InJsonStr, UResScannerRuleSet* OutRuleSet);
+	static UResScannerRuleSet* LoadRuleSetFromFile(const FString& FilePath);
 	
 private:
 
@@ -44,6 +60,18 @@ private:
 	FReply OnImportConfigClicked();
 	// 导出配置按钮点击事件
 	FReply OnExportConfigClicked();
+	// 追加规则集按钮点击事件
+	FReply OnAppendRuleSetClicked();
+	// 导出结果按钮点击事件：把当前的扫描结果写成 NDJSON、CSV、SARIF 或者 JUnit
+	FReply OnExportResultsClicked();
+	// 记录基线按钮点击事件：把当前的违规记录为已知违规，之后的扫描不再显示
+	FReply OnRecordBaselineClicked();
+	// 历史趋势按钮点击事件：从扫描历史中查询最近几次完整扫描的违规数量变化
+	FReply OnShowTrendClicked();
+	// 打开扫描历史数据库，打开失败返回 false
+	bool OpenScanHistory();
+	// 预估按钮点击事件：不评估规则，只根据注册表和历史统计数据预估扫描开销
+	FReply OnExplainScanClicked();
 
 	// 添加规则
 	FReply OnAddNewRule();
@@ -51,14 +79,69 @@ private:
 
 	// 生成列表每一行
 	// 这个函数用来告诉 Slate 每一行怎么渲染
-	TSharedRef<ITableRow> OnGenerateResultRow(TSharedPtr<FScanResultItem> InItem, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> OnGenerateResultRow(TSharedPtr<FResScannerResultTreeNode> InItem, const TSharedRef<STableViewBase>& OwnerTable);
+	// 结果树的子节点，分组展开时才生成资源节点
+	void OnGetResultChildren(TSharedPtr<FResScannerResultTreeNode> InItem, TArray<TSharedPtr<FResScannerResultTreeNode>>& OutChildren);
+	// 结果树的排序
+	EColumnSortMode::Type GetResultSortMode(FName ColumnId) const;
+	void OnResultSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type SortMode);
+	// 把结果存储中新增的结果加入搜索索引和结果树，并刷新结果树
+	void RefreshResultTree();
+	// 搜索框输入变化时重新查询，结果树只显示匹配的资源
+	void OnResultSearchTextChanged(const FText& InSearchText);
+	// 规则集合查询提交时求值，结果树只显示查询匹配的资源
+	void OnRuleQueryCommitted(const FText& InQueryText, ETextCommit::Type CommitType);
+	// 求当前的规则集合查询，结果存储有新增的违规时才重新求值
+	void EvaluateRuleQuery();
 	TSharedRef<ITableRow> OnGenerateRuleRow(
 		UResScannerRuleBase* InItem, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> OnGenerateRuleSetRow(
+		UResScannerRuleSet* InItem, const TSharedRef<STableViewBase>& OwnerTable);
 
 	// TODO: 开始扫描资源
-	void RunAssetScan();
+	void RunAssetScan(EResScanMode InScanMode = EResScanMode::Full);
+	// 抽样模式：把 AssetChunk 中的资源按类型分层，每层抽样评估
+	void EvaluateSampledChunk();
+	// 是否超过了扫描预算（时间或者资源数量）
+	bool IsScanBudgetExhausted() const;
+	// 分帧扫描普通通道的目录，以及扫描期间新发现的资源
+	bool TickAssetScan(float DeltaTime);
+	void ScanNextPath();
+	// 停止正在进行的扫描
+	void StopAssetScan();
+	// 扫描结束：取消订阅，保存统计数据，刷新列表
+	void EndAssetScan();
+
+	// 优先通道：最近修改、未保存、正在编辑、当前关卡引用的资源
+	// 最近修改的资源文件需要遍历整个 Content 目录，在后台任务中查找（见 RecentPackagesTask）
+	void GatherPriorityPackages(TSet<FName>& OutPackageNames);
+	void ScanPriorityPackages(const TSet<FName>& PackageNames);
+	// 后台查找完最近修改的资源文件后，评估其中所在目录还没有扫描到的资源包
+	void ScanRecentPackages();
+	// 在任务线程中执行
+	static TArray<FName> GatherRecentlyModifiedPackages(const FString& ContentDir, const FDateTime& ModifiedAfter);
+	void OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext ObjectSaveContext);
+
+	// 内容浏览器资源格子上的违规标记和提示，标记在显示时按资源名查找结果存储，扫描过程中实时更新
+	TSharedRef<SWidget> OnGenerateAssetViolationBadge(const FAssetData& AssetData);
+	TSharedRef<SWidget> OnGenerateAssetViolationToolTip(const FAssetData& AssetData);
+
+	// 扫描期间资源注册表新增资源（渐进式扫描）
+	void OnScanAssetAdded(const FAssetData& AssetData);
+	void OnScanFilesLoaded();
+	static bool IsUnderScanRoot(FName PackagePath);
+
+	// 检查点：定期保存扫描进度，下次同样的规则扫描时询问是否继续
+	void SaveScanCheckpoint();
+	bool TryResumeFromCheckpoint();
+
+	// 扫描状态文字，用于 UI 显示
+	FText GetScanStatusText() const;
+	FText GetScanProgressText() const;
 
 	bool SerializeRuleSetToJson(const UResScannerRuleSet* InRuleSet, FString& OutJson);
+	static void WriteRuleScopeToJson(const UResScannerRuleBase* InRule, const TSharedRef<FJsonObject>& OutRuleJson);
+	static void ReadRuleScopeFromJson(const TSharedRef<FJsonObject>& InRuleJson, UResScannerRuleBase* OutRule);
 
 	TSharedRef<SWidget> CreateRuleConfigPanel();
 	TSharedRef<SWidget> CreateScanResultsPanel();
@@ -68,27 +151,119 @@ private:
 private:
 	TSharedPtr<class FUICommandList> PluginCommands;
 
-	// 扫描结果
-	TArray<TSharedPtr<FScanResultItem>> ScanResults;
-	// 扫描结果列表视图
-	TSharedPtr<SListView<TSharedPtr<FScanResultItem>>> ScanResultsListView;
+	// 扫描引擎，扫描结果在 ScanEngine.Results 中
+	FResScannerEngine ScanEngine;
+	// 打包时检查，只有 Cook 命令行中指定了规则集时才会创建
+	TUniquePtr<FResScannerCookValidator> CookValidator;
+	// 保存时检查
+	TUniquePtr<FResScannerSaveGate> SaveGate;
+	// 扫描结果树视图，以及按规则、目录、类型分组的结果树
+	TSharedPtr<STreeView<TSharedPtr<FResScannerResultTreeNode>>> ResultTreeView;
+	FResScannerResultTree ResultTree{ ScanEngine.Results };
+	// 扫描结果的三元组索引，结果树通过资源过滤器只显示搜索匹配的资源
+	FResScannerResultSearch ResultSearch{ ScanEngine.Results };
+	// 跨规则的集合查询（见 FResScannerRuleQuery），匹配的资源和查询结果的文字
+	FString RuleQueryExpression;
+	FResScannerBitmap RuleQueryAssets;
+	FString RuleQueryStatusText;
+	// 上次求值时结果存储中的违规数量，INDEX_NONE 表示需要重新求值
+	int32 RuleQueryViolationNum = INDEX_NONE;
+	// 还没有展开的分组返回的子节点（只有一个空节点），让分组显示展开箭头
+	TArray<TSharedPtr<FResScannerResultTreeNode>> UnexpandedChildren = { MakeShared<FResScannerResultTreeNode>() };
+	// 扫描结果是否是最终结果（扫描被取消，或者资源注册表还没有发现完所有资源时不是最终结果）
+	bool bScanResultsFinal = true;
+	// 是否正在扫描
+	bool bScanInProgress = false;
+	// 本次扫描的模式
+	EResScanMode ScanMode = EResScanMode::Full;
+	// 开始扫描的时间，以及是否因为超过预算而停止
+	double ScanStartTime = 0.0;
+	bool bScanBudgetExhausted = false;
+	// 抽样模式的估计器，以及估计结果的文字（规则在扫描结束后可能被删除，不能在显示时再生成）
+	FResScannerSampleEstimator SampleEstimator;
+	FString SampleEstimateText;
+	// 扫描预估结果的文字
+	FString ScanExplainText;
+	// 扫描历史，第一次需要时打开，以及历史趋势的文字
+	TSharedPtr<FResScannerHistory> ScanHistory;
+	FString HistoryTrendText;
+	// 本次扫描评估过的资源数量，以及其中优先通道的资源数量
+	int32 ScannedAssetNum = 0;
+	int32 PriorityAssetNum = 0;
+
+	// 普通通道需要扫描的目录，以及下一个要扫描的目录下标
+	TArray<FName> PendingScanPaths;
+	int32 NextScanPathIndex = 0;
+	// 目录 -> 在 PendingScanPaths 中的下标，用于判断新发现的资源所在目录是否已经扫描过
+	TMap<FName, int32> ScanPathIndices;
+	// 复用同一块缓冲区，避免每个目录重新分配内存
+	TArray<FAssetData> AssetChunk;
+	FTSTicker::FDelegateHandle ScanTickerHandle;
+
+	// 优先通道中的资源包，普通通道会跳过它们
+	TSet<FName> PriorityPackages;
+	// 本次编辑器会话中保存过的资源包
+	TSet<FName> SessionSavedPackages;
+	FDelegateHandle PackageSavedHandle;
+	FDelegateHandle AssetViewExtraStateHandle;
+
+	// 扫描期间新发现、所在目录已经扫描过的资源，PendingDiscoveredHead 之前的已经评估过了
+	// 按块从队头取出，不每块都移动整个数组，已评估的部分超过一半时才压缩
+	TArray<FAssetData> PendingDiscoveredAssets;
+	int32 PendingDiscoveredHead = 0;
+	// 查找最近修改的资源文件的后台任务
+	UE::Tasks::TTask<TArray<FName>> RecentPackagesTask;
+	// 资源注册表是否已经发现完所有资源（OnFilesLoaded 已经触发）
+	bool bDiscoveryFinished = true;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle FilesLoadedHandle;
+
+	// 本次扫描是否从检查点继续，继续的扫描不知道之前的部分命中了哪些基线违规，不能记录基线
+	bool bResumedFromCheckpoint = false;
+	// 上一次保存检查点的时间，已经写入检查点结果文件的结果数量，以及结果文件的行数
+	// 从检查点继续时读取的结果可能被结果存储去重，两者不一定相等
+	double LastCheckpointTime = 0.0;
+	int32 CheckpointedResultNum = 0;
+	int32 CheckpointedLineNum = 0;
+	// 上一次重新生成执行计划的时间
+	double LastReplanTime = 0.0;
 
 	// 规则集
 	UResScannerRuleSet* RuleSet;
+	// 追加的规则集（如其它团队导出的规则 Json），和 RuleSet 在同一次扫描中评估
+	TArray<UResScannerRuleSet*> AdditionalRuleSets;
+	// 追加规则集列表，用于 SListView 显示
+	TArray<TWeakObjectPtr<UResScannerRuleSet>> RuleSetItems;
+	TSharedPtr<SListView<TWeakObjectPtr<UResScannerRuleSet>>> RuleSetListView;
 	// 规则列表
 	// 原来写的是 TArray<TSharedPtr<UResScannerRuleBase>> RuleItems; 这种也不推荐
 	// 因为会和 UObject 的 GC 冲突
 	TArray<TWeakObjectPtr<UResScannerRuleBase>> RuleItems;		// 用于 SListView 显示
 	// 规则列表视图
-	// RuleListView 用于存储左侧规则列表的 SListView，与 ScanResultsListView 类似
+	// RuleListView 用于存储左侧规则列表的 SListView，与 ResultTreeView 类似
 	TSharedPtr<SListView<TWeakObjectPtr<UResScannerRuleBase>>> RuleListView;
 
 	// 规则类型选项
 	TArray<TSharedPtr<FString>> RuleTypeOptions = {
 		MakeShared<FString>(TEXT("NameMatch")),
-		MakeShared<FString>(TEXT("PropertyMatch"))
+		MakeShared<FString>(TEXT("PropertyMatch")),
+		MakeShared<FString>(TEXT("TagMatch"))
 		// MakeShared<FString>(TEXT("PathMatch"))
 	};
 	// 选中的类型
 	TSharedPtr<FString> SelectedRuleType;
+
+	// 结果分组选项，和 EResScannerResultGrouping 的顺序一致
+	TArray<TSharedPtr<FString>> ResultGroupingOptions = {
+		MakeShared<FString>(TEXT("按规则分组")),
+		MakeShared<FString>(TEXT("按目录分组")),
+		MakeShared<FString>(TEXT("按类型分组"))
+	};
+
+	// 组合逻辑选项
+	TArray<TSharedPtr<FString>> CompositeLogicOptions = {
+		MakeShared<FString>(TEXT("Independent")),
+		MakeShared<FString>(TEXT("AnyViolation")),
+		MakeShared<FString>(TEXT("AllViolation"))
+	};
 };
\ No newline at end of file
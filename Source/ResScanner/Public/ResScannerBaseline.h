@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FResScannerResultStore;
+
+/**
+ * 违规基线：记录已知违规的 64 位键，之后的扫描只报告基线中没有的新违规，以及基线中已经不再出现的违规数量
+ * 违规键 = CityHash64(UTF-8(资源路径 | 规则指纹 | 失败原因))，规则内容不变、资源不改名时键就不变，和平台无关
+ * 文件格式：Magic、Version、数量、排好序的键数组（小端），几百万条也只有几十 MB
+ * 查询先经过布隆过滤器（每个键 10 位，4 次探测，误判率约 1%），大部分新违规不需要二分查找
+ */
+class RESSCANNER_API FResScannerBaseline
+{
+public:
+	static uint64 MakeViolationKey(const FString& AssetPath, const FString& RuleFingerprint, const FString& ErrorReason);
+
+	// 保存基线，键会被排序、去重
+	static bool Save(const FString& FilePath, TArray<uint64> ViolationKeys);
+	// 接受当前的状态作为新的基线：本次扫描的结果 + 基线中本次扫描出现过的违规（已经修复的违规不再保留）
+	void GatherAcceptedKeys(const FResScannerResultStore& Results, TArray<uint64>& OutKeys) const;
+
+	bool Load(const FString& FilePath);
+
+	// 违规是否在基线中，命中的键会被标记为本次扫描出现过
+	bool MatchAndMark(uint64 ViolationKey);
+
+	// 开始新的扫描，清空出现过的标记
+	void ResetMarks();
+
+	// 成功读取过基线文件（基线可以是空的：接受基线时项目没有任何违规）
+	bool IsLoaded() const { return bLoaded; }
+	int32 GetKeyNum() const { return Keys.Num(); }
+	// 本次扫描中命中基线的违规数量（重复命中同一个键只算一次）
+	int64 GetMatchedNum() const { return MatchedNum; }
+	// 基线中本次扫描没有出现的违规数量（已经修复，或者不在本次扫描范围内）
+	int32 GetUnseenNum() const { return Keys.Num() - SeenKeys.CountSetBits(); }
+
+private:
+	void BuildBloomFilter();
+	bool MayContain(uint64 ViolationKey) const;
+
+private:
+	// 排好序的违规键
+	TArray<uint64> Keys;
+	// 布隆过滤器，位数是 2 的幂
+	TArray<uint64> BloomWords;
+	uint64 BloomMask = 0;
+	// 和 Keys 一一对应，本次扫描是否出现过
+	TBitArray<> SeenKeys;
+	int64 MatchedNum = 0;
+	bool bLoaded = false;
+};
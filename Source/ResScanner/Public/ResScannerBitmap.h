@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 压缩位图（roaring 风格），保存 uint32 集合，用于每条规则违规的资源编号集合
+ * 按高 16 位分块，每块只保存低 16 位：元素不超过 4096 个时是升序数组，超过时是 65536 位的位图（8KB）
+ * 稀疏的规则只占几个字节，违规很多的规则每个资源一位；集合运算逐块进行，两个位图块直接按字运算
+ */
+class RESSCANNER_API FResScannerBitmap
+{
+public:
+	void Reset() { Containers.Reset(); }
+	// 按升序添加时总是追加到最后一块，乱序添加时需要插入
+	void Add(uint32 Value);
+	bool Contains(uint32 Value) const;
+	int64 Num() const;
+	bool IsEmpty() const { return Containers.Num() == 0; }
+	// 按升序遍历所有元素
+	void ForEach(TFunctionRef<void(uint32 Value)> Visitor) const;
+
+	static FResScannerBitmap And(const FResScannerBitmap& A, const FResScannerBitmap& B);
+	static FResScannerBitmap Or(const FResScannerBitmap& A, const FResScannerBitmap& B);
+	static FResScannerBitmap AndNot(const FResScannerBitmap& A, const FResScannerBitmap& B);
+	// 集合中 [0, Count) 的所有元素
+	static FResScannerBitmap Range(uint32 Count);
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	// 数组块最多保存的元素数量，超过时转换为位图块（数组块此时也是 8KB）
+	static constexpr int32 MaxArrayNum = 4096;
+	static constexpr int32 BitmapWordNum = 65536 / 64;
+
+	struct FContainer
+	{
+		// 元素的高 16 位
+		uint16 Key = 0;
+		int32 Cardinality = 0;
+		// 数组块：升序的低 16 位
+		TArray<uint16> Values;
+		// 位图块：BitmapWordNum 个字，非空时表示是位图块
+		TArray<uint64> Words;
+
+		bool IsBitmap() const { return Words.Num() > 0; }
+		bool Contains(uint16 Low) const;
+		void Add(uint16 Low);
+		// 数组块转换为位图块
+		void ConvertToBitmap();
+		// 位图块元素不超过 MaxArrayNum 时转换为数组块，元素数量从位图重新统计
+		void Optimize();
+	};
+
+	static FContainer AndContainers(const FContainer& A, const FContainer& B);
+	static FContainer OrContainers(const FContainer& A, const FContainer& B);
+	static FContainer AndNotContainers(const FContainer& A, const FContainer& B);
+	FContainer& FindOrAddContainer(uint16 Key);
+	const FContainer* FindContainer(uint16 Key) const;
+
+	// 按 Key 升序
+	TArray<FContainer> Containers;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 按本地 git 变更确定扫描范围，用于提交前检查，检查耗时只和变更大小有关
+ * 在本地工作副本中执行 git diff --name-only -z，不需要访问服务器
+ */
+struct RESSCANNER_API FResScannerChangeScope
+{
+	// 把 RevisionRange（如 origin/main...HEAD，或者 HEAD 表示未提交的修改）中修改、新增的 .uasset/.umap 映射成资源包名
+	// 删除的文件没有资源可以扫描，不包含在内；OutFilenames 是对应的文件绝对路径
+	static bool GatherChangedPackages(const FString& RevisionRange, TArray<FName>& OutPackageNames, TArray<FString>* OutFilenames = nullptr);
+
+	// 加上直接引用这些资源包的资源包，用于和引用关系有关的规则（被修改的资源可能让引用它的资源违规）
+	static void AddDirectReferencers(TArray<FName>& InOutPackageNames);
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FResScannerResultStore;
+
+/**
+ * 扫描检查点，保存在 Saved/ResScanner/ 中，用于在编辑器崩溃或者取消扫描后从中断处继续
+ *		Checkpoint.json：清单，记录规则集指纹、目录列表、已经扫描完的目录位置、优先通道的资源包
+ *		CheckpointResults.ndjson：到目前为止的扫描结果，每行一条，每次保存检查点时只追加新增的结果
+ * 先追加结果再写清单，清单中的 ResultNum 表示结果文件中有效的行数，崩溃时多写的行在继续扫描时截掉
+ */
+struct RESSCANNER_API FResScannerCheckpoint
+{
+	// 规则集指纹，规则有任何变化都不能继续之前的扫描
+	FString RuleSetFingerprint;
+	// 扫描根目录
+	FString ScanRootPath;
+	// 扫描开始时的目录列表，继续扫描时必须使用同一个顺序
+	TArray<FName> ScanPaths;
+	// 下一个要扫描的目录下标，之前的目录都已经扫描完了
+	int32 NextScanPathIndex = 0;
+	// 优先通道已经评估过的资源包，继续扫描时普通通道仍然要跳过它们
+	TArray<FName> PriorityPackages;
+	// 中断时已经发现、还没有评估的资源包（所在目录已经扫描过了）
+	TArray<FName> PendingPackages;
+	int32 ScannedAssetNum = 0;
+	int32 PriorityAssetNum = 0;
+	// 结果文件中有效的行数（读取时结果存储可能去重，不一定等于结果数量）
+	int32 ResultNum = 0;
+
+	// 保存和读取清单
+	bool SaveManifest() const;
+	bool LoadManifest();
+
+	// 把 FirstIndex 之后新增的结果追加到结果文件中，InOutLineNum 加上实际写入的行数
+	static bool AppendResults(const FResScannerResultStore& Results, int32 FirstIndex, int32& InOutLineNum);
+	// 读取结果文件中前 ResultNum 行结果，添加到 OutResults 中
+	// 结果文件中多出的行（保存清单前崩溃）会被截掉，之后追加的结果紧接在有效行后面
+	bool LoadResults(FResScannerResultStore& OutResults) const;
+
+	// 删除检查点（扫描正常结束，或者用户选择重新扫描）
+	static void Delete();
+
+	static FString GetManifestFilePath();
+	static FString GetResultsFilePath();
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ResScannerCommandlet.generated.h"
+
+class UResScannerRuleSet;
+class FResScannerEngine;
+
+/**
+ * 命令行扫描，用于 CI 和打包机，不需要打开编辑器界面
+ * 用法：
+ *		UnrealEditor-Cmd.exe Project.uproject -run=ResScanner -RuleSets=A.json+B.json [-Report=Report.json] [-Root=/Game]
+ *			[-RegistryState=Path.bin] [-IoStore=Path] [-Shards=N [-ShardTimeoutMinutes=N]] [-MemoryBudgetMB=N] [-PackageList=Path.txt] [-GitDiff=Range [-IncludeReferencers]]
+ *			[-Output=A.sarif+B.csv [-StreamOnly]] [-Baseline=Path.bin] [-WriteBaseline=Path.bin] [-History[=Path.db]] [-Query="Art#1 - Art#2;rules>=3"]
+ *			-nullrhi -nosplash -nosound -unattended -nopause -NoShaderCompile
+ *		-RuleSets	编辑器中"导出配置"导出的规则集 Json，多个文件用 + 分隔，在一次扫描中一起评估
+ *		-Report		扫描报告（Json），默认 Saved/ResScanner/Report.json
+ *		-Root		扫描的根目录，默认 /Game
+ *		-RegistryState	离线扫描：不读取项目内容，直接评估序列化的资源注册表（如打包生成的 DevelopmentAssetRegistry.bin），
+ *						只评估名字、路径、类型、标签等不需要加载资源的规则，适合没有同步资源的 CI 机器
+ *		-IoStore	检查打包结果：读取 .utoc 文件或者目录中所有 .utoc 的目录，每个资源包的大小、所在容器写在标签中（见 FResScannerIoStore），
+ *					和 -RegistryState 一样只评估不需要加载资源的规则，可以用标签规则检查超大的资源包、放错容器的资源
+ *		-Shards		分片扫描：把作用范围内的资源包分成 N 片，启动 N 个本机工作进程并行扫描，最后合并报告
+ *					适合需要加载资源的属性规则，扫描耗时随 CPU 核数和内存线性缩短
+ *		-ShardTimeoutMinutes	和 -Shards 一起使用，工作进程超过这个时间（默认 120 分钟，0 表示不限制）没有结束时被结束，扫描失败
+ *		-MemoryBudgetMB	进程占用的物理内存超过预算时执行 GC，卸载已经评估完的资源，默认为本机 3/4 的内存，分片扫描时由工作进程平分
+ *		-PackageList	只扫描文件中列出的资源包（每行一个），分片扫描的工作进程使用
+ *		-GitDiff	只扫描本地 git 变更中修改、新增的资源，如 -GitDiff=origin/main...HEAD，用于提交前检查
+ *		-IncludeReferencers	和 -GitDiff 一起使用，同时扫描直接引用变更资源的资源
+ *		-Output		扫描过程中把结果写到文件，多个文件用 + 分隔，按扩展名选择格式（.ndjson .csv .sarif .xml，见 FResScannerResultSink）
+ *		-StreamOnly	和 -Output 一起使用，结果只写到输出文件，不保存在内存中，Report 中只有结果数量
+ *		-Baseline	违规基线（见 FResScannerBaseline），基线中已有的违规不报告，返回值只取决于新的违规
+ *		-WriteBaseline	扫描结束后把当前的违规（包括 -Baseline 中仍然存在的违规）写成新的基线
+ *		-History	把所有违规记录到扫描历史（SQLite，默认 Saved/ResScanner/ScanHistory.db，见 FResScannerHistory），用于趋势查询
+ *		-Query		扫描结束后执行跨规则的集合查询（语法见 FResScannerRuleQuery），多个查询用 ; 分隔，输出匹配的资源数量和资源
+ * 返回值：0 没有违规，1 有违规，2 参数或者规则集错误
+ *
+ * 为了启动快，资源注册表只同步扫描 Root 目录，不搜索整个项目；只有名字、路径规则时不会加载任何资源
+ */
+UCLASS()
+class RESSCANNER_API UResScannerCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UResScannerCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// 加载规则集，有任何一个文件加载失败都返回 false，加载成功的规则集在命令行结束时从 Root 中移除
+	static bool LoadRuleSets(const FString& RuleSetsParam, TArray<UResScannerRuleSet*>& OutRuleSets);
+
+	// 分片扫描：收集作用范围内的资源包，分片后启动工作进程，合并它们的报告到 Engine.Results
+	static bool RunShards(FResScannerEngine& Engine, const FString& RuleSetsParam, const FString& RootPathString,
+		int32 ShardNum, int32 MemoryBudgetMB, int32 TimeoutMinutes, int64& OutScannedAssetNum);
+	// 评估指定的资源包，返回评估的资源数量
+	static int64 ScanPackages(FResScannerEngine& Engine, const TArray<FName>& PackageNames, uint64 MemoryBudgetBytes);
+	// 执行 -Query 中的集合查询，有查询解析失败时返回 false
+	static bool RunRuleQueries(const FResScannerEngine& Engine, const FString& QueryParam);
+
+	// 物理内存超过预算时执行 GC，卸载已经评估完的资源
+	static void CollectGarbageIfOverBudget(uint64 MemoryBudgetBytes);
+	// 没有指定 -MemoryBudgetMB 时的默认预算：ProcessNum 个进程平分本机 3/4 的物理内存
+	static int32 GetDefaultMemoryBudgetMB(int32 ProcessNum);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ResScannerEngine.h"
+
+class UPackage;
+class FObjectPreSaveContext;
+namespace UE::Cook { class ICookInfo; }
+
+/**
+ * 打包时检查：在 Cook 保存每个资源包之前，用规则集评估资源包中已经加载的资源
+ * Cook 本来就会加载所有要发布的资源包，属性规则直接使用内存中的对象，不会产生额外的加载，
+ * 发布的资源可以得到完整的属性规则覆盖，几乎不增加 Cook 时间
+ * 用法：Cook 命令行加上 -ResScannerRuleSets=A.json+B.json [-ResScannerReport=Report.json] [-ResScannerFailOnViolation]
+ * 报告格式和 UResScannerCommandlet 相同，在 Cook 结束时写出，违规的 Error 日志在 Cook 返回退出码之前输出
+ */
+class RESSCANNER_API FResScannerCookValidator
+{
+public:
+	// 根据命令行参数创建，没有 -ResScannerRuleSets 或者不是 Cook 时返回空
+	static TUniquePtr<FResScannerCookValidator> CreateFromCommandLine();
+
+	~FResScannerCookValidator();
+
+private:
+	FResScannerCookValidator() = default;
+
+	void OnPreSavePackage(UPackage* Package, FObjectPreSaveContext ObjectSaveContext);
+	void OnCookFinished(UE::Cook::ICookInfo& CookInfo);
+	// 写报告，只执行一次
+	void Finish();
+
+private:
+	FResScannerEngine Engine;
+	TArray<UResScannerRuleSet*> RuleSets;
+	FString ReportPath;
+	bool bFailOnViolation = false;
+	bool bFinished = false;
+
+	// 已经评估过的资源包，多平台 Cook 时同一个资源包会被保存多次
+	TSet<FName> ValidatedPackages;
+	int64 ScannedAssetNum = 0;
+	double EvaluateSeconds = 0.0;
+
+	FDelegateHandle PreSavePackageHandle;
+	FDelegateHandle CookFinishedHandle;
+	FDelegateHandle PreExitHandle;
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ResScannerRuleSet.h"
+#include "ResScannerRuleIndex.h"
+#include "ResScannerRuleScheduler.h"
+#include "ResScannerResultSink.h"
+#include "ResScannerBaseline.h"
+#include "ResScannerResultStore.h"
+
+class FResScannerHistory;
+
+class FAssetRegistryState;
+class UPackage;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogResScanner, Log, All)
+
+// 一条展开的扫描结果，只在读写报告、输出到文件时临时使用，扫描结果保存在 FResScannerResultStore 中
+struct FScanResultItem
+{
+	FString AssetPath;
+	FString RuleName;
+	FString ErrorReason;
+	// 所属规则集
+	FString RuleSetName;
+	// 规则在 CompiledRules.Rules 中的下标，报告、检查点中也会保存，规则没有对应的规则对象时为 INDEX_NONE
+	int32 RuleIndex = INDEX_NONE;
+	// 规则指纹（见 UResScannerRuleBase::GetRuleFingerprint），同一个规则集中同类型的多条规则靠它区分
+	FString RuleFingerprint;
+	// 违规键，见 FResScannerBaseline::MakeViolationKey
+	uint64 ViolationKey = 0;
+	// 资源类型（/Script/Engine.Texture2D）
+	FString AssetClass;
+};
+
+/**
+ * 扫描引擎：合并规则集、建立分发索引、生成执行计划并评估资源，不依赖 Slate
+ * 编辑器面板（FResScannerModule）和命令行（UResScannerCommandlet）共用同一个引擎，
+ * 分帧、优先通道、检查点等调度方式由调用方决定
+ */
+class RESSCANNER_API FResScannerEngine
+{
+public:
+	// 每批交给评估器的资源数量，限制单次评估中间数据的大小
+	static constexpr int32 ChunkSize = 512;
+
+	// 合并规则集，建立分发索引并生成执行计划，同时清空结果，扫描开始前调用
+	// bRegistryOnly：只评估不需要加载资源、可以脱离 GameThread 的规则，用于离线扫描，被跳过的规则会输出警告
+	void Prepare(const TArray<UResScannerRuleSet*>& InRuleSets, bool bRegistryOnly = false);
+	// ShouldSkipRule：返回 true 的规则不参与评估，规则见 FResScannerCompiledRules::Compile
+	void Prepare(const TArray<UResScannerRuleSet*>& InRuleSets, TFunctionRef<bool(const UResScannerRuleBase*)> ShouldSkipRule);
+
+	// 拷贝一个目录（不递归）中磁盘上的资源，SkipPackages 中的资源包会被跳过
+	static void GatherPathAssets(FName PackagePath, const TSet<FName>* SkipPackages, TArray<FAssetData>& OutAssets);
+	// 用资源包中已经加载的资源构造 FAssetData，规则中 GetAsset 直接取到内存中的对象，不会再加载（Cook、保存时使用）
+	static void GatherResidentAssets(UPackage* Package, TArray<FAssetData>& OutAssets);
+
+	// 按 ChunkSize 分批评估资源
+	void EvaluateAssets(TArrayView<const FAssetData> Assets);
+
+	// 离线扫描：用内存映射读取序列化的资源注册表（如 DevelopmentAssetRegistry.bin），不需要同步资源
+	static bool LoadRegistryState(const FString& FilePath, FAssetRegistryState& OutState);
+	// 评估注册表状态中 RootPath 下的所有资源，返回评估的资源数量
+	// 离线时资源无法加载，需要先用 Prepare(..., true) 去掉需要加载资源的规则
+	int64 ScanRegistryState(const FAssetRegistryState& State, FName RootPath);
+	// 评估打包生成的 IoStore 容器（Path 为 .utoc 文件或者包含 .utoc 的目录）中 RootPath 下的资源包，同样需要 Prepare(..., true)
+	// 没有找到容器或者有容器读取失败时返回 false
+	bool ScanIoStore(const FString& Path, FName RootPath, int64& OutScannedAssetNum);
+
+	// 机器可读的扫描报告（Json），命令行、分片扫描、打包时检查都输出同样的格式
+	bool WriteReport(const FString& ReportPath, const FString& RootPathString, bool bOffline, int64 ScannedAssetNum, double ElapsedSeconds) const;
+	// 读取报告中的结果追加到 Results 中（合并分片扫描的报告）
+	bool ReadReport(const FString& ReportPath, int64& OutScannedAssetNum);
+
+	// 评估一批资源，线程安全的规则并行评估，其余规则在 GameThread 中评估
+	// OutRuleReportedNum 不为空时累加每条规则报告的违规数量（下标和规则数组一致）
+	void EvaluateAssetChunk(TArrayView<const FAssetData> AssetChunk, TArray<int32>* OutRuleReportedNum = nullptr);
+
+	// 记录一个评估得到的违规，只有需要写入扫描历史或者结果输出时才展开成 FScanResultItem
+	void AddViolation(const FAssetData& AssetData, int32 RuleIndex);
+	// 记录一个结果：在基线中的结果被忽略，其余结果写入所有结果输出，bRetainResults 时保存到 Results 中
+	// 同一个资源同一条规则的重复结果只记录一次
+	void AddResult(const FScanResultItem& Result);
+	// 清空结果，开始新的扫描前调用
+	void ResetResults();
+	// 写入结果输出的结尾并关闭文件
+	void CloseResultSinks();
+
+private:
+	// 不保存结果时按违规键去重，违规键已经输出过时返回 true
+	bool IsStreamedDuplicate(uint64 ViolationKey);
+
+public:
+	// 本次扫描的所有规则集合并后的规则
+	FResScannerCompiledRules CompiledRules;
+	// 每条规则的指纹，Prepare 时计算一次，用于生成违规键
+	TArray<FString> RuleFingerprints;
+	// 规则分发索引，每次扫描前根据 CompiledRules 重新建立
+	FResScannerRuleIndex RuleDispatchIndex;
+	// 规则调度器，记录每条规则的开销和违规率并生成执行计划
+	FResScannerRuleScheduler RuleScheduler;
+	// 扫描结果，规则表在 Prepare 时设置
+	FResScannerResultStore Results;
+	// 本次扫描的结果数量，不保存结果时 Results 为空，以这个数量为准
+	int64 ResultNum = 0;
+	// 是否在 Results 中保存结果，只需要输出到文件时关闭，每个结果只保留 8 字节的违规键用于去重
+	bool bRetainResults = true;
+	// 结果输出（NDJSON、CSV、SARIF、JUnit），每评估完一批资源刷新一次，扫描过程中就可以读取
+	TArray<TUniquePtr<FResScannerResultSink>> ResultSinks;
+	// 违规基线，加载后只报告基线中没有的违规
+	FResScannerBaseline Baseline;
+	// 扫描历史，不为空时所有违规（包括基线中的违规）都会记录到历史中，由调用方开始、结束一次扫描记录
+	TSharedPtr<FResScannerHistory> History;
+
+private:
+	// 不保存结果时已经输出过的违规键
+	TSet<uint64> StreamedViolationKeys;
+};
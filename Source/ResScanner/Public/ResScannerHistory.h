@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FScanResultItem;
+// SQLiteCore 是私有依赖，头文件中只使用前向声明
+class FSQLiteDatabase;
+class FSQLitePreparedStatement;
+
+// 某次扫描的违规数量，趋势查询的一个数据点
+struct FResScannerTrendPoint
+{
+	int64 ScanId = 0;
+	FDateTime StartTime;
+	int64 ViolationNum = 0;
+};
+
+/**
+ * 扫描历史：每次扫描的所有违规写入本地 SQLite 数据库（引擎的 SQLiteCore 插件），不需要重新扫描就能查询趋势
+ * 表结构：
+ *		Scans		每次扫描一行：开始时间、根目录、规则集、扫描的资源数量、违规数量、是否完成
+ *		Rules		规则指纹 -> 规则名、规则集，指纹不变的规则跨扫描是同一条规则
+ *		Violations	每次扫描的每个违规一行，按 (ScanId)、(RuleId, ScanId)、(PackagePath, ScanId)、(AssetClass, ScanId) 建立索引
+ *		FirstSeen	违规键第一次出现的扫描和时间
+ * 目录前缀查询用范围条件 PackagePath >= '/Game/X/' AND PackagePath < '/Game/X0'（'0' 是 '/' 的下一个字符），可以走索引
+ * 一次扫描的写入在一个事务中，几十万条违规也只需要几秒
+ */
+class RESSCANNER_API FResScannerHistory
+{
+public:
+	FResScannerHistory();
+	~FResScannerHistory();
+
+	// 打开（不存在时创建）数据库并建表
+	bool Open(const FString& FilePath);
+	void Close();
+
+	// 开始记录一次扫描，返回扫描 Id
+	int64 BeginScan(const FString& RootPath, const FString& RuleSetNames, const FString& Source);
+	void AddViolation(const FScanResultItem& Result, const FString& RuleFingerprint);
+	// bCompleted 为 false 表示扫描被取消或者超过预算，趋势查询会跳过这些扫描
+	void EndScan(int64 ScannedAssetNum, bool bCompleted);
+
+	// 目录（包含子目录）下每次完整扫描的违规数量，按时间从旧到新，最多 MaxScanNum 次
+	bool QueryFolderTrend(const FString& PathPrefix, int32 MaxScanNum, TArray<FResScannerTrendPoint>& OutPoints);
+	// 某条规则每次完整扫描的违规数量
+	bool QueryRuleTrend(const FString& RuleFingerprint, int32 MaxScanNum, TArray<FResScannerTrendPoint>& OutPoints);
+	// 违规第一次出现的时间
+	bool QueryFirstSeen(uint64 ViolationKey, FDateTime& OutFirstSeen);
+
+	// 最近几次完整扫描中每条规则、每个一级目录的违规数量，用于 UI 显示
+	FString DescribeTrend(int32 MaxScanNum);
+
+	static FString GetDefaultFilePath();
+
+private:
+	int64 FindOrAddRule(const FString& RuleFingerprint, const FScanResultItem& Result);
+	bool QueryTrend(const TCHAR* Condition, TFunctionRef<void(FSQLitePreparedStatement&)> BindCondition, int32 MaxScanNum, TArray<FResScannerTrendPoint>& OutPoints);
+
+private:
+	TUniquePtr<FSQLiteDatabase> Database;
+	TUniquePtr<FSQLitePreparedStatement> InsertViolationStatement;
+	TUniquePtr<FSQLitePreparedStatement> InsertFirstSeenStatement;
+
+	// 规则指纹 -> RuleId
+	TMap<FString, int64> RuleIds;
+	// 正在记录的扫描，0 表示没有
+	int64 CurrentScanId = 0;
+	int64 CurrentViolationNum = 0;
+	// 正在记录的扫描中已经写入的违规键
+	TSet<uint64> RecordedViolationKeys;
+};
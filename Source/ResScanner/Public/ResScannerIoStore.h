@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+/**
+ * 读取打包生成的 IoStore 容器（.utoc/.ucas），检查实际发布的内容而不是编辑器中的资源
+ * 只读取 .utoc 中的目录（Chunk 列表和文件名索引），不挂载容器，不读取 .ucas 中的数据，也不需要启动游戏
+ * 每个资源包生成一个 FAssetData，包名、路径来自文件名索引，大小、所在容器写在标签中，
+ * 名字规则、作用目录和标签规则（UTagMatchRuleExecutor）都可以直接使用
+ */
+class RESSCANNER_API FResScannerIoStore
+{
+public:
+	// 资源包所在的容器名（如 global、pakchunk0-Windows）
+	static const FName ContainerTag;
+	// 资源包所有 Chunk（导出数据 + BulkData）的大小，单位字节
+	static const FName SizeTag;
+	// 资源包在容器中压缩后的大小，单位字节
+	static const FName CompressedSizeTag;
+	// 资源包 BulkData（包括可选、内存映射的 BulkData）的大小，单位字节
+	static const FName BulkDataSizeTag;
+	// 资源包的 Chunk 数量
+	static const FName ChunkNumTag;
+
+	// 查找容器，Path 可以是 .utoc 文件或者目录（递归查找目录中的所有 .utoc）
+	static void FindContainers(const FString& Path, TArray<FString>& OutTocPaths);
+
+	// 读取一个容器中的资源包，容器加密或者没有文件名索引时返回 false
+	static bool GatherContainerAssets(const FString& TocPath, TArray<FAssetData>& OutAssets);
+
+private:
+	// 容器中的文件名（如 ../../../Project/Content/Maps/Main.umap）转换成包名
+	static FName FilenameToPackageName(const FString& Filename);
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ResScannerRuleSet.h"
+
+class FResScannerRuleScheduler;
+
+// 单条规则的预估结果
+struct FResScannerRuleExplain
+{
+	FString RuleName;
+	FString RuleSetName;
+	// 是否需要加载资源（否则只用资源名、路径、标签等注册表数据）
+	bool bRequiresLoad = false;
+	// 是否有历史统计数据，没有时耗时和违规率都是默认值
+	bool bHasStats = false;
+	// 没有限定作用目录和作用类型
+	bool bUnscoped = false;
+	// 分发索引分配到这条规则的资源数量，也就是最多评估次数
+	int64 InScopeNum = 0;
+	// 按执行计划短路后的期望评估次数
+	double ExpectedEvaluatedNum = 0.0;
+	// 预估总耗时（秒，单线程）
+	double EstimatedSeconds = 0.0;
+	// 需要在扫描前提醒用户的规则
+	bool bExpensive = false;
+};
+
+/**
+ * 扫描预估（类似数据库的 EXPLAIN）
+ * 只读取规则和资源注册表，不评估任何规则、不加载任何资源：
+ * 用分发索引统计每条规则作用的资源数，用调度器的历史耗时和违规率推算短路后的评估次数、
+ * 需要加载的资源数量、加载的数据量（资源包的磁盘大小）和扫描耗时，并标出开销大的规则
+ */
+struct RESSCANNER_API FResScannerScanExplain
+{
+	int32 PathNum = 0;
+	int64 AssetNum = 0;
+	// 至少有一条规则作用的资源数量
+	int64 InScopeAssetNum = 0;
+	double ExpectedLoadNum = 0.0;
+	double ExpectedLoadBytes = 0.0;
+	// 预估扫描耗时（秒），并行评估的规则按工作线程数折算
+	double EstimatedSeconds = 0.0;
+	TArray<FResScannerRuleExplain> Rules;
+
+	void Explain(const TArray<UResScannerRuleSet*>& InRuleSets, const FResScannerRuleScheduler& InScheduler, FName InRootPath);
+
+	// 预估结果的文字描述，用于 UI 显示和日志
+	FString Describe() const;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FResScannerResultStore;
+
+/**
+ * 扫描结果搜索：资源包名和结果细节（与规则默认原因不同的错误原因）建立三元组（trigram）倒排索引，
+ * 规则名和规则的错误原因只有几十条，直接匹配后按规则取违规
+ * 索引随结果追加增量建立，查询时只对候选资源取字符串校验，不会遍历所有结果的字符串
+ * 查询语法：空格分隔的多个词都要匹配；普通词为子串匹配（不区分大小写），~ 开头的词为模糊匹配
+ * 少于 3 个字符的词没有三元组，不参与过滤
+ */
+class RESSCANNER_API FResScannerResultSearch
+{
+public:
+	explicit FResScannerResultSearch(const FResScannerResultStore& InResults);
+
+	// 清空索引，结果存储被清空后调用
+	void Reset();
+	// 索引结果存储中新增的资源和违规，当前查询的匹配结果也一起更新
+	void Update();
+
+	// 设置查询，返回是否有可以过滤的词
+	bool SetQuery(const FString& InQuery);
+	bool HasQuery() const { return Terms.Num() > 0; }
+	// 资源是否匹配当前查询，没有查询时所有资源都匹配
+	bool Matches(int32 AssetId) const { return !HasQuery() || (MatchedAssets.IsValidIndex(AssetId) && MatchedAssets[AssetId]); }
+	int32 GetMatchedAssetNum() const { return MatchedAssetNum; }
+	double GetLastQuerySeconds() const { return LastQuerySeconds; }
+
+private:
+	struct FTerm
+	{
+		// 小写的词，不含 ~
+		FString Text;
+		bool bFuzzy = false;
+		// 词的三元组（去重）
+		TArray<uint64> Trigrams;
+		// 规则名或者规则错误原因匹配这个词的规则
+		TBitArray<> MatchedRules;
+	};
+
+	static void GatherTrigrams(FStringView Text, TArray<uint64>& OutTrigrams);
+	void AddPosting(uint64 Trigram, int32 AssetId);
+	void IndexText(FStringView Text, int32 AssetId);
+	// 规则表可能增长（读取报告），规则匹配按需要补齐
+	void UpdateMatchedRules(FTerm& Term) const;
+	// 用索引重新求所有资源的匹配结果
+	void EvaluateQuery();
+	// 用索引求一个词匹配的资源
+	void EvaluateTerm(FTerm& Term, TBitArray<>& OutAssets) const;
+	// 对一个资源直接判断是否匹配（新增的资源、校验候选资源）
+	bool MatchesTerm(const FTerm& Term, int32 AssetId) const;
+	bool MatchesAllTerms(int32 AssetId) const;
+
+	const FResScannerResultStore& Results;
+
+	// 三元组 -> 包含它的资源编号（升序）
+	TMap<uint64, TArray<int32>> Postings;
+	int32 IndexedAssetNum = 0;
+	int32 IndexedViolationNum = 0;
+
+	TArray<FTerm> Terms;
+	TBitArray<> MatchedAssets;
+	int32 MatchedAssetNum = 0;
+	double LastQuerySeconds = 0.0;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FScanResultItem;
+
+/**
+ * 扫描结果输出：扫描过程中每得到一个结果就写入文件，不在内存中构造整个文档
+ * 内存占用和结果数量无关，CI 可以在扫描过程中 tail 输出文件
+ * 根据扩展名选择格式：
+ *		.ndjson/.jsonl	每行一个 Json 对象，和检查点结果文件格式相同
+ *		.csv			表头 AssetPath,RuleName,ErrorReason,RuleSetName
+ *		.sarif			SARIF 2.1.0，代码评审工具可以直接显示为注释
+ *		.xml			JUnit XML，每个结果是一个失败的用例
+ */
+class RESSCANNER_API FResScannerResultSink
+{
+public:
+	// 根据扩展名创建输出，不支持的扩展名或者文件无法创建时返回空
+	static TUniquePtr<FResScannerResultSink> Create(const FString& FilePath);
+
+	// 结果的 Json 行（紧凑格式，不含换行），NDJSON 输出和检查点共用
+	// bWithRuleIndex：写入规则下标和规则指纹，只在同一组规则中有意义（检查点）
+	static void FormatJsonLine(const FScanResultItem& Result, FString& OutLine, bool bWithRuleIndex = false);
+
+	// 析构时自动 Close；基类析构时已经不能调用派生类的 WriteFooter，有文档结尾的格式在自己的析构函数中 Close
+	virtual ~FResScannerResultSink();
+
+	void WriteResult(const FScanResultItem& Result);
+	// 写入文档结尾并关闭文件，可以提前调用，之后析构不再重复写入
+	void Close();
+	// 把缓冲的内容写到磁盘，其它进程读取文件时可以看到已经写入的结果
+	void Flush();
+
+	const FString& GetFilePath() const { return FilePath; }
+	int64 GetResultNum() const { return ResultNum; }
+
+protected:
+	FResScannerResultSink() = default;
+
+	// 各个格式的文档开头、单个结果、文档结尾
+	virtual void WriteHeader() {}
+	virtual void WriteResultText(const FScanResultItem& Result, FString& OutText) = 0;
+	virtual void WriteFooter() {}
+
+	// 以 UTF-8 写入文件
+	void WriteText(const FString& Text);
+
+protected:
+	FString FilePath;
+	int64 ResultNum = 0;
+
+private:
+	TUniquePtr<FArchive> Writer;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/TopLevelAssetPath.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "ResScannerBitmap.h"
+
+struct FAssetData;
+struct FScanResultItem;
+class UResScannerRuleBase;
+
+/**
+ * 扫描结果存储，按列保存（结构数组），每个有违规的资源只有一条记录
+ *		资源：资源包名和资源名（FName，和资源注册表共用名字表）、类型编号、违规位图（每条规则一位）
+ *		违规：资源编号、规则编号、违规键，按添加顺序排列，检查点按下标增量保存
+ *		规则：规则名、规则集名和错误原因，每条规则只保存一份，错误原因第一次用到时才调用 GetErrorReason
+ *		细节：和规则默认错误原因不同的错误原因（如从报告读取的结果），保存在一块连续的字符缓冲区中
+ *		规则位图：每条规则违规资源编号的压缩位图，用于跨规则的集合查询（见 FResScannerRuleQuery）
+ * 每条违规固定占用 20 字节，FScanResultItem 只在输出时临时展开，不再每条违规分配三个 FString
+ */
+class RESSCANNER_API FResScannerResultStore
+{
+public:
+	// 清空资源和违规，保留规则表
+	void Reset();
+	// 重新设置规则表并清空所有结果，规则编号和 CompiledRules.Rules 的下标一致，Prepare 时调用
+	// RuleSetPositions 是规则在规则集中的序号（见 FResScannerCompiledRules::RuleSetPositions）
+	void SetRules(TArrayView<UResScannerRuleBase* const> Rules, TArrayView<const FString> RuleSetNames,
+		TArrayView<const int32> RuleSetPositions, TArrayView<const FString> RuleFingerprints);
+
+	// 添加评估得到的违规，同一个资源同一条规则已经有违规时返回 INDEX_NONE，否则返回违规下标
+	int32 Add(const FAssetData& AssetData, int32 RuleId, uint64 ViolationKey);
+	// 添加从报告、检查点读取的结果，按规则下标和指纹对应到规则表，规则表中没有的规则会追加到规则表中
+	int32 Add(const FScanResultItem& Result);
+
+	int32 Num() const { return ViolationAssets.Num(); }
+	int32 GetAssetNum() const { return AssetPackageNames.Num(); }
+	int32 GetRuleNum() const { return RuleEntries.Num(); }
+
+	// 违规
+	int32 GetViolationAsset(int32 ViolationIndex) const { return ViolationAssets[ViolationIndex]; }
+	int32 GetViolationRule(int32 ViolationIndex) const { return ViolationRules[ViolationIndex]; }
+	uint64 GetViolationKey(int32 ViolationIndex) const { return ViolationKeys[ViolationIndex]; }
+	FStringView GetErrorReason(int32 ViolationIndex) const;
+	// 错误原因是否和规则的默认错误原因不同（保存在细节区中）
+	bool HasErrorDetail(int32 ViolationIndex) const { return ViolationDetails.Contains(ViolationIndex); }
+	// 展开成完整的结果，用于输出到文件
+	void MakeItem(int32 ViolationIndex, FScanResultItem& OutItem) const;
+
+	// 资源
+	// 按资源包名和资源名查找资源编号（哈希表），没有违规的资源返回 INDEX_NONE，内容浏览器每个资源格子显示时调用
+	int32 FindAsset(FName PackageName, FName AssetName) const;
+	FString GetAssetPath(int32 AssetId) const { return GetAssetObjectPath(AssetId).ToString(); }
+	FSoftObjectPath GetAssetObjectPath(int32 AssetId) const { return FSoftObjectPath(FTopLevelAssetPath(AssetPackageNames[AssetId], AssetNames[AssetId])); }
+	FName GetAssetPackageName(int32 AssetId) const { return AssetPackageNames[AssetId]; }
+	const FTopLevelAssetPath& GetAssetClass(int32 AssetId) const { return Classes[AssetClassIds[AssetId]]; }
+	bool HasViolation(int32 AssetId, int32 RuleId) const;
+	// 资源的所有违规下标，按添加顺序
+	void GetAssetViolations(int32 AssetId, TArray<int32>& OutViolationIndices) const;
+	int32 GetAssetViolationNum(int32 AssetId) const;
+	// 资源违反的规则数量，从违规位图统计，和违规数量相同
+	int32 GetAssetRuleNum(int32 AssetId) const;
+
+	// 规则
+	const FString& GetRuleName(int32 RuleId) const { return RuleEntries[RuleId].RuleName; }
+	const FString& GetRuleSetName(int32 RuleId) const { return RuleEntries[RuleId].RuleSetName; }
+	const FString& GetRuleFingerprint(int32 RuleId) const { return RuleEntries[RuleId].RuleFingerprint; }
+	// 规则在所属规则集中的序号（从 1 开始，被跳过的规则也占序号），规则名是类名，同一个规则集中的属性规则都相同，用序号区分
+	int32 GetRuleSetPosition(int32 RuleId) const { return RuleEntries[RuleId].RuleSetPosition; }
+	// 显示给用户的规则标识，如 #3 Art#2，和规则集合查询的写法一致
+	FString GetRuleLabel(int32 RuleId) const { return FString::Printf(TEXT("#%d %s#%d"), RuleId, *GetRuleSetName(RuleId), GetRuleSetPosition(RuleId)); }
+	const FString& GetRuleErrorReason(int32 RuleId) const;
+	// 违反这条规则的资源编号集合
+	const FResScannerBitmap& GetRuleAssets(int32 RuleId) const { return RuleEntries[RuleId].Assets; }
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FRuleEntry
+	{
+		FString RuleName;
+		FString RuleSetName;
+		// 同一个规则集中可能有多条同类型的规则，规则名不能区分，用指纹区分
+		FString RuleFingerprint;
+		int32 RuleSetPosition = 0;
+		// 规则被删除后仍然可以显示第一次取到的错误原因
+		TWeakObjectPtr<UResScannerRuleBase> Rule;
+		mutable FString ErrorReason;
+		mutable bool bErrorReasonFormatted = false;
+		FResScannerBitmap Assets;
+	};
+
+	int32 FindOrAddAsset(FName PackageName, FName AssetName, const FTopLevelAssetPath& ClassPath);
+	int32 FindOrAddRule(const FScanResultItem& Result);
+	// 在规则表末尾添加规则，RuleSetPosition 为 INDEX_NONE 时排在规则集已有规则的后面
+	FRuleEntry& AddRuleEntry(const FString& RuleName, const FString& RuleSetName, int32 RuleSetPosition = INDEX_NONE);
+	int32 AddViolation(int32 AssetId, int32 RuleId, uint64 ViolationKey);
+	// 规则数量超过位图宽度时按新宽度重新排列所有资源的位图
+	void GrowRuleMasks(int32 RuleNum);
+
+	// 规则表
+	TArray<FRuleEntry> RuleEntries;
+
+	// 资源表，下标即资源编号
+	TArray<FName> AssetPackageNames;
+	TArray<FName> AssetNames;
+	TArray<int32> AssetClassIds;
+	// 资源最后一条违规的下标，和 ViolationPrevInAsset 组成每个资源的违规链表
+	TArray<int32> AssetLastViolations;
+	// 每个资源 RuleMaskWordNum 个字，第 RuleId 位表示资源违反了这条规则
+	TArray<uint64> RuleMasks;
+	int32 RuleMaskWordNum = 1;
+	TMap<TPair<FName, FName>, int32> AssetIds;
+
+	// 资源类型，通常只有几十种
+	TArray<FTopLevelAssetPath> Classes;
+	TMap<FTopLevelAssetPath, int32> ClassIds;
+
+	// 违规表，下标即违规下标
+	TArray<int32> ViolationAssets;
+	TArray<int32> ViolationRules;
+	TArray<uint64> ViolationKeys;
+	TArray<int32> ViolationPrevInAsset;
+
+	// 违规下标 -> 细节在 DetailArena 中的起始位置，字符串以 0 结尾
+	TMap<int32, int32> ViolationDetails;
+	TArray<TCHAR> DetailArena;
+};
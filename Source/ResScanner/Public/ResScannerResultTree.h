@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/TopLevelAssetPath.h"
+
+class FResScannerResultStore;
+
+// 结果树的分组方式
+enum class EResScannerResultGrouping : uint8
+{
+	// 按规则分组，同一个资源违反多条规则时出现在多个分组中
+	Rule,
+	// 按目录分层分组
+	Folder,
+	// 按资源类型分组
+	Class
+};
+
+// 结果树的排序列
+enum class EResScannerResultSortColumn : uint8
+{
+	Name,
+	ViolationNum,
+	AssetNum
+};
+
+struct FResScannerResultTreeNode
+{
+	// 分组节点显示的文字，资源节点为空（显示时从结果存储中取资源路径）
+	FString Label;
+	// 资源节点的资源编号，分组节点为 INDEX_NONE
+	int32 AssetId = INDEX_NONE;
+	// 按规则分组时分组和资源节点所属的规则，其余为 INDEX_NONE（资源节点显示资源的所有违规）
+	int32 RuleId = INDEX_NONE;
+	// 子树中的违规数量和资源数量，添加结果时沿着分组一路累加，不需要展开就可以显示
+	int32 ViolationNum = 0;
+	int32 AssetNum = 0;
+	// 父分组，由 FResScannerResultTree 持有
+	FResScannerResultTreeNode* Parent = nullptr;
+	// 子分组（只有按目录分组时才有），分组节点总是存在
+	TArray<TSharedPtr<FResScannerResultTreeNode>> SubGroups;
+	// 直接属于这个分组的资源，展开前只保存资源编号，不生成节点
+	TArray<int32> AssetIds;
+	// 展开后生成的子节点：子分组 + 资源节点，按当前排序列排好序
+	TArray<TSharedPtr<FResScannerResultTreeNode>> Children;
+	bool bMaterialized = false;
+
+	bool IsGroup() const { return AssetId == INDEX_NONE; }
+	bool HasChildren() const { return SubGroups.Num() > 0 || AssetIds.Num() > 0; }
+};
+
+/**
+ * 扫描结果树：按规则、目录或者类型把结果存储中的资源分组，UI 中的 STreeView 直接使用这里的节点
+ * 分组节点数量很少（规则、类型几十个，目录几千个），总是存在；资源节点只在分组展开时生成，
+ * 几百万条结果时也只有展开的分组占用节点
+ * 结果存储只会追加，Update 只处理新增的资源和违规，已经展开的分组直接追加子节点，新节点排序后归并到原来的有序列表中
+ * 排序只重排节点指针，排序键（资源包名、计数）都在节点或者结果存储中，不需要生成文字
+ */
+class RESSCANNER_API FResScannerResultTree
+{
+public:
+	explicit FResScannerResultTree(const FResScannerResultStore& InResults);
+
+	// 清空所有节点，结果存储被清空后调用，下次 Update 时重新建立
+	void Reset();
+	void SetGrouping(EResScannerResultGrouping InGrouping);
+	// 只显示过滤器返回 true 的资源（搜索），分组的计数也只统计这些资源，设置后需要 Reset
+	// 过滤掉的资源在之后的 Update 中重新检查，变成匹配时加入树中；已经加入的资源在 Reset 前不会移除
+	void SetAssetFilter(TFunction<bool(int32 AssetId)> InAssetFilter) { AssetFilter = MoveTemp(InAssetFilter); }
+	EResScannerResultGrouping GetGrouping() const { return Grouping; }
+
+	// 把结果存储中新增的资源和违规加入树中，返回树是否有变化
+	bool Update();
+
+	// 生成分组的子节点（分组展开时调用），已经生成过时什么也不做
+	void Materialize(FResScannerResultTreeNode& Node);
+
+	// 重新排序顶层节点和所有已经展开的分组
+	void SetSortOrder(EResScannerResultSortColumn InSortColumn, bool bInAscending);
+	EResScannerResultSortColumn GetSortColumn() const { return SortColumn; }
+	bool IsSortAscending() const { return bAscending; }
+
+	const TArray<TSharedPtr<FResScannerResultTreeNode>>& GetRootNodes() const { return RootNodes; }
+
+private:
+	TSharedPtr<FResScannerResultTreeNode> MakeGroupNode(FString Label, FResScannerResultTreeNode* Parent, int32 RuleId = INDEX_NONE);
+	FResScannerResultTreeNode& FindOrAddRuleGroup(int32 RuleId);
+	FResScannerResultTreeNode& FindOrAddClassGroup(const FTopLevelAssetPath& ClassPath);
+	FResScannerResultTreeNode& FindOrAddFolderGroup(FName FolderPath);
+	// 通过过滤器的资源和它的违规加入树中，更新分组计数
+	void AddVisibleAsset(int32 AssetId);
+	void AddVisibleViolation(int32 ViolationIndex);
+	// 资源加入分组，分组已经展开时同时生成资源节点
+	void AddAssetToGroup(FResScannerResultTreeNode& Group, int32 AssetId);
+	TSharedPtr<FResScannerResultTreeNode> MakeAssetNode(FResScannerResultTreeNode& Group, int32 AssetId) const;
+	// 节点的计数变化后，节点需要在所在的列表中重新插入
+	void MarkCountChanged(FResScannerResultTreeNode& Node);
+	// 列表要追加节点或者有节点计数变化，Owner 为 nullptr 表示顶层，需要在修改前调用
+	void MarkListChanged(FResScannerResultTreeNode* Owner);
+	bool IsNodeLess(const FResScannerResultTreeNode& A, const FResScannerResultTreeNode& B) const;
+	void SortNodes(TArray<TSharedPtr<FResScannerResultTreeNode>>& Nodes) const;
+	// Nodes 的前 SortedNum 个节点有序（其中 ResortNodes 中的节点除外），其余是新追加的节点
+	void MergeNewNodes(TArray<TSharedPtr<FResScannerResultTreeNode>>& Nodes, int32 SortedNum) const;
+	void SortRecursive(TArray<TSharedPtr<FResScannerResultTreeNode>>& Nodes) const;
+
+	const FResScannerResultStore& Results;
+	EResScannerResultGrouping Grouping = EResScannerResultGrouping::Rule;
+	EResScannerResultSortColumn SortColumn = EResScannerResultSortColumn::ViolationNum;
+	bool bAscending = false;
+
+	TArray<TSharedPtr<FResScannerResultTreeNode>> RootNodes;
+	// 规则编号 -> 分组
+	TArray<TSharedPtr<FResScannerResultTreeNode>> RuleGroups;
+	TMap<FTopLevelAssetPath, TSharedPtr<FResScannerResultTreeNode>> ClassGroups;
+	TMap<FName, TSharedPtr<FResScannerResultTreeNode>> FolderGroups;
+	// 本次 Update 中有变化的列表（所属节点，nullptr 表示顶层） -> 变化前有序部分的长度
+	TMap<FResScannerResultTreeNode*, int32> DirtyLists;
+	// 本次 Update 中计数变化、需要重新插入的节点
+	TSet<FResScannerResultTreeNode*> ResortNodes;
+	// 资源编号 -> 所在的分组（按目录、类型分组时每个资源只在一个分组中）
+	TArray<FResScannerResultTreeNode*> AssetGroups;
+	TFunction<bool(int32 AssetId)> AssetFilter;
+	// 资源加入树时是否通过了过滤器
+	TBitArray<> VisibleAssets;
+	// 已经加入树中的资源里没有通过过滤器的数量
+	int32 HiddenAssetNum = 0;
+
+	// 已经加入树中的资源和违规数量
+	int32 IndexedAssetNum = 0;
+	int32 IndexedViolationNum = 0;
+};
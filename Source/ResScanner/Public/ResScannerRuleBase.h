@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
 #include "ResScannerRuleBase.generated.h"
 
 UENUM()
@@ -9,7 +10,17 @@ enum class EScanRuleType : uint8
 	Base,
 	NameMatch,
 	PathMatch,
-	PropertyMatch
+	PropertyMatch,
+	TagMatch
+};
+
+// 资源保存时违反规则的处理方式
+UENUM()
+enum class EResScannerSaveAction : uint8
+{
+	Ignore,		// 保存时不检查，只在扫描中报告
+	Warn,		// 保存时提示，不阻止保存
+	Block		// 阻止保存
 };
 
 /**
@@ -36,10 +47,46 @@ public:
 	FString GetErrorReason() const;
 	virtual FString GetErrorReason_Implementation() const { return TEXT("Error Reason"); }
 
+	// 是否可以脱离 GameThread 并行匹配
+	// 只有只依赖 FAssetData（注册表数据），并且没有被蓝图覆盖 Match 的规则才是线程安全的
+	// 默认返回 false：需要加载资源的规则（如属性规则）只能在 GameThread 中执行
+	virtual bool CanMatchOffGameThread() const { return false; }
+
+	// 评估时是否需要加载资源，需要加载的规则开销远大于只读取注册表数据的规则，调度时会尽量放到后面
+	virtual bool RequiresAssetLoad() const { return false; }
+
+	// 规则指纹：规则类型 + 所有可编辑属性的哈希，规则内容不变指纹就不变，用于跨扫描记录统计数据
+	FString GetRuleFingerprint() const;
+
 	// 是否启用反向检测（如：找出不符合命名规范的资源）
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResScannerRule")
 	bool bReverseCheck = false;
 
+	// 规则作用的目录（包含子目录），如 /Game/Textures，为空表示作用于所有目录
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResScannerRule", meta = (ContentDir, LongPackageName))
+	TArray<FDirectoryPath> ScopePaths;
+
+	// 规则作用的资源类型（包含子类），为空表示作用于所有类型
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResScannerRule")
+	TArray<TSoftClassPtr<UObject>> ScopeClasses;
+
+	// 资源保存时违反该规则的处理方式，不影响扫描结果
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResScannerRule")
+	EResScannerSaveAction SaveAction = EResScannerSaveAction::Warn;
+
+	// 获取规则作用的资源类型，用于建立规则索引
+	// 默认就是 ScopeClasses，子类可以根据规则数据补充隐含的类型（如属性规则的 TargetClass）
+	virtual void GetScopeClasses(TArray<FTopLevelAssetPath>& OutClassPaths) const
+	{
+		for (const TSoftClassPtr<UObject>& ScopeClass : ScopeClasses)
+		{
+			if (!ScopeClass.IsNull())
+			{
+				OutClassPaths.Add(ScopeClass.ToSoftObjectPath().GetAssetPath());
+			}
+		}
+	}
+
 	
 	
 	virtual EScanRuleType GetRuleType() const
@@ -54,7 +101,8 @@ public:
 			{ EScanRuleType::Base, TEXT("Base") }, 
 			{ EScanRuleType::NameMatch, TEXT("NameMatch") },
 			{ EScanRuleType::PathMatch, TEXT("PathMatch") },
-			{ EScanRuleType::PropertyMatch, TEXT("PropertyMatch") }
+			{ EScanRuleType::PropertyMatch, TEXT("PropertyMatch") },
+			{ EScanRuleType::TagMatch, TEXT("TagMatch") }
 		};
 		return TypeMap.FindChecked(Type);
 	}
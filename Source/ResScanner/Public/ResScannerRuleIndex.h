@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+class UResScannerRuleBase;
+
+/**
+ * 规则分发索引
+ * 扫描前把规则集编译成 目录前缀树 + 类型继承表，
+ * 对每个资源只返回可能作用于它的规则，单个资源的评估开销只和相关规则的数量有关，和规则总数无关
+ *		目录前缀树：按目录层级（/Game/Textures/UI -> Game, Textures, UI）存放规则，沿资源所在目录走一遍即可拿到目录相关的规则
+ *		类型继承表：按资源类型缓存一个位图，标记哪些规则的作用类型是该类型本身或它的父类
+ */
+class RESSCANNER_API FResScannerRuleIndex
+{
+public:
+	// 根据规则数组建立索引，规则下标和数组下标一一对应
+	void Build(const TArray<UResScannerRuleBase*>& InRules);
+
+	// 获取可以作用于该资源的规则下标，按下标从小到大排列
+	// 内部有缓存，只能在 GameThread 中调用
+	void GatherApplicableRules(const FAssetData& AssetData, TArray<int32>& OutRuleIndices);
+
+	int32 GetRuleNum() const { return RuleNum; }
+
+	// 预先建立这些资源类型的规则位图，之后只查询这些类型的资源时不会再访问资源注册表，
+	// 索引的副本可以在其他线程中使用（实时预览）
+	void PrecacheClasses(TConstArrayView<FTopLevelAssetPath> ClassPaths);
+
+private:
+	// 获取目录相关的规则（资源所在目录及其所有上级目录上挂的规则）
+	const TArray<int32>& GetPathRules(FName PackagePath);
+	// 获取某个资源类型可以使用的规则位图
+	const TBitArray<>& GetClassRuleMask(const FTopLevelAssetPath& ClassPath);
+
+	// 把目录拆分成一级一级的名字
+	static void SplitPath(const FString& InPath, TArray<FName>& OutSegments);
+
+private:
+	struct FPathNode
+	{
+		// 子目录名 -> 子节点下标
+		TMap<FName, int32> Children;
+		// 作用于该目录（及其子目录）的规则
+		TArray<int32> RuleIndices;
+	};
+
+	int32 RuleNum = 0;
+
+	// 目录前缀树，0 号节点是根节点，没有指定目录的规则挂在根节点上
+	TArray<FPathNode> PathNodes;
+
+	// 每条规则的作用类型，为空表示所有类型
+	TArray<TArray<FTopLevelAssetPath>> RuleScopeClasses;
+
+	// 资源类型 -> 可以使用的规则位图
+	TMap<FTopLevelAssetPath, TBitArray<>> ClassRuleMaskCache;
+
+	// 扫描是按目录进行的，同一目录的资源连续出现，缓存上一次的目录结果即可
+	FName CachedPackagePath;
+	TArray<int32> CachedPathRules;
+};
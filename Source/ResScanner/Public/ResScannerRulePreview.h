@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Containers/Ticker.h"
+#include "Tasks/Task.h"
+#include "UObject/StrongObjectPtr.h"
+#include "ResScannerRuleIndex.h"
+#include <atomic>
+
+class UResScannerRuleBase;
+
+// 一次规则预览的结果
+struct FResScannerRulePreviewResult
+{
+	// 快照中的资源数量，以及其中在规则作用范围（目录、类型）内的资源数量
+	int32 SnapshotAssetNum = 0;
+	int32 InScopeAssetNum = 0;
+	// 违反规则的资源数量，以及按快照顺序的前几个违规资源
+	int32 ViolationNum = 0;
+	TArray<FSoftObjectPath> SampleAssets;
+	// 评估耗时（不含防抖等待）
+	double Seconds = 0.0;
+};
+
+/**
+ * 编辑规则时的实时预览：在资源注册表的内存快照上评估正在编辑的规则，显示违规资源数量和前几个违规资源，
+ * 调整规则时不需要再完整扫描一遍
+ *		快照：第一次预览时拷贝扫描根目录下所有资源的 FAssetData，之后的预览都使用这份快照，不再访问资源注册表
+ *		防抖：规则每次修改只记录请求，停止修改 DebounceSeconds 后才开始评估
+ *		后台评估：评估的是规则的副本，编辑中的规则随时可以修改；评估在任务线程中按块并行，新的修改会取消正在进行的评估
+ * 只预览可以脱离 GameThread 评估的规则（名字、标签等只依赖注册表数据的规则），属性规则需要加载资源，不做预览
+ */
+class RESSCANNER_API FResScannerRulePreview
+{
+public:
+	explicit FResScannerRulePreview(FName InRootPath);
+	~FResScannerRulePreview();
+
+	// 规则被修改后调用
+	void RequestUpdate(UResScannerRuleBase* InRule);
+
+	// 是否还有没完成的预览（等待防抖或者正在评估）
+	bool IsUpdating() const { return bRequestPending || RunningTask.IsValid(); }
+	bool HasResult() const { return bHasResult; }
+	const FResScannerRulePreviewResult& GetResult() const { return Result; }
+	// 预览状态的文字，用于 UI 显示
+	FText GetStatusText() const;
+
+	// 每次得到新的预览结果（或者规则不支持预览）时广播
+	FSimpleMulticastDelegate OnResultUpdated;
+
+private:
+	bool Tick(float DeltaTime);
+	void BuildSnapshot();
+	void Launch();
+	// 在任务线程中执行
+	void Evaluate();
+
+	// 停止修改多久之后开始评估
+	static constexpr double DebounceSeconds = 0.15;
+	// 每块评估的资源数量，取消评估时最多再评估完当前块
+	static constexpr int32 ChunkSize = 8192;
+	static constexpr int32 MaxSampleNum = 20;
+
+	FName RootPath;
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	// 等待防抖的请求
+	TWeakObjectPtr<UResScannerRuleBase> PendingRule;
+	double LastRequestTime = 0.0;
+	bool bRequestPending = false;
+
+	// 资源注册表快照，以及快照中出现的资源类型（用于预先建立规则索引的类型缓存）
+	TArray<FAssetData> SnapshotAssets;
+	TArray<FTopLevelAssetPath> SnapshotClasses;
+	bool bSnapshotBuilt = false;
+
+	// 正在评估的规则副本和它的分发索引，评估结束前任务线程会读取，GameThread 不能修改
+	TStrongObjectPtr<UResScannerRuleBase> RunningRule;
+	FResScannerRuleIndex RunningRuleIndex;
+	UE::Tasks::FTask RunningTask;
+	FResScannerRulePreviewResult RunningResult;
+	std::atomic<bool> bCancelRunning{ false };
+
+	FResScannerRulePreviewResult Result;
+	bool bHasResult = false;
+	// 最近请求的规则需要在 GameThread 中评估，不支持预览
+	bool bUnsupported = false;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ResScannerBitmap.h"
+
+class FResScannerResultStore;
+
+/**
+ * 跨规则的集合查询，直接在结果存储中每条规则的违规资源位图上求值，不需要重新扫描
+ * 语法（运算符优先级 ! 最高，然后是 & -，最后是 |）：
+ *		#Id				违反这条规则的资源，Id 是规则编号（结果树规则分组中显示的 #编号）
+ *		RuleSet#N		违反规则集 RuleSet 中第 N 条规则的资源（N 从 1 开始），规则集名不区分大小写
+ *		RuleSet			违反规则集 RuleSet 中任意一条规则的资源
+ *		"Text"			违反错误原因中包含 Text 的任意一条规则的资源，不区分大小写
+ *		A & B			同时违反 A 和 B
+ *		A | B			违反 A 或者 B
+ *		A - B			违反 A 但没有违反 B
+ *		!A				有违规但没有违反 A 的资源
+ *		rules>=N		违反至少 N 条规则的资源，比较运算符还可以是 > <= < = !=
+ *		( )				分组
+ * 规则名是规则类名，同一个规则集中的属性规则类名都相同，不能用来区分规则
+ * 例如 Art#1 - Art#2、"贴图尺寸" & !TechArt、rules>=3 & !#0
+ */
+class RESSCANNER_API FResScannerRuleQuery
+{
+public:
+	// 解析并求值，语法错误或者规则名不存在时返回 false，OutError 为错误信息
+	static bool Evaluate(const FResScannerResultStore& Results, const FString& Expression, FResScannerBitmap& OutAssets, FString& OutError);
+
+private:
+	FResScannerRuleQuery(const FResScannerResultStore& InResults, const FString& InExpression);
+
+	// Or := And ('|' And)*
+	bool ParseOr(FResScannerBitmap& OutAssets);
+	// And := Unary (('&' | '-') Unary)*
+	bool ParseAnd(FResScannerBitmap& OutAssets);
+	// Unary := '!' Unary | '(' Or ')' | 'rules' Compare Number | '#' Number | RuleSet ('#' Number)? | '"' Text '"'
+	bool ParseUnary(FResScannerBitmap& OutAssets);
+	// 开头的引号已经消耗
+	bool ParseErrorReason(FResScannerBitmap& OutAssets);
+	bool ParseRuleNum(FResScannerBitmap& OutAssets);
+
+	void SkipWhitespace();
+	// 跳过空白后当前字符是 Char 时消耗它
+	bool Consume(TCHAR Char);
+	FString ReadIdentifier();
+	bool ReadNumber(int32& OutNumber);
+	bool SetError(const FString& InError);
+
+	const FResScannerResultStore& Results;
+	const FString& Expression;
+	int32 Position = 0;
+	FString Error;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ResScannerRuleSet.h"
+
+class UResScannerRuleBase;
+
+// 单条规则的历史统计数据，按规则指纹保存，跨扫描累计
+struct FResScannerRuleStats
+{
+	// 累计评估耗时（秒）
+	double TotalSeconds = 0.0;
+	// 累计评估次数
+	int64 EvaluatedNum = 0;
+	// 累计违规次数
+	int64 ViolationNum = 0;
+};
+
+/**
+ * 基于开销的规则调度器
+ * 记录每条规则实测的单次评估耗时和违规率（选择性），按规则所属规则集的组合逻辑生成执行计划：
+ *		AnyViolation：违规即可确定结果，按 耗时 / 违规率 从小到大执行
+ *		AllViolation：通过即可确定结果，按 耗时 / 通过率 从小到大执行
+ *		Independent：不能短路，只按耗时从小到大执行
+ * 统计数据保存在 Saved/ResScanner/RuleStats.json 中
+ */
+class RESSCANNER_API FResScannerRuleScheduler
+{
+public:
+	// 根据历史统计数据和组合逻辑生成执行计划，多个规则集的规则统一排序
+	// RuleFingerprints：和规则数组一一对应的规则指纹（FResScannerEngine::Prepare 中已经计算过），为空时重新计算
+	void BuildPlan(const FResScannerCompiledRules& InCompiledRules, TArrayView<const FString> RuleFingerprints = TArrayView<const FString>());
+	// 规则不变，只按最新的统计数据重新排序（扫描过程中定期调用）
+	void Replan();
+
+	// 规则在执行计划中的位置，越小越先执行
+	int32 GetPlanRank(int32 RuleIndex) const { return PlanRanks.IsValidIndex(RuleIndex) ? PlanRanks[RuleIndex] : MAX_int32; }
+
+	// 把本次扫描中一条规则的统计数据累加到历史数据中
+	void AccumulateStats(int32 RuleIndex, double Seconds, int64 EvaluatedNum, int64 ViolationNum);
+
+	// 预估单次评估耗时（秒），没有历史数据时根据是否需要加载资源给一个默认值
+	double GetEstimatedCost(int32 RuleIndex) const;
+	// 预估违规率，做了平滑处理，没有历史数据时为 0.5
+	double GetEstimatedSelectivity(int32 RuleIndex) const;
+
+	// 查询某条规则的历史统计数据
+	const FResScannerRuleStats* FindStats(const FString& RuleFingerprint) const { return StatsByFingerprint.Find(RuleFingerprint); }
+
+	// 执行计划的文字描述，用于 UI 显示，生成执行计划时更新
+	const FString& DescribePlan() const { return PlanDescription; }
+
+	void LoadStats();
+	void SaveStats() const;
+
+private:
+	static FString GetStatsFilePath();
+	void UpdatePlanDescription();
+
+private:
+	// 规则指纹 -> 历史统计数据
+	TMap<FString, FResScannerRuleStats> StatsByFingerprint;
+
+	// 当前执行计划对应的规则信息，下标和规则数组一致
+	TArray<FString> PlanFingerprints;
+	TArray<FString> PlanRuleNames;
+	TArray<bool> PlanRequiresLoad;
+	TArray<ERuleSetLogic> PlanLogics;
+
+	// 执行顺序（规则下标）以及每条规则在顺序中的位置
+	TArray<int32> PlanOrder;
+	TArray<int32> PlanRanks;
+	FString PlanDescription = TEXT("执行计划：尚未生成（开始扫描时生成）");
+};
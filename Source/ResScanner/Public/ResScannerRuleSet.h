@@ -4,6 +4,15 @@
 #include "ResScannerRuleBase.h"
 #include "ResScannerRuleSet.generated.h"
 
+// 规则集的组合逻辑
+UENUM()
+enum class ERuleSetLogic : uint8
+{
+	Independent,		// 每条规则单独报告（不能短路）
+	AnyViolation,		// 任意一条规则违规就报告该资源，确定违规后跳过剩余规则
+	AllViolation		// 所有相关规则都违规才报告该资源，有一条规则通过就跳过剩余规则
+};
+
 /**
  * 规则容器类，后续用于组合规则
  * 比如多个 NameRule 和 PathRule 和 PropertyRule 可以组合在一个规则容器中
@@ -16,4 +25,60 @@ public:
 	// 存放规则的数组
 	UPROPERTY(EditAnywhere, Instanced, Category = "ResScannerRule")
 	TArray<UResScannerRuleBase*> Rules;
+
+	// 组合逻辑，AnyViolation 和 AllViolation 下结果确定后会跳过剩余的规则（尤其是需要加载资源的规则）
+	UPROPERTY(EditAnywhere, Category = "ResScannerRule")
+	ERuleSetLogic CompositeLogic = ERuleSetLogic::Independent;
+
+	// 规则集名称，同时加载多个规则集时用来区分扫描结果属于哪个规则集（如 Art、TechArt、Build）
+	UPROPERTY(EditAnywhere, Category = "ResScannerRule")
+	FString RuleSetName = TEXT("Default");
+};
+
+// 编译时被跳过的规则
+struct RESSCANNER_API FResScannerSkippedRule
+{
+	UResScannerRuleBase* Rule = nullptr;
+	FString RuleSetName;
+	// 规则在规则集中的序号（从 1 开始），和规则集合查询中 RuleSet#N 的写法一致
+	int32 RuleSetPosition = 0;
+	// 规则本身不需要跳过，所在的 AllViolation 规则集中有别的规则被跳过，整个规则集都被跳过
+	bool bSkippedWithRuleSet = false;
+
+	// 跳过的原因（英文，写入日志和报告）
+	const TCHAR* GetReason() const;
+};
+
+/**
+ * 编译后的扫描规则
+ * 把多个规则集合并成一个扁平的规则数组，规则索引、调度器都基于这个数组工作，
+ * 这样一次遍历资源（一次枚举、每个资源最多加载一次）就能评估所有规则集
+ */
+struct RESSCANNER_API FResScannerCompiledRules
+{
+	// 所有规则集的规则（已去掉空规则）
+	TArray<UResScannerRuleBase*> Rules;
+	// 每条规则所属的规则集在 RuleSets 中的下标
+	TArray<int32> RuleSetIndices;
+	// 每条规则在所属规则集中的序号（从 1 开始，空规则不算），被跳过的规则也占序号，同一条规则离线、在线扫描时序号相同
+	TArray<int32> RuleSetPositions;
+	// 参与扫描的规则集
+	TArray<UResScannerRuleSet*> RuleSets;
+	// 被跳过的规则（bRegistryOnly 时为需要加载资源或者需要在 GameThread 中评估的规则）
+	TArray<FResScannerSkippedRule> SkippedRules;
+
+	// bRegistryOnly：只保留 CanEvaluateRegistryOnly 的规则（离线扫描资源注册表时使用）
+	void Compile(const TArray<UResScannerRuleSet*>& InRuleSets, bool bRegistryOnly = false);
+	// 规则不需要加载资源，并且可以脱离 GameThread 评估
+	static bool CanEvaluateRegistryOnly(const UResScannerRuleBase* Rule);
+	// ShouldSkipRule 返回 true 的规则被跳过（放入 SkippedRules），AllViolation 的规则集只要有一条规则被跳过就整个跳过
+	void Compile(const TArray<UResScannerRuleSet*>& InRuleSets, TFunctionRef<bool(const UResScannerRuleBase*)> ShouldSkipRule);
+
+	int32 GetRuleSetIndex(int32 RuleIndex) const { return RuleSetIndices[RuleIndex]; }
+	ERuleSetLogic GetRuleLogic(int32 RuleIndex) const { return RuleSets[RuleSetIndices[RuleIndex]]->CompositeLogic; }
+	const FString& GetRuleSetName(int32 RuleIndex) const { return RuleSets[RuleSetIndices[RuleIndex]]->RuleSetName; }
+	int32 GetRuleSetPosition(int32 RuleIndex) const { return RuleSetPositions[RuleIndex]; }
+
+	// 所有规则集的指纹（规则内容、所属规则集、组合逻辑），用于判断检查点是否还能继续使用
+	FString GetFingerprint() const;
 };
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ResScannerRuleSet.h"
+
+/**
+ * 分层抽样估计器
+ * 每个 (目录, 资源类型) 是一层，每层随机抽取最多 SampleSize 个资源评估，
+ * 用分层抽样的估计量推算整个项目中每条规则的违规数量：
+ *		估计值 = Σ N_h * p_h
+ *		方差   = Σ N_h² * (1 - n_h / N_h) * s_h² / n_h，s_h² = p_h * (1 - p_h) * n_h / (n_h - 1)
+ * N_h 是层中资源数，n_h 是样本数，p_h 是样本违规比例，(1 - n_h / N_h) 是有限总体校正
+ */
+class RESSCANNER_API FResScannerSampleEstimator
+{
+public:
+	void Reset(int32 InRuleNum, int32 InSampleSize, int32 InRandomSeed);
+
+	// 从一层资源中随机抽取样本下标（部分 Fisher-Yates 洗牌），层中资源不多于样本数时全部返回
+	void DrawSample(int32 StratumNum, TArray<int32>& OutSampleIndices);
+
+	// 累加一层的评估结果，RuleViolationNum 是样本中每条规则报告的违规数
+	void AddStratum(int32 StratumNum, int32 SampleNum, TConstArrayView<int32> RuleViolationNum);
+
+	// 规则违规总数的估计值和 95% 置信区间（裁剪到 [样本中的违规数, 总资源数]）
+	double GetEstimatedViolations(int32 RuleIndex) const { return EstimatedViolations[RuleIndex]; }
+	void GetConfidenceInterval(int32 RuleIndex, double& OutLow, double& OutHigh) const;
+
+	int64 GetPopulationNum() const { return PopulationNum; }
+	int64 GetSampleNum() const { return SampleNum; }
+	bool HasEstimates() const { return EstimatedViolations.Num() > 0; }
+
+	// 估计结果的文字描述，用于 UI 显示和日志
+	FString Describe(const FResScannerCompiledRules& InCompiledRules) const;
+
+private:
+	int32 SampleSize = 0;
+	FRandomStream RandomStream;
+
+	int64 PopulationNum = 0;
+	int64 SampleNum = 0;
+	// 下标和规则数组一致
+	TArray<double> EstimatedViolations;
+	TArray<double> EstimatedVariances;
+	TArray<int64> SampledViolations;
+};
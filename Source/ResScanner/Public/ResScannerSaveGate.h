@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ResScannerEngine.h"
+#include "Containers/Ticker.h"
+
+class UPackage;
+class FObjectPreSaveContext;
+
+/**
+ * 保存时检查：资源保存时只评估刚保存的资源包，按规则的 SaveAction 提示或者阻止保存
+ *		规则集预先编译好（分发索引 + 执行计划），规则集被替换或者规则属性被修改时才重新编译，每个资源只测试作用于它的类型、目录的规则
+ *		直接使用内存中的对象，不加载任何资源
+ *		历史平均耗时超过 SaveGateBudgetMs 的规则不在保存时检查，保存仍然是即时的
+ *		一次保存操作（如全部保存）中所有资源包的违规合并成一条通知，在下一次 Tick 时显示
+ * 阻止保存通过 FCoreUObjectDelegates::IsPackageOKToSaveDelegate 实现，
+ * 这个代理只能绑定一个函数，已经被其它插件绑定时退化为只提示
+ */
+class RESSCANNER_API FResScannerSaveGate
+{
+public:
+	// GatherRuleSets 返回当前需要检查的规则集（编辑器面板中的规则集和追加的规则集）
+	explicit FResScannerSaveGate(TFunction<void(TArray<UResScannerRuleSet*>&)> InGatherRuleSets);
+	~FResScannerSaveGate();
+
+private:
+	bool IsPackageOKToSave(UPackage* Package, const FString& Filename, FOutputDevice* ErrorDevice);
+	void OnPreSavePackage(UPackage* Package, FObjectPreSaveContext ObjectSaveContext);
+
+	// 评估一个资源包，返回是否允许保存，bCanBlock 为 false 时 Block 的规则也只提示
+	bool ValidatePackage(UPackage* Package, bool bCanBlock, FOutputDevice* ErrorDevice);
+	// 规则集被替换或者被修改过时重新编译
+	void PrepareIfRuleSetsChanged();
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+	// 把本次保存操作中所有资源包的违规显示成一条通知
+	bool FlushNotification(float DeltaTime);
+
+private:
+	TFunction<void(TArray<UResScannerRuleSet*>&)> GatherRuleSets;
+	FResScannerEngine Engine;
+	// 上一次编译时的规则集（弱指针，规则集重新加载后即使地址相同也不相等），以及之后规则是否被修改过
+	TArray<TWeakObjectPtr<UResScannerRuleSet>> PreparedRuleSets;
+	bool bRulesChanged = true;
+	FDelegateHandle ObjectPropertyChangedHandle;
+
+	// 等待显示的通知：违规的资源包数量、被阻止保存的资源包数量、每条违规一行
+	int32 PendingPackageNum = 0;
+	int32 PendingBlockedNum = 0;
+	FString PendingMessage;
+	FTSTicker::FDelegateHandle NotificationTickerHandle;
+
+	// 是否绑定了 IsPackageOKToSaveDelegate
+	bool bOwnsSaveDelegate = false;
+	FDelegateHandle PreSavePackageHandle;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "Misc/Paths.h"
+#include "ResScannerSettings.generated.h"
+
+/**
+ * 扫描设置，显示在 项目设置 -> 插件 -> ResScanner 中
+ * 保存在插件的 Config/DefaultResScanner.ini 中，编辑器面板、命令行等所有扫描入口共用
+ */
+UCLASS(config = ResScanner, defaultconfig, meta = (DisplayName = "ResScanner"))
+class RESSCANNER_API UResScannerSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+
+	// 资源注册表还在后台发现资源时（如编辑器刚启动），先扫描已经发现的资源，
+	// 之后每发现一个新资源就接着评估，直到 OnFilesLoaded 后把结果标记为最终结果
+	// 关闭时只扫描已经发现的资源，结果可能不完整
+	UPROPERTY(config, EditAnywhere, Category = "Scan")
+	bool bProgressiveScan = true;
+
+	// 优先扫描正在处理的资源：未保存的、在编辑器中打开的、当前关卡引用的、最近保存或修改的
+	// 这些资源先同步评估并显示结果，其余资源在后面分帧扫描
+	UPROPERTY(config, EditAnywhere, Category = "Scan")
+	bool bPrioritizeRecentAssets = true;
+
+	// 最近多少小时内修改过的资源文件算作"最近修改"，0 表示只看本次编辑器会话中保存过的资源
+	UPROPERTY(config, EditAnywhere, Category = "Scan", meta = (EditCondition = "bPrioritizeRecentAssets", ClampMin = "0"))
+	float RecentlyModifiedHours = 24.0f;
+
+	// 扫描过程中每隔多少秒保存一次检查点到 Saved/ResScanner/，编辑器崩溃或者取消扫描后，
+	// 下次用同样的规则扫描时可以从中断处继续。0 表示不保存检查点
+	UPROPERTY(config, EditAnywhere, Category = "Scan", meta = (ClampMin = "0", Units = "s"))
+	float CheckpointIntervalSeconds = 60.0f;
+
+	// 扫描预算：超过时间（秒）或者评估的资源数量后停止扫描，保留已经得到的结果，0 表示不限制
+	UPROPERTY(config, EditAnywhere, Category = "Budget", meta = (ClampMin = "0", Units = "s"))
+	float MaxScanSeconds = 0.0f;
+
+	UPROPERTY(config, EditAnywhere, Category = "Budget", meta = (ClampMin = "0"))
+	int32 MaxScanAssetNum = 0;
+
+	// 抽样扫描时每个 (目录, 资源类型) 最多抽取的资源数量
+	UPROPERTY(config, EditAnywhere, Category = "Sampling", meta = (ClampMin = "1", ClampMax = "512"))
+	int32 SamplesPerStratum = 20;
+
+	// 抽样的随机种子，0 表示每次扫描使用不同的种子，固定种子可以复现同样的样本
+	UPROPERTY(config, EditAnywhere, Category = "Sampling")
+	int32 SampleRandomSeed = 0;
+
+	// 保存资源时用当前规则集检查刚保存的资源包，按规则的 SaveAction 提示或者阻止保存
+	// 默认关闭：开启后会占用 IsPackageOKToSaveDelegate，重启编辑器后生效
+	UPROPERTY(config, EditAnywhere, Category = "SaveGate", meta = (ConfigRestartRequired = true))
+	bool bValidateOnSave = false;
+
+	// 保存检查每个资源包的耗时预算（毫秒），历史平均耗时超过预算的规则不在保存时检查，留给完整扫描
+	UPROPERTY(config, EditAnywhere, Category = "SaveGate", meta = (EditCondition = "bValidateOnSave", ClampMin = "0.1", Units = "ms"))
+	float SaveGateBudgetMs = 5.0f;
+
+	// 违规基线文件，相对于项目目录（如 ResScanner/Baseline.bin），需要提交到版本库
+	// 扫描时基线中已有的违规不显示，只显示新的违规；为空表示不使用基线
+	UPROPERTY(config, EditAnywhere, Category = "Baseline")
+	FString BaselineFile;
+
+	// 完整扫描的所有违规记录到 Saved/ResScanner/ScanHistory.db（SQLite），用于查看每条规则、每个目录的违规趋势
+	UPROPERTY(config, EditAnywhere, Category = "History")
+	bool bRecordHistory = true;
+
+	FString GetBaselineFilePath() const { return BaselineFile.IsEmpty() ? FString() : FPaths::ConvertRelativePathToFull(FPaths::ProjectDir() / BaselineFile); }
+};
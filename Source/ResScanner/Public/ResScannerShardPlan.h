@@ -0,0 +1,18 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 多进程分片扫描的分片计划
+ * 需要加载资源的规则受限于单个进程的 GameThread，把资源包分给多个工作进程并行扫描
+ * 分片时尽量把共享依赖的资源包放在同一片中，同一个依赖（贴图、材质等）只需要在一个进程中加载：
+ *		1. 用并查集按硬依赖合并资源包，引用同一个依赖的资源包也合并到一组
+ *		   每组大小有上限，避免一个公共资源把所有资源包连成一组，导致分片不均匀
+ *		2. 按组的大小从大到小，每次放进当前最小的分片（LPT 贪心）
+ */
+struct RESSCANNER_API FResScannerShardPlan
+{
+	TArray<TArray<FName>> Shards;
+
+	void Build(const TArray<FName>& InPackageNames, int32 ShardNum);
+};
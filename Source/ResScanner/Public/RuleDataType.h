@@ -121,4 +121,43 @@ struct FPropertyMatchRule
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     bool bReverseCheck;
 };
-// -------------------------------------------- Property Rule --------------------------------------------- //
\ No newline at end of file
+// -------------------------------------------- Property Rule --------------------------------------------- //
+
+// ---------------------------------------------- Tag Rule --------------------------------------------- //
+// 标签匹配模式，Greater、Less 按数值比较
+UENUM()
+enum class ETagMatchMode : uint8
+{
+    Equal,
+    NotEqual,
+    Contain,
+    Greater,
+    Less
+};
+
+// 标签规则，比较资源注册表中的标签值（如 IoStore 扫描生成的 IoStoreSize、IoStoreContainer）
+USTRUCT(BlueprintType)
+struct FTagRule
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResScanner")
+    FName TagName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResScanner")
+    ETagMatchMode MatchMode = ETagMatchMode::Equal;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResScanner")
+    FString Value;
+};
+
+// 标签规则列表，所有标签规则都满足才算匹配，资源没有该标签时不满足
+USTRUCT(BlueprintType)
+struct FTagMatchRule
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FTagRule> TagRules;
+};
+// ---------------------------------------------- Tag Rule --------------------------------------------- //
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ResScannerRuleBase.h"
+#include "RuleDataType.h"
+#include "TagMatchRuleExecutor.generated.h"
+
+/**
+ * 标签匹配规则执行器
+ * 只读取 FAssetData 中的标签，不需要加载资源，离线扫描（资源注册表、IoStore）也可以使用
+ */
+UCLASS(Blueprintable)
+class RESSCANNER_API UTagMatchRuleExecutor : public UResScannerRuleBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool Match_Implementation(const FAssetData& AssetData) const override;
+
+	virtual FString GetErrorReason_Implementation() const override;
+
+	virtual EScanRuleType GetRuleType() const override { return EScanRuleType::TagMatch; }
+
+	// 标签规则只读取注册表数据，可以在工作线程中并行评估
+	virtual bool CanMatchOffGameThread() const override;
+
+public:
+	// 规则数据
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ResScanner")
+	FTagMatchRule RuleData;
+
+private:
+	static bool EvaluateSingleRule(const FAssetData& AssetData, const FTagRule& TagRule);
+};
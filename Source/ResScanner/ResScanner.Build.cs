@@ -44,6 +44,7 @@ public class ResScanner : ModuleRules
 				"UnrealEd",
 				"ToolMenus",
 				"AssetRegistry",
+				"ContentBrowser",
 				"PropertyEditor",
 				"AssetTools",
 				"EditorStyle",
@@ -51,8 +52,10 @@ public class ResScanner : ModuleRules
 				"Json",
 				"JsonUtilities",
 				"DesktopPlatform",
+				"DeveloperSettings",
 				"EditorInteractiveToolsFramework",
-				"InteractiveToolsFramework"
+				"InteractiveToolsFramework",
+				"SQLiteCore"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);